@@ -1,11 +1,26 @@
 #!/bin/bash
 
 # Skrypt do kompilacji serwera i klienta RPC
+# (src/gaus_rpc_svc.c generowany przez `rpcgen -m` - funkcja main jest w src/gaus_server.cpp)
+# LAPACK=1 ./compile.sh dołącza do serwera opcjonalny backend LAPACK (include/lapack_backend.hpp, -llapack)
+LAPACK_FLAGS=""
+if [ "${LAPACK:-0}" = "1" ]; then
+    LAPACK_FLAGS="-DGAUS_WITH_LAPACK -llapack"
+fi
+
 echo "Kompilowanie serwera..."
-g++ -I/usr/include/tirpc -o gaus_server src/gaus_server.cpp src/gaus_rpc_svc.c src/gaus_rpc_xdr.c -ltirpc
+g++ -std=c++20 -I/usr/include/tirpc -o gaus_server src/gaus_server.cpp src/gaus_rpc_svc.c src/gaus_rpc_xdr.c -ltirpc $LAPACK_FLAGS
 
 echo "Kompilowanie klienta..."
 
-g++ -I/usr/include/tirpc -o gaus_client src/gaus_client.cpp src/gaus_rpc_clnt.c src/gaus_rpc_xdr.c -ltirpc
+g++ -std=c++20 -I/usr/include/tirpc -o gaus_client src/gaus_client.cpp src/gaus_rpc_clnt.c src/gaus_rpc_xdr.c -ltirpc
+
+echo "Kompilowanie testu długotrwałego..."
+
+g++ -std=c++20 -I/usr/include/tirpc -o gaus_soak src/gaus_soak.cpp src/gaus_rpc_clnt.c src/gaus_rpc_xdr.c -ltirpc
+
+echo "Kompilowanie testów..."
+
+g++ -std=c++20 -o block_tridiag_test tests/block_tridiag_test.cpp
 
-echo "Kompilacja zakończona!"
\ No newline at end of file
+echo "Kompilacja zakończona! (testy: ./block_tridiag_test)"
\ No newline at end of file
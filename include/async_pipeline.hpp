@@ -0,0 +1,283 @@
+#pragma once
+
+#include <rpc/rpc.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace async {
+
+// Korutyna uruchamiana od razu i niszcząca się po zakończeniu (obsługa jednego żądania)
+struct Task {
+    struct promise_type {
+        Task get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+// Pula wątków obliczeniowych; `co_await pool.schedule()` przenosi korutynę do wolnego slotu
+class ComputePool {
+public:
+    explicit ComputePool(std::size_t slots) {
+        if (slots == 0) {
+            throw std::invalid_argument("Compute pool needs at least one slot");
+        }
+        threads_.reserve(slots);
+        for (std::size_t i = 0; i < slots; ++i) {
+            threads_.emplace_back([this]() { run(); });
+        }
+    }
+
+    ~ComputePool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto &thread : threads_) {
+            thread.join();
+        }
+    }
+
+    ComputePool(const ComputePool &) = delete;
+    ComputePool &operator=(const ComputePool &) = delete;
+
+    auto schedule() {
+        struct Awaiter {
+            ComputePool &pool;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { pool.post(handle); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{*this};
+    }
+
+    std::size_t slots() const { return threads_.size(); }
+    std::size_t busy() const { return busy_.load(std::memory_order_relaxed); }
+
+    std::size_t queued() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return queue_.size();
+    }
+
+    // Wznawia korutynę w wolnym slocie (używane przez harmonogramy nadrzędne)
+    void post(std::coroutine_handle<> handle) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(handle);
+        }
+        cv_.notify_one();
+    }
+
+private:
+    void run() {
+        for (;;) {
+            std::coroutine_handle<> handle;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+                if (queue_.empty()) {
+                    return;
+                }
+                handle = queue_.front();
+                queue_.pop_front();
+            }
+            busy_.fetch_add(1, std::memory_order_relaxed);
+            handle.resume();
+            busy_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::coroutine_handle<>> queue_;
+    std::vector<std::thread> threads_;
+    std::atomic<std::size_t> busy_{0};
+    bool stop_{false};
+};
+
+// Pętla zdarzeń RPC: jedyny wątek wykonujący operacje svc_* (odbiór, dekodowanie, wysyłanie odpowiedzi).
+// Korutyny wracają do niej przez `co_await loop.resume_here()`. Deskryptory spoza TIRPC (np. protokół
+// natywny) są dodawane przez watch() i obsługiwane w tym samym wątku.
+class EventLoop {
+public:
+    EventLoop() : wake_fd_(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {
+        if (wake_fd_ == -1) {
+            throw std::runtime_error(std::string("eventfd failed: ") + std::strerror(errno));
+        }
+    }
+
+    ~EventLoop() { close(wake_fd_); }
+
+    EventLoop(const EventLoop &) = delete;
+    EventLoop &operator=(const EventLoop &) = delete;
+
+    auto resume_here() {
+        struct Awaiter {
+            EventLoop &loop;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { loop.post(handle); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{*this};
+    }
+
+    // Jak resume_here(), ale nie wcześniej niż `when`: czekanie nie zajmuje wątku pętli ani slotu puli
+    auto resume_at(std::chrono::steady_clock::time_point when) {
+        struct Awaiter {
+            EventLoop &loop;
+            std::chrono::steady_clock::time_point when;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { loop.post_at(when, handle); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{*this, when};
+    }
+
+    // Wywoływane tylko z wątku pętli; `on_readable` może usunąć własny deskryptor przez unwatch()
+    void watch(int fd, std::function<void()> on_readable) { watchers_[fd] = std::move(on_readable); }
+    void unwatch(int fd) { watchers_.erase(fd); }
+
+    [[noreturn]] void run() {
+        std::vector<pollfd> fds;
+        std::vector<int> readable;
+        for (;;) {
+            fds.assign(svc_pollfd, svc_pollfd + svc_max_pollfd);
+            const std::size_t rpc_fds = fds.size();
+            for (const auto &watcher : watchers_) {
+                fds.push_back(pollfd{watcher.first, POLLIN, 0});
+            }
+            fds.push_back(pollfd{wake_fd_, POLLIN, 0});
+
+            timespec timeout{};
+            const int ready = ppoll(fds.data(), fds.size(), next_timeout(timeout), nullptr);
+            if (ready == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::string("poll failed: ") + std::strerror(errno));
+            }
+
+            int rpc_ready = ready;
+            if (fds.back().revents != 0) {
+                --rpc_ready;
+                drain_completions();
+            }
+            resume_due_timers();
+            readable.clear();
+            for (std::size_t i = rpc_fds; i + 1 < fds.size(); ++i) {
+                if (fds[i].revents != 0) {
+                    --rpc_ready;
+                    readable.push_back(fds[i].fd);
+                }
+            }
+            if (rpc_ready > 0) {
+                svc_getreq_poll(fds.data(), rpc_ready);
+            }
+            for (int fd : readable) {
+                auto it = watchers_.find(fd);
+                if (it != watchers_.end()) {
+                    const std::function<void()> on_readable = it->second;
+                    on_readable();
+                }
+            }
+        }
+    }
+
+private:
+    void post(std::coroutine_handle<> handle) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            completions_.push_back(handle);
+        }
+        const std::uint64_t one = 1;
+        while (write(wake_fd_, &one, sizeof(one)) == -1 && errno == EINTR) {
+        }
+    }
+
+    void post_at(std::chrono::steady_clock::time_point when, std::coroutine_handle<> handle) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            timers_.emplace(when, handle);
+        }
+        const std::uint64_t one = 1;
+        while (write(wake_fd_, &one, sizeof(one)) == -1 && errno == EINTR) {
+        }
+    }
+
+    // Czas do najbliższego timera dla ppoll; nullptr = bez limitu
+    const timespec *next_timeout(timespec &timeout) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (timers_.empty()) {
+            return nullptr;
+        }
+        const auto left = std::max(std::chrono::steady_clock::duration::zero(),
+                                   timers_.begin()->first - std::chrono::steady_clock::now());
+        const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(left);
+        timeout.tv_sec = static_cast<time_t>(seconds.count());
+        timeout.tv_nsec =
+            static_cast<long>(std::chrono::duration_cast<std::chrono::nanoseconds>(left - seconds).count());
+        return &timeout;
+    }
+
+    void resume_due_timers() {
+        std::vector<std::coroutine_handle<>> due;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const auto now = std::chrono::steady_clock::now();
+            while (!timers_.empty() && timers_.begin()->first <= now) {
+                due.push_back(timers_.begin()->second);
+                timers_.erase(timers_.begin());
+            }
+        }
+        for (auto handle : due) {
+            handle.resume();
+        }
+    }
+
+    void drain_completions() {
+        std::uint64_t counter = 0;
+        while (read(wake_fd_, &counter, sizeof(counter)) == -1 && errno == EINTR) {
+        }
+
+        std::deque<std::coroutine_handle<>> ready;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ready.swap(completions_);
+        }
+        for (auto handle : ready) {
+            handle.resume();
+        }
+    }
+
+    int wake_fd_;
+    std::map<int, std::function<void()>> watchers_;
+    std::mutex mutex_;
+    std::deque<std::coroutine_handle<>> completions_;
+    std::multimap<std::chrono::steady_clock::time_point, std::coroutine_handle<>> timers_;
+};
+
+} // namespace async
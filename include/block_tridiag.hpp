@@ -0,0 +1,393 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace btd {
+
+// Niezależne łańcuchy blokowo-trójdiagonalne: w łańcuchu c dla bloku i
+//   A_i x_{i-1} + D_i x_i + C_i x_{i+1} = r_i,   bloki b x b wierszami.
+// lower ma (blocks-1) bloków na łańcuch (A_1..A_{N-1}), upper też (C_0..C_{N-2}), diag N, rhs N wektorów.
+struct System {
+    std::size_t chains{};
+    std::size_t blocks{};
+    std::size_t b{};
+    const double *lower{};
+    const double *diag{};
+    const double *upper{};
+    const double *rhs{};
+
+    std::size_t unknowns() const { return chains * blocks * b; }
+};
+
+enum class Method { automatic, thomas, cyclic_reduction };
+
+struct Options {
+    std::size_t threads{1};
+    Method method{Method::automatic};
+    std::size_t cyclic_min_blocks{2048}; // automatic: krótsze łańcuchy zawsze algorytmem Thomasa
+};
+
+struct Result {
+    std::vector<double> solution; // łańcuch po łańcuchu, blok po bloku
+    Method method{Method::thomas};
+};
+
+inline const char *method_name(Method method) {
+    return method == Method::cyclic_reduction ? "redukcja cykliczna" : "Thomas";
+}
+
+// Koszt algorytmu Thomasa: odwrotność, dwa iloczyny blokowe i wektory na każdy blok
+inline double estimate_flops(std::size_t chains, std::size_t blocks, std::size_t b) {
+    const double bb = static_cast<double>(b);
+    return static_cast<double>(chains) * static_cast<double>(blocks) * (6.0 * bb * bb * bb + 6.0 * bb * bb);
+}
+
+namespace detail {
+
+// Jądra gęstych bloków b x b; B > 0 ustala rozmiar w czasie kompilacji (pętle rozwijane przez kompilator),
+// B = 0 to wariant z rozmiarem w czasie wykonania
+template <std::size_t B>
+class Kernels {
+public:
+    explicit Kernels(std::size_t b = B) : b_(B != 0 ? B : b) {}
+
+    std::size_t dim() const {
+        if constexpr (B != 0) {
+            return B;
+        } else {
+            return b_;
+        }
+    }
+
+    std::size_t area() const { return dim() * dim(); }
+
+    // inv = m^{-1} metodą Gaussa-Jordana z częściowym wyborem; work ma area() miejsc
+    void invert(const double *m, double *inv, double *work) const {
+        const std::size_t b = dim();
+        double scale = 0.0;
+        for (std::size_t i = 0; i < b * b; ++i) {
+            work[i] = m[i];
+            inv[i] = 0.0;
+            scale = std::max(scale, std::fabs(m[i]));
+        }
+        for (std::size_t i = 0; i < b; ++i) {
+            inv[i * b + i] = 1.0;
+        }
+        for (std::size_t col = 0; col < b; ++col) {
+            std::size_t best = col;
+            for (std::size_t row = col + 1; row < b; ++row) {
+                if (std::fabs(work[row * b + col]) > std::fabs(work[best * b + col])) {
+                    best = row;
+                }
+            }
+            const double pivot = work[best * b + col];
+            if (!(std::fabs(pivot) > scale * 1e-14)) {
+                throw std::runtime_error("Singular diagonal block");
+            }
+            if (best != col) {
+                for (std::size_t j = 0; j < b; ++j) {
+                    std::swap(work[best * b + j], work[col * b + j]);
+                    std::swap(inv[best * b + j], inv[col * b + j]);
+                }
+            }
+            const double reciprocal = 1.0 / pivot;
+            for (std::size_t j = 0; j < b; ++j) {
+                work[col * b + j] *= reciprocal;
+                inv[col * b + j] *= reciprocal;
+            }
+            for (std::size_t row = 0; row < b; ++row) {
+                const double factor = work[row * b + col];
+                if (row == col || factor == 0.0) {
+                    continue;
+                }
+                for (std::size_t j = 0; j < b; ++j) {
+                    work[row * b + j] -= factor * work[col * b + j];
+                    inv[row * b + j] -= factor * inv[col * b + j];
+                }
+            }
+        }
+    }
+
+    // z = sign * x y albo (accumulate) z += sign * x y; z nie może się pokrywać z x ani y
+    void multiply(const double *x, const double *y, double *z, double sign, bool accumulate) const {
+        const std::size_t b = dim();
+        for (std::size_t i = 0; i < b; ++i) {
+            double *out = z + i * b;
+            if (!accumulate) {
+                for (std::size_t j = 0; j < b; ++j) {
+                    out[j] = 0.0;
+                }
+            }
+            for (std::size_t k = 0; k < b; ++k) {
+                const double factor = sign * x[i * b + k];
+                for (std::size_t j = 0; j < b; ++j) {
+                    out[j] += factor * y[k * b + j];
+                }
+            }
+        }
+    }
+
+    // out = sign * x v (assign) albo out += sign * x v
+    void multiply_vector(const double *x, const double *v, double *out, double sign, bool accumulate) const {
+        const std::size_t b = dim();
+        for (std::size_t i = 0; i < b; ++i) {
+            double sum = 0.0;
+            for (std::size_t k = 0; k < b; ++k) {
+                sum += x[i * b + k] * v[k];
+            }
+            out[i] = (accumulate ? out[i] : 0.0) + sign * sum;
+        }
+    }
+
+private:
+    std::size_t b_;
+};
+
+// Wywołuje fn z jądrami dla rozmiaru bloku; typowe rozmiary mają własne instancje
+template <typename Fn>
+void with_kernels(std::size_t b, Fn &&fn) {
+    switch (b) {
+    case 1:
+        fn(Kernels<1>{});
+        break;
+    case 2:
+        fn(Kernels<2>{});
+        break;
+    case 3:
+        fn(Kernels<3>{});
+        break;
+    case 4:
+        fn(Kernels<4>{});
+        break;
+    case 5:
+        fn(Kernels<5>{});
+        break;
+    case 6:
+        fn(Kernels<6>{});
+        break;
+    case 8:
+        fn(Kernels<8>{});
+        break;
+    default:
+        fn(Kernels<0>{b});
+        break;
+    }
+}
+
+// body(first, last) dla rozłącznych części [0, count); przy małej liczbie elementów bez wątków
+template <typename Body>
+void parallel_for(std::size_t count, std::size_t threads, std::size_t grain, Body &&body) {
+    const std::size_t parts = std::min(std::max<std::size_t>(1, threads), count / std::max<std::size_t>(1, grain));
+    if (parts <= 1) {
+        body(0, count);
+        return;
+    }
+    // Wyjątek z wątku (np. osobliwy blok) jest przekazywany wywołującemu po dołączeniu wszystkich wątków
+    std::vector<std::exception_ptr> errors(parts);
+    std::vector<std::thread> workers;
+    workers.reserve(parts - 1);
+    for (std::size_t t = 1; t < parts; ++t) {
+        workers.emplace_back([&body, &errors, t, count, parts]() {
+            try {
+                body(count * t / parts, count * (t + 1) / parts);
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    try {
+        body(0, count / parts);
+    } catch (...) {
+        errors[0] = std::current_exception();
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    for (const auto &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+// Blokowy algorytm Thomasa dla jednego łańcucha; x ma blocks*b miejsc
+template <typename K>
+void thomas(const K &kernels, std::size_t blocks, const double *lower, const double *diag, const double *upper,
+            const double *rhs, double *x) {
+    const std::size_t b = kernels.dim();
+    const std::size_t bb = kernels.area();
+    std::vector<double> c_prime(blocks > 1 ? (blocks - 1) * bb : 0);
+    std::vector<double> m(bb);
+    std::vector<double> inverse(bb);
+    std::vector<double> work(bb);
+    std::vector<double> t(b);
+
+    for (std::size_t i = 0; i < blocks; ++i) {
+        std::copy_n(diag + i * bb, bb, m.data());
+        std::copy_n(rhs + i * b, b, t.data());
+        if (i > 0) {
+            const double *a = lower + (i - 1) * bb;
+            kernels.multiply(a, &c_prime[(i - 1) * bb], m.data(), -1.0, true);
+            kernels.multiply_vector(a, x + (i - 1) * b, t.data(), -1.0, true);
+        }
+        kernels.invert(m.data(), inverse.data(), work.data());
+        if (i + 1 < blocks) {
+            kernels.multiply(inverse.data(), upper + i * bb, &c_prime[i * bb], 1.0, false);
+        }
+        kernels.multiply_vector(inverse.data(), t.data(), x + i * b, 1.0, false);
+    }
+
+    for (std::size_t i = blocks - 1; i-- > 0;) {
+        kernels.multiply_vector(&c_prime[i * bb], x + (i + 1) * b, x + i * b, -1.0, true);
+    }
+}
+
+// Blokowa redukcja cykliczna jednego łańcucha: na poziomie o kroku s równania i z (i+1) % 2s == 0 eliminują
+// sąsiadów i±s, a każdy poziom liczy się równolegle. Około dwa razy więcej działań niż Thomas, ale
+// głębokość log2(blocks) zamiast blocks.
+template <typename K>
+void cyclic_reduction(const K &kernels, std::size_t blocks, const double *lower, const double *diag,
+                      const double *upper, const double *rhs, double *x, std::size_t threads) {
+    const std::size_t b = kernels.dim();
+    const std::size_t bb = kernels.area();
+    const std::size_t n = blocks;
+    // A_0 = 0 i C_{N-1} = 0, więc brakujący sąsiedzi nie wymagają osobnych przypadków przy redukcji
+    std::vector<double> a(n * bb, 0.0);
+    std::vector<double> d(diag, diag + n * bb);
+    std::vector<double> c(n * bb, 0.0);
+    std::vector<double> r(rhs, rhs + n * b);
+    std::vector<double> inverse(n * bb);
+    std::copy_n(lower, (n - 1) * bb, a.begin() + static_cast<std::ptrdiff_t>(bb));
+    std::copy_n(upper, (n - 1) * bb, c.begin());
+    constexpr std::size_t kGrain = 64;
+
+    std::size_t s = 1;
+    for (; 2 * s <= n; s *= 2) {
+        const std::size_t eliminated = (n + s) / (2 * s);
+        parallel_for(eliminated, threads, kGrain, [&](std::size_t first, std::size_t last) {
+            std::vector<double> work(bb);
+            for (std::size_t e = first; e < last; ++e) {
+                const std::size_t j = 2 * s * e + s - 1;
+                kernels.invert(&d[j * bb], &inverse[j * bb], work.data());
+            }
+        });
+        const std::size_t kept = n / (2 * s);
+        parallel_for(kept, threads, kGrain, [&](std::size_t first, std::size_t last) {
+            std::vector<double> factor(bb);
+            std::vector<double> next_a(bb);
+            std::vector<double> next_c(bb);
+            for (std::size_t k = first; k < last; ++k) {
+                const std::size_t i = 2 * s * (k + 1) - 1;
+                const std::size_t lo = i - s;
+                double *ai = &a[i * bb];
+                double *ci = &c[i * bb];
+                double *di = &d[i * bb];
+                double *ri = &r[i * b];
+
+                kernels.multiply(ai, &inverse[lo * bb], factor.data(), -1.0, false);
+                kernels.multiply(factor.data(), &a[lo * bb], next_a.data(), 1.0, false);
+                kernels.multiply(factor.data(), &c[lo * bb], di, 1.0, true);
+                kernels.multiply_vector(factor.data(), &r[lo * b], ri, 1.0, true);
+
+                const std::size_t hi = i + s;
+                if (hi < n) {
+                    kernels.multiply(ci, &inverse[hi * bb], factor.data(), -1.0, false);
+                    kernels.multiply(factor.data(), &c[hi * bb], next_c.data(), 1.0, false);
+                    kernels.multiply(factor.data(), &a[hi * bb], di, 1.0, true);
+                    kernels.multiply_vector(factor.data(), &r[hi * b], ri, 1.0, true);
+                } else {
+                    std::fill(next_c.begin(), next_c.end(), 0.0);
+                }
+                std::copy(next_a.begin(), next_a.end(), ai);
+                std::copy(next_c.begin(), next_c.end(), ci);
+            }
+        });
+    }
+
+    // Zostało jedno równanie bez sąsiadów
+    {
+        const std::size_t root = s - 1;
+        std::vector<double> work(bb);
+        kernels.invert(&d[root * bb], &inverse[root * bb], work.data());
+        kernels.multiply_vector(&inverse[root * bb], &r[root * b], x + root * b, 1.0, false);
+    }
+
+    for (s /= 2; s >= 1; s /= 2) {
+        const std::size_t eliminated = (n + s) / (2 * s);
+        parallel_for(eliminated, threads, kGrain, [&](std::size_t first, std::size_t last) {
+            std::vector<double> t(b);
+            for (std::size_t e = first; e < last; ++e) {
+                const std::size_t j = 2 * s * e + s - 1;
+                std::copy_n(&r[j * b], b, t.data());
+                // Pierwsze równanie poziomu (j = s - 1) nie ma sąsiada z lewej
+                if (j >= s) {
+                    kernels.multiply_vector(&a[j * bb], x + (j - s) * b, t.data(), -1.0, true);
+                }
+                if (j + s < n) {
+                    kernels.multiply_vector(&c[j * bb], x + (j + s) * b, t.data(), -1.0, true);
+                }
+                kernels.multiply_vector(&inverse[j * bb], t.data(), x + j * b, 1.0, false);
+            }
+        });
+    }
+}
+
+} // namespace detail
+
+inline Result solve(const System &system, const Options &options = {}) {
+    if (system.chains == 0 || system.blocks == 0 || system.b == 0) {
+        throw std::invalid_argument("Block tridiagonal system needs chains, blocks and block size");
+    }
+    const std::size_t threads = std::max<std::size_t>(1, options.threads);
+    const std::size_t n = system.blocks;
+    const std::size_t b = system.b;
+    const std::size_t bb = b * b;
+
+    Result result;
+    result.solution.resize(system.unknowns());
+    result.method = options.method;
+    if (result.method == Method::automatic) {
+        // Wiele łańcuchów wystarcza do zajęcia wątków; redukcja cykliczna tylko dla nielicznych długich
+        result.method = system.chains < threads && n >= options.cyclic_min_blocks ? Method::cyclic_reduction
+                                                                                   : Method::thomas;
+    }
+    if (n < 2) {
+        result.method = Method::thomas;
+    }
+
+    detail::with_kernels(b, [&](const auto &kernels) {
+        auto chain = [&](std::size_t index, std::size_t inner_threads) {
+            const double *lower = system.lower + index * (n - 1) * bb;
+            const double *diag = system.diag + index * n * bb;
+            const double *upper = system.upper + index * (n - 1) * bb;
+            const double *rhs = system.rhs + index * n * b;
+            double *x = result.solution.data() + index * n * b;
+            if (result.method == Method::cyclic_reduction) {
+                detail::cyclic_reduction(kernels, n, lower, diag, upper, rhs, x, inner_threads);
+            } else {
+                detail::thomas(kernels, n, lower, diag, upper, rhs, x);
+            }
+        };
+        if (result.method == Method::cyclic_reduction) {
+            for (std::size_t index = 0; index < system.chains; ++index) {
+                chain(index, threads);
+            }
+        } else {
+            detail::parallel_for(system.chains, threads, 1, [&](std::size_t first, std::size_t last) {
+                for (std::size_t index = first; index < last; ++index) {
+                    chain(index, 1);
+                }
+            });
+        }
+    });
+    return result;
+}
+
+} // namespace btd
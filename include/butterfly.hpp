@@ -0,0 +1,219 @@
+#pragma once
+
+#include "gaussian.hpp"
+#include "matrix.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace rbt {
+
+// Losowe przekształcenia motylkowe (RBT): dla U, V złożonych z `depth` poziomów motylków
+//   B = 1/sqrt(2) [R0  R1; R0 -R1]   (R0, R1 losowe przekątne)
+// macierz U^T A V ma z dużym prawdopodobieństwem niezerowe minory wiodące, więc LU bez wyboru elementu
+// głównego jest stabilne. Bez wyboru nie ma synchronizacji na szukanie i zamianę wierszy w każdej kolumnie:
+// wiersze główne panelu są znane z góry, a workery eliminują cały panel kolumn jednym zadaniem.
+// Układ jest uzupełniany jednostkowo do wielokrotności 2^depth; przekształcenia kosztują O(depth n^2).
+struct Options {
+    std::size_t depth{2};
+    std::size_t panel{32};           // kolumny eliminowane jednym zadaniem workerów
+    std::size_t max_refinements{10}; // kroki poprawiania z oryginalną macierzą
+    std::uint64_t seed{0};           // 0 = losowe przekształcenia
+    std::size_t max_processes{0};
+};
+
+struct Result {
+    std::vector<double> x;
+    std::size_t refinements{};
+    double residual{}; // skalowana reszta jak w scaled_residual
+};
+
+// Zbyt mały element główny przekształconej macierzy: RBT o małej głębokości miesza tylko grupy 2^depth wierszy
+// i kolumn, więc dla macierzy o szczególnej strukturze (np. permutacji) minor wiodący może być zerowy.
+// Wywołujący rozwiązuje wtedy układ z wyborem elementu głównego.
+class PivotBreakdown : public std::runtime_error {
+public:
+    PivotBreakdown() : std::runtime_error("Zero pivot after butterfly transform") {}
+};
+
+// Przekątne motylków U i V: poziom l ma 2^l motylków rozmiaru size / 2^l, razem size wartości na poziom
+class Butterflies {
+public:
+    Butterflies(std::size_t size, std::size_t depth, std::uint64_t seed)
+        : size_(size), depth_(depth), u_(size * depth), v_(size * depth) {
+        std::mt19937_64 random(seed != 0 ? seed : std::random_device{}());
+        std::uniform_real_distribution<double> exponent(-0.5, 0.5);
+        for (double &value : u_) {
+            value = std::exp(exponent(random) / 10.0);
+        }
+        for (double &value : v_) {
+            value = std::exp(exponent(random) / 10.0);
+        }
+    }
+
+    // data := U^T data dla macierzy size x width wierszami (pary wierszy łączone na całej szerokości)
+    void transform_rows(double *data, std::size_t width) const {
+        for (std::size_t level = 0; level < depth_; ++level) {
+            for_each_pair(level, [&](std::size_t top, std::size_t bottom, double r0, double r1) {
+                double *__restrict a = &data[top * width];
+                double *__restrict b = &data[bottom * width];
+                for (std::size_t k = 0; k < width; ++k) {
+                    const double sum = a[k] + b[k];
+                    const double difference = a[k] - b[k];
+                    a[k] = r0 * sum;
+                    b[k] = r1 * difference;
+                }
+            }, u_);
+        }
+    }
+
+    // data := data V na pierwszych size kolumnach każdego wiersza (kolumna prawej strony bez zmian)
+    void transform_columns(double *data, std::size_t width) const {
+        for (std::size_t row = 0; row < size_; ++row) {
+            transform_vector(&data[row * width], v_);
+        }
+    }
+
+    // z := U^T z (reszta przed rozwiązaniem z czynnikami przekształconej macierzy)
+    void transform_rhs(std::vector<double> &z) const { transform_vector(z.data(), u_); }
+
+    // y := V y (powrót od rozwiązania przekształconego układu do x)
+    void recover(std::vector<double> &y) const {
+        for (std::size_t level = depth_; level-- > 0;) {
+            for_each_pair(level, [&](std::size_t top, std::size_t bottom, double r0, double r1) {
+                const double a = r0 * y[top];
+                const double b = r1 * y[bottom];
+                y[top] = a + b;
+                y[bottom] = a - b;
+            }, v_);
+        }
+    }
+
+private:
+    // Pary (top, bottom) wszystkich motylków poziomu z przekątnymi przeskalowanymi przez 1/sqrt(2)
+    template <typename Visit>
+    void for_each_pair(std::size_t level, Visit &&visit, const std::vector<double> &diagonals) const {
+        const double scale = 1.0 / std::sqrt(2.0);
+        const std::size_t block = size_ >> level;
+        const std::size_t half = block / 2;
+        const double *d = &diagonals[level * size_];
+        for (std::size_t offset = 0; offset < size_; offset += block) {
+            for (std::size_t i = offset; i < offset + half; ++i) {
+                visit(i, i + half, scale * d[i], scale * d[i + half]);
+            }
+        }
+    }
+
+    // B^T na wektorze długości size (ten sam wzór dla kolumny U^T z i wiersza a V)
+    void transform_vector(double *z, const std::vector<double> &diagonals) const {
+        for (std::size_t level = 0; level < depth_; ++level) {
+            for_each_pair(level, [&](std::size_t top, std::size_t bottom, double r0, double r1) {
+                const double sum = z[top] + z[bottom];
+                const double difference = z[top] - z[bottom];
+                z[top] = r0 * sum;
+                z[bottom] = r1 * difference;
+            }, diagonals);
+        }
+    }
+
+    std::size_t size_;
+    std::size_t depth_;
+    std::vector<double> u_;
+    std::vector<double> v_;
+};
+
+inline double estimate_flops(std::size_t n, std::size_t depth = 2) {
+    const double size = static_cast<double>(n);
+    return 2.0 / 3.0 * size * size * size + 3.0 * static_cast<double>(depth) * size * size;
+}
+
+// A x = b przez U^T A V = LU bez wyboru elementu głównego (eliminacja panelami w workerach), potem
+// poprawianie z oryginalną macierzą (refine z gaussian.hpp), aż skalowana reszta spadnie do poziomu double
+// albo przestanie maleć. Zbyt mały element główny mimo przekształcenia kończy się wyjątkiem PivotBreakdown.
+inline Result solve(const CppMatrix &augmented, const Options &options = {}) {
+    detail::validate_augmented(augmented);
+    if (options.depth == 0 || options.depth > 16 || options.panel == 0) {
+        throw std::invalid_argument("Butterfly depth must be between 1 and 16 and panel must be positive");
+    }
+    constexpr double kEpsilon = 1e-12;
+    const std::size_t n = augmented.rows;
+    const std::size_t block = std::size_t{1} << options.depth;
+    const std::size_t size = (n + block - 1) / block * block;
+
+    // [A 0; 0 I] rozmiaru size, przekształcone do U^T A V
+    const Butterflies butterflies(size, options.depth, options.seed);
+    detail::SharedWorkspace workspace(size, size);
+    double *data = workspace.data();
+    for (std::size_t r = 0; r < size; ++r) {
+        double *target = &data[r * size];
+        std::fill(target, target + size, 0.0);
+        if (r < n) {
+            std::copy_n(&augmented.data[r * augmented.cols], n, target);
+        } else {
+            target[r] = 1.0;
+        }
+    }
+    butterflies.transform_rows(data, size);
+    butterflies.transform_columns(data, size);
+    workspace.build_tiles();
+
+    {
+        detail::WorkerProcessPool workers(workspace, options.max_processes);
+        for (std::size_t first = 0; first < size; first += options.panel) {
+            const std::size_t last = std::min(size, first + options.panel);
+            for (std::size_t col = first; col < last; ++col) {
+                if (std::fabs(data[col * size + col]) < kEpsilon) {
+                    throw PivotBreakdown();
+                }
+                GAUS_PROBE2(column__start, col, size);
+                detail::eliminate_rows(data, size, col, col + 1, last, workspace.tiles());
+                GAUS_PROBE2(column__end, col, size);
+            }
+            workers.eliminate_columns(first, last - first);
+        }
+        workers.shutdown();
+    }
+
+    // Poprawka d = V U'^{-1} L^{-1} U^T r; dla r = b to samo rozwiązanie
+    auto correct = [&](const std::vector<double> &residual) {
+        std::vector<double> z(size, 0.0);
+        std::copy(residual.begin(), residual.end(), z.begin());
+        butterflies.transform_rhs(z);
+        for (std::size_t i = 0; i < size; ++i) {
+            const double *row = &data[i * size];
+            double value = z[i];
+            for (std::size_t j = 0; j < i; ++j) {
+                value -= row[j] * z[j];
+            }
+            z[i] = value;
+        }
+        for (std::size_t i = size; i-- > 0;) {
+            const double *row = &data[i * size];
+            double value = z[i];
+            for (std::size_t j = i + 1; j < size; ++j) {
+                value -= row[j] * z[j];
+            }
+            z[i] = value / row[i];
+        }
+        butterflies.recover(z);
+        z.resize(n);
+        return z;
+    };
+
+    Result result;
+    result.x = correct(augmented_rhs(augmented));
+    auto residual_of = [&](const std::vector<double> &x, std::vector<double> &residual) {
+        return residual_into(augmented, x, residual);
+    };
+    const Refinement refinement = refine(result.x, options.max_refinements, residual_of, correct);
+    result.residual = refinement.residual;
+    result.refinements = refinement.corrections;
+    return result;
+}
+
+} // namespace rbt
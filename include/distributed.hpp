@@ -0,0 +1,587 @@
+#pragma once
+
+#include "gaussian.hpp"
+#include "matrix.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace grid {
+
+struct GridShape {
+    std::size_t rows{1}; // P
+    std::size_t cols{1}; // Q
+
+    std::size_t size() const { return rows * cols; }
+};
+
+struct Endpoint {
+    std::string host;
+    std::uint16_t port{};
+};
+
+// "PxQ", np. "2x3"
+inline GridShape parse_grid_shape(const std::string &spec) {
+    const auto x = spec.find('x');
+    if (x == std::string::npos) {
+        throw std::invalid_argument("Grid shape must look like PxQ: " + spec);
+    }
+    GridShape shape;
+    shape.rows = std::stoul(spec.substr(0, x));
+    shape.cols = std::stoul(spec.substr(x + 1));
+    if (shape.rows == 0 || shape.cols == 0) {
+        throw std::invalid_argument("Grid dimensions must be positive: " + spec);
+    }
+    return shape;
+}
+
+// "host:port,host:port,..." - pozycja na liście to numer procesu (rank)
+inline std::vector<Endpoint> parse_peers(const std::string &spec) {
+    std::vector<Endpoint> peers;
+    std::size_t begin = 0;
+    while (begin <= spec.size()) {
+        const auto end = std::min(spec.find(',', begin), spec.size());
+        const std::string item = spec.substr(begin, end - begin);
+        const auto colon = item.rfind(':');
+        if (colon == std::string::npos || colon == 0) {
+            throw std::invalid_argument("Peer must look like host:port: " + item);
+        }
+        peers.push_back(Endpoint{item.substr(0, colon), static_cast<std::uint16_t>(std::stoul(item.substr(colon + 1)))});
+        begin = end + 1;
+    }
+    return peers;
+}
+
+// Awaria komunikacji z innym procesem siatki (w odróżnieniu od błędów numerycznych)
+class PeerError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Pełna siatka połączeń TCP między procesami; komunikaty mają rozmiary znane obu stronom
+class PeerMesh {
+public:
+    PeerMesh(std::size_t rank, std::vector<Endpoint> peers) : rank_(rank), peers_(std::move(peers)) {
+        if (rank_ >= peers_.size()) {
+            throw std::invalid_argument("Rank is outside of the peer list");
+        }
+        fds_.assign(peers_.size(), -1);
+    }
+
+    ~PeerMesh() {
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    PeerMesh(const PeerMesh &) = delete;
+    PeerMesh &operator=(const PeerMesh &) = delete;
+
+    std::size_t rank() const { return rank_; }
+    std::size_t size() const { return peers_.size(); }
+
+    // Łączy się z procesami o niższym numerze i przyjmuje połączenia od wyższych
+    void connect_all(std::chrono::seconds timeout = std::chrono::seconds(60)) {
+        const int listen_fd = listen_on(peers_[rank_].port);
+        struct ListenGuard {
+            int fd;
+            ~ListenGuard() { close(fd); }
+        } listen_guard{listen_fd};
+
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        for (std::size_t peer = 0; peer < rank_; ++peer) {
+            fds_[peer] = connect_with_retry(peers_[peer], deadline);
+            const std::uint64_t me = rank_;
+            send(peer, &me, sizeof(me));
+        }
+
+        for (std::size_t accepted = rank_ + 1; accepted < peers_.size(); ++accepted) {
+            const int fd = accept(listen_fd, nullptr, nullptr);
+            if (fd == -1) {
+                throw std::runtime_error(detail::errno_message("accept failed"));
+            }
+            tune(fd);
+            std::uint64_t peer = 0;
+            if (!detail::fd_read_full(fd, &peer, sizeof(peer)) || peer <= rank_ || peer >= peers_.size() ||
+                fds_[peer] != -1) {
+                close(fd);
+                throw std::runtime_error("invalid grid handshake");
+            }
+            fds_[peer] = fd;
+        }
+    }
+
+    void send(std::size_t to, const void *data, std::size_t bytes) {
+        if (!detail::fd_write_full(fds_[to], data, bytes)) {
+            throw PeerError(detail::errno_message("grid send failed"));
+        }
+    }
+
+    void recv(std::size_t from, void *data, std::size_t bytes) {
+        if (!detail::fd_read_full(fds_[from], data, bytes)) {
+            throw PeerError("grid peer " + std::to_string(from) + " disconnected");
+        }
+    }
+
+    template <typename T>
+    void send_vector(std::size_t to, const std::vector<T> &values) {
+        send(to, values.data(), values.size() * sizeof(T));
+    }
+
+    template <typename T>
+    void recv_vector(std::size_t from, std::vector<T> &values) {
+        recv(from, values.data(), values.size() * sizeof(T));
+    }
+
+private:
+    static void tune(int fd) {
+        const int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+
+    static int listen_on(std::uint16_t port) {
+        const int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd == -1) {
+            throw std::runtime_error(detail::errno_message("socket failed"));
+        }
+        const int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(port);
+        if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == -1 || listen(fd, 64) == -1) {
+            const std::string message = detail::errno_message("grid listen failed");
+            close(fd);
+            throw std::runtime_error(message);
+        }
+        return fd;
+    }
+
+    static int connect_with_retry(const Endpoint &peer, std::chrono::steady_clock::time_point deadline) {
+        addrinfo hints{};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        const std::string port = std::to_string(peer.port);
+        for (;;) {
+            addrinfo *found = nullptr;
+            if (getaddrinfo(peer.host.c_str(), port.c_str(), &hints, &found) == 0) {
+                const int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+                const bool ok = fd != -1 && ::connect(fd, found->ai_addr, found->ai_addrlen) == 0;
+                freeaddrinfo(found);
+                if (ok) {
+                    tune(fd);
+                    return fd;
+                }
+                if (fd != -1) {
+                    close(fd);
+                }
+            }
+            if (std::chrono::steady_clock::now() > deadline) {
+                throw std::runtime_error("cannot connect to grid peer " + peer.host + ":" + port);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        }
+    }
+
+    std::size_t rank_;
+    std::vector<Endpoint> peers_;
+    std::vector<int> fds_;
+};
+
+// Indeksy globalne należące do części `part` z `parts` przy rozkładzie blokowo-cyklicznym (rosnąco)
+inline std::vector<std::size_t> owned_indices(std::size_t total, std::size_t block, std::size_t parts,
+                                              std::size_t part) {
+    std::vector<std::size_t> owned;
+    for (std::size_t start = part * block; start < total; start += parts * block) {
+        for (std::size_t i = start; i < std::min(total, start + block); ++i) {
+            owned.push_back(i);
+        }
+    }
+    return owned;
+}
+
+// Pierwsza pozycja lokalna o indeksie globalnym >= g
+inline std::size_t first_at_or_after(const std::vector<std::size_t> &owned, std::size_t g) {
+    return static_cast<std::size_t>(std::lower_bound(owned.begin(), owned.end(), g) - owned.begin());
+}
+
+// Rozproszona eliminacja Gaussa z częściowym wyborem elementu głównego na siatce procesów P x Q
+// z rozkładem blokowo-cyklicznym 2D (jak w ScaLAPACK/HPL). Panel faktoryzuje proces diagonalny
+// kolumny procesów, panel L jest rozgłaszany wzdłuż wierszy procesów, a blok U wzdłuż kolumn.
+// Kolumna prawej strony jest ostatnią kolumną macierzy rozszerzonej i podlega tym samym operacjom.
+class DistributedSolver {
+public:
+    DistributedSolver(PeerMesh &mesh, GridShape shape) : mesh_(mesh), shape_(shape) {
+        if (shape_.size() != mesh_.size()) {
+            throw std::invalid_argument("Grid shape does not match the number of peers");
+        }
+    }
+
+    // Proces 0: rozsyła macierz, uczestniczy w faktoryzacji, zbiera U i rozwiązuje wstecz
+    std::vector<double> solve(const CppMatrix &augmented, std::size_t block) {
+        detail::validate_augmented(augmented);
+        const std::size_t n = augmented.rows;
+        const std::size_t width = augmented.cols;
+
+        const JobHeader header{kSolve, n, block};
+        for (std::size_t peer = 1; peer < mesh_.size(); ++peer) {
+            mesh_.send(peer, &header, sizeof(header));
+        }
+
+        for (std::size_t peer = 1; peer < mesh_.size(); ++peer) {
+            const Layout layout = make_layout(n, width, block, peer);
+            std::vector<double> local(layout.rows.size() * layout.cols.size());
+            for (std::size_t li = 0; li < layout.rows.size(); ++li) {
+                for (std::size_t lj = 0; lj < layout.cols.size(); ++lj) {
+                    local[li * layout.cols.size() + lj] = augmented(layout.rows[li], layout.cols[lj]);
+                }
+            }
+            mesh_.send_vector(peer, local);
+        }
+
+        Layout layout = make_layout(n, width, block, 0);
+        std::vector<double> local(layout.rows.size() * layout.cols.size());
+        for (std::size_t li = 0; li < layout.rows.size(); ++li) {
+            for (std::size_t lj = 0; lj < layout.cols.size(); ++lj) {
+                local[li * layout.cols.size() + lj] = augmented(layout.rows[li], layout.cols[lj]);
+            }
+        }
+
+        const bool ok = factor(layout, local);
+
+        std::vector<double> reduced(n * width, 0.0);
+        auto scatter_into_global = [&](const Layout &part, const std::vector<double> &values) {
+            for (std::size_t li = 0; li < part.rows.size(); ++li) {
+                for (std::size_t lj = 0; lj < part.cols.size(); ++lj) {
+                    reduced[part.rows[li] * width + part.cols[lj]] = values[li * part.cols.size() + lj];
+                }
+            }
+        };
+        scatter_into_global(layout, local);
+        for (std::size_t peer = 1; peer < mesh_.size(); ++peer) {
+            const Layout part = make_layout(n, width, block, peer);
+            std::vector<double> values(part.rows.size() * part.cols.size());
+            mesh_.recv_vector(peer, values);
+            scatter_into_global(part, values);
+        }
+
+        if (!ok) {
+            throw std::runtime_error("Matrix is singular or ill-conditioned");
+        }
+
+        constexpr double kEpsilon = 1e-12;
+        std::vector<double> solution(n, 0.0);
+        for (std::size_t i = n; i-- > 0;) {
+            double rhs = reduced[i * width + (width - 1)];
+            for (std::size_t j = i + 1; j < n; ++j) {
+                rhs -= reduced[i * width + j] * solution[j];
+            }
+            const double pivot = reduced[i * width + i];
+            if (std::fabs(pivot) < kEpsilon) {
+                throw std::runtime_error("Matrix is singular or ill-conditioned");
+            }
+            solution[i] = rhs / pivot;
+        }
+        return solution;
+    }
+
+    // Procesy 1..P*Q-1: obsługują kolejne zadania od procesu 0, dopóki połączenie istnieje
+    void serve() {
+        for (;;) {
+            JobHeader header{};
+            mesh_.recv(0, &header, sizeof(header));
+            if (header.command != kSolve) {
+                return;
+            }
+            const std::size_t n = header.n;
+            const Layout layout = make_layout(n, n + 1, header.block, mesh_.rank());
+            std::vector<double> local(layout.rows.size() * layout.cols.size());
+            mesh_.recv_vector(0, local);
+            factor(layout, local);
+            mesh_.send_vector(0, local);
+        }
+    }
+
+    // Kończy pracę procesów pomocniczych
+    void shutdown() {
+        const JobHeader header{kExit, 0, 0};
+        for (std::size_t peer = 1; peer < mesh_.size(); ++peer) {
+            mesh_.send(peer, &header, sizeof(header));
+        }
+    }
+
+private:
+    static constexpr std::uint64_t kSolve = 1;
+    static constexpr std::uint64_t kExit = 2;
+
+    struct JobHeader {
+        std::uint64_t command;
+        std::uint64_t n;
+        std::uint64_t block;
+    };
+
+    struct Layout {
+        std::size_t n;
+        std::size_t block;
+        std::size_t prow;
+        std::size_t pcol;
+        std::vector<std::size_t> rows; // globalne indeksy lokalnych wierszy
+        std::vector<std::size_t> cols; // globalne indeksy lokalnych kolumn
+    };
+
+    Layout make_layout(std::size_t n, std::size_t width, std::size_t block, std::size_t rank) const {
+        Layout layout;
+        layout.n = n;
+        layout.block = block;
+        layout.prow = rank / shape_.cols;
+        layout.pcol = rank % shape_.cols;
+        layout.rows = owned_indices(n, block, shape_.rows, layout.prow);
+        layout.cols = owned_indices(width, block, shape_.cols, layout.pcol);
+        return layout;
+    }
+
+    std::size_t rank_of(std::size_t prow, std::size_t pcol) const { return prow * shape_.cols + pcol; }
+    std::size_t row_owner(std::size_t g, std::size_t block) const { return (g / block) % shape_.rows; }
+
+    // Wspólny algorytm wszystkich procesów; zwraca false, gdy macierz okazała się osobliwa
+    bool factor(const Layout &layout, std::vector<double> &a) {
+        constexpr double kEpsilon = 1e-12;
+        const std::size_t n = layout.n;
+        const std::size_t nb = layout.block;
+        const std::size_t lda = layout.cols.size();
+        const std::size_t me = mesh_.rank();
+
+        for (std::size_t k0 = 0, panel = 0; k0 < n; k0 += nb, ++panel) {
+            const std::size_t kb = std::min(nb, n - k0);
+            const std::size_t pr = panel % shape_.rows;
+            const std::size_t pc = panel % shape_.cols;
+            const std::size_t diag = rank_of(pr, pc);
+
+            const std::size_t row_begin = first_at_or_after(layout.rows, k0);
+            const std::size_t my_panel_rows = layout.rows.size() - row_begin;
+            const std::size_t trail_col = first_at_or_after(layout.cols, k0 + kb);
+            const std::size_t trail_width = lda - trail_col;
+
+            // 1. Faktoryzacja panelu w procesie diagonalnym kolumny procesów pc
+            std::vector<std::int64_t> pivots(kb + 1, 0); // [0] = status
+            if (layout.pcol == pc) {
+                const std::size_t panel_col = first_at_or_after(layout.cols, k0);
+                if (me == diag) {
+                    std::vector<double> panel_buf((n - k0) * kb);
+                    auto place = [&](const std::vector<std::size_t> &rows, std::size_t begin,
+                                     const std::vector<double> &values) {
+                        for (std::size_t i = begin; i < rows.size(); ++i) {
+                            std::copy_n(&values[(i - begin) * kb], kb, &panel_buf[(rows[i] - k0) * kb]);
+                        }
+                    };
+                    std::vector<double> own(my_panel_rows * kb);
+                    for (std::size_t i = 0; i < my_panel_rows; ++i) {
+                        std::copy_n(&a[(row_begin + i) * lda + panel_col], kb, &own[i * kb]);
+                    }
+                    place(layout.rows, row_begin, own);
+                    for (std::size_t p = 0; p < shape_.rows; ++p) {
+                        if (p == pr) {
+                            continue;
+                        }
+                        const auto rows = owned_indices(n, nb, shape_.rows, p);
+                        const std::size_t begin = first_at_or_after(rows, k0);
+                        std::vector<double> values((rows.size() - begin) * kb);
+                        mesh_.recv_vector(rank_of(p, pc), values);
+                        place(rows, begin, values);
+                    }
+
+                    pivots[0] = factor_panel(panel_buf, n - k0, kb, k0, pivots, kEpsilon) ? 0 : 1;
+
+                    for (std::size_t i = 0; i < my_panel_rows; ++i) {
+                        std::copy_n(&panel_buf[(layout.rows[row_begin + i] - k0) * kb], kb,
+                                    &a[(row_begin + i) * lda + panel_col]);
+                    }
+                    for (std::size_t p = 0; p < shape_.rows; ++p) {
+                        if (p == pr) {
+                            continue;
+                        }
+                        const auto rows = owned_indices(n, nb, shape_.rows, p);
+                        const std::size_t begin = first_at_or_after(rows, k0);
+                        std::vector<double> values((rows.size() - begin) * kb);
+                        for (std::size_t i = begin; i < rows.size(); ++i) {
+                            std::copy_n(&panel_buf[(rows[i] - k0) * kb], kb, &values[(i - begin) * kb]);
+                        }
+                        mesh_.send_vector(rank_of(p, pc), values);
+                    }
+                } else {
+                    std::vector<double> values(my_panel_rows * kb);
+                    for (std::size_t i = 0; i < my_panel_rows; ++i) {
+                        std::copy_n(&a[(row_begin + i) * lda + panel_col], kb, &values[i * kb]);
+                    }
+                    mesh_.send_vector(diag, values);
+                    mesh_.recv_vector(diag, values);
+                    for (std::size_t i = 0; i < my_panel_rows; ++i) {
+                        std::copy_n(&values[i * kb], kb, &a[(row_begin + i) * lda + panel_col]);
+                    }
+                }
+            }
+
+            // 2. Rozgłoszenie wektora permutacji (i statusu) do wszystkich procesów
+            if (me == diag) {
+                for (std::size_t peer = 0; peer < mesh_.size(); ++peer) {
+                    if (peer != me) {
+                        mesh_.send_vector(peer, pivots);
+                    }
+                }
+            } else {
+                mesh_.recv_vector(diag, pivots);
+            }
+            if (pivots[0] != 0) {
+                return false;
+            }
+
+            // 3. Zamiany wierszy w kolumnach na prawo od panelu (wymiana w obrębie kolumny procesów)
+            if (trail_width > 0) {
+                std::vector<double> incoming(trail_width);
+                for (std::size_t j = 0; j < kb; ++j) {
+                    const std::size_t r1 = k0 + j;
+                    const std::size_t r2 = static_cast<std::size_t>(pivots[j + 1]);
+                    if (r1 == r2) {
+                        continue;
+                    }
+                    const std::size_t o1 = row_owner(r1, nb);
+                    const std::size_t o2 = row_owner(r2, nb);
+                    if (layout.prow != o1 && layout.prow != o2) {
+                        continue;
+                    }
+                    if (o1 == o2) {
+                        double *row1 = &a[first_at_or_after(layout.rows, r1) * lda + trail_col];
+                        double *row2 = &a[first_at_or_after(layout.rows, r2) * lda + trail_col];
+                        std::swap_ranges(row1, row1 + trail_width, row2);
+                        continue;
+                    }
+                    const std::size_t mine = layout.prow == o1 ? r1 : r2;
+                    const std::size_t partner = rank_of(layout.prow == o1 ? o2 : o1, layout.pcol);
+                    double *row = &a[first_at_or_after(layout.rows, mine) * lda + trail_col];
+                    if (me < partner) {
+                        mesh_.send(partner, row, trail_width * sizeof(double));
+                        mesh_.recv_vector(partner, incoming);
+                    } else {
+                        mesh_.recv_vector(partner, incoming);
+                        mesh_.send(partner, row, trail_width * sizeof(double));
+                    }
+                    std::copy(incoming.begin(), incoming.end(), row);
+                }
+            }
+
+            // 4. Rozgłoszenie panelu L wzdłuż wiersza procesów
+            std::vector<double> l_panel(my_panel_rows * kb);
+            if (layout.pcol == pc) {
+                const std::size_t panel_col = first_at_or_after(layout.cols, k0);
+                for (std::size_t i = 0; i < my_panel_rows; ++i) {
+                    std::copy_n(&a[(row_begin + i) * lda + panel_col], kb, &l_panel[i * kb]);
+                }
+                for (std::size_t q = 0; q < shape_.cols; ++q) {
+                    if (q != pc) {
+                        mesh_.send_vector(rank_of(layout.prow, q), l_panel);
+                    }
+                }
+            } else {
+                mesh_.recv_vector(rank_of(layout.prow, pc), l_panel);
+            }
+
+            // 5. Blok U12 = L11^-1 A12 w wierszu procesów pr, rozgłaszany wzdłuż kolumny procesów
+            std::vector<double> u_block(kb * trail_width);
+            if (layout.prow == pr) {
+                for (std::size_t t = 0; t < kb; ++t) {
+                    double *u_row = &a[(row_begin + t) * lda + trail_col];
+                    for (std::size_t s = 0; s < t; ++s) {
+                        const double l = l_panel[t * kb + s];
+                        if (l == 0.0) {
+                            continue;
+                        }
+                        const double *u_prev = &a[(row_begin + s) * lda + trail_col];
+                        for (std::size_t c = 0; c < trail_width; ++c) {
+                            u_row[c] -= l * u_prev[c];
+                        }
+                    }
+                    std::copy_n(u_row, trail_width, &u_block[t * trail_width]);
+                }
+                for (std::size_t p = 0; p < shape_.rows; ++p) {
+                    if (p != pr) {
+                        mesh_.send_vector(rank_of(p, layout.pcol), u_block);
+                    }
+                }
+            } else {
+                mesh_.recv_vector(rank_of(pr, layout.pcol), u_block);
+            }
+
+            // 6. Aktualizacja lokalnej części macierzy końcowej: A22 -= L21 * U12
+            const std::size_t skip = layout.prow == pr ? kb : 0;
+            for (std::size_t i = skip; i < my_panel_rows; ++i) {
+                double *row = &a[(row_begin + i) * lda + trail_col];
+                for (std::size_t t = 0; t < kb; ++t) {
+                    const double l = l_panel[i * kb + t];
+                    if (l == 0.0) {
+                        continue;
+                    }
+                    const double *u_row = &u_block[t * trail_width];
+                    for (std::size_t c = 0; c < trail_width; ++c) {
+                        row[c] -= l * u_row[c];
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    // LU z częściowym wyborem na panelu (m x kb, wiersze od k0); pivots[j + 1] = globalny wiersz zamieniany z k0 + j
+    static bool factor_panel(std::vector<double> &panel, std::size_t m, std::size_t kb, std::size_t k0,
+                             std::vector<std::int64_t> &pivots, double epsilon) {
+        for (std::size_t j = 0; j < kb; ++j) {
+            std::size_t best = j;
+            for (std::size_t i = j + 1; i < m; ++i) {
+                if (std::fabs(panel[i * kb + j]) > std::fabs(panel[best * kb + j])) {
+                    best = i;
+                }
+            }
+            pivots[j + 1] = static_cast<std::int64_t>(k0 + best);
+            if (std::fabs(panel[best * kb + j]) < epsilon) {
+                return false;
+            }
+            if (best != j) {
+                std::swap_ranges(&panel[j * kb], &panel[j * kb] + kb, &panel[best * kb]);
+            }
+            const double pivot = panel[j * kb + j];
+            for (std::size_t i = j + 1; i < m; ++i) {
+                double *row = &panel[i * kb];
+                row[j] /= pivot;
+                const double l = row[j];
+                if (l == 0.0) {
+                    continue;
+                }
+                for (std::size_t c = j + 1; c < kb; ++c) {
+                    row[c] -= l * panel[j * kb + c];
+                }
+            }
+        }
+        return true;
+    }
+
+    PeerMesh &mesh_;
+    GridShape shape_;
+};
+
+} // namespace grid
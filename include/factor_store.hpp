@@ -0,0 +1,341 @@
+#pragma once
+
+#include "gaussian.hpp"
+#include "matrix.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace store {
+
+// 64-bitowy skrót pierwszych `columns` kolumn macierzy rozszerzonej wraz z wymiarem
+inline std::uint64_t hash_leading_columns(const CppMatrix &augmented, std::size_t columns) {
+    const std::size_t n = augmented.rows;
+    std::uint64_t hash = 0x9e3779b97f4a7c15ULL ^ (static_cast<std::uint64_t>(n) * 0xff51afd7ed558ccdULL);
+    for (std::size_t r = 0; r < n; ++r) {
+        const double *row = &augmented.data[r * augmented.cols];
+        for (std::size_t c = 0; c < columns; ++c) {
+            std::uint64_t bits = 0;
+            std::memcpy(&bits, &row[c], sizeof(bits));
+            hash ^= bits + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+            hash *= 0xc4ceb9fe1a85ec53ULL;
+        }
+    }
+    hash ^= hash >> 33;
+    return hash;
+}
+
+// Skrót współczynników bez prawej strony (klucz czynników LU)
+inline std::uint64_t hash_coefficients(const CppMatrix &augmented) {
+    return hash_leading_columns(augmented, augmented.rows);
+}
+
+// Skrót całego układu razem z prawą stroną (klucz gotowego rozwiązania)
+inline std::uint64_t hash_system(const CppMatrix &augmented) {
+    return hash_leading_columns(augmented, augmented.cols);
+}
+
+inline std::string key_name(std::uint64_t key) {
+    char buffer[17];
+    std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(key));
+    return buffer;
+}
+
+// Nagłówek pliku .lu; dalej n*n elementów LU (double albo float) i n indeksów uint32 (wybór elementu głównego)
+struct FileHeader {
+    char magic[8];
+    std::uint64_t version;
+    std::uint64_t key;
+    std::uint64_t n;
+    std::uint64_t element_bytes; // 4 = float; 8 albo 0 (pliki sprzed tego pola) = double
+    std::uint64_t reserved[3];
+};
+static_assert(sizeof(FileHeader) == 64, "LU file header must keep the factor data 64-byte aligned");
+
+constexpr char kMagic[8] = {'G', 'A', 'U', 'S', 'L', 'U', '0', '1'};
+constexpr std::uint64_t kVersion = 1;
+
+// Rozmiar elementu czynników: double (dokładne rozwiązanie) albo float (połowa miejsca, wymaga poprawiania)
+enum class Precision : std::uint64_t { single = sizeof(float), full = sizeof(double) };
+
+inline Precision precision_of(const FileHeader &header) {
+    return header.element_bytes == sizeof(float) ? Precision::single : Precision::full;
+}
+
+inline std::size_t file_bytes(std::size_t n, Precision precision) {
+    return sizeof(FileHeader) + n * n * static_cast<std::size_t>(precision) + n * sizeof(std::uint32_t);
+}
+
+inline bool valid_element_bytes(std::uint64_t element_bytes) {
+    return element_bytes == 0 || element_bytes == sizeof(float) || element_bytes == sizeof(double);
+}
+
+// Plik czynników odwzorowany tylko do odczytu; strony są wczytywane leniwie przy pierwszym rozwiązaniu
+class MappedFactors {
+public:
+    explicit MappedFactors(const std::string &path) {
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            throw std::runtime_error(detail::errno_message(("open " + path + " failed").c_str()));
+        }
+        struct stat info {};
+        if (fstat(fd, &info) == -1 || static_cast<std::size_t>(info.st_size) < sizeof(FileHeader)) {
+            close(fd);
+            throw std::runtime_error("LU file is truncated: " + path);
+        }
+        bytes_ = static_cast<std::size_t>(info.st_size);
+        void *ptr = mmap(nullptr, bytes_, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (ptr == MAP_FAILED) {
+            throw std::runtime_error(detail::errno_message(("mmap " + path + " failed").c_str()));
+        }
+        base_ = static_cast<const std::byte *>(ptr);
+
+        const auto *header = reinterpret_cast<const FileHeader *>(base_);
+        if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kVersion ||
+            !valid_element_bytes(header->element_bytes) || bytes_ != file_bytes(header->n, precision_of(*header))) {
+            munmap(const_cast<std::byte *>(base_), bytes_);
+            throw std::runtime_error("Not a valid LU file: " + path);
+        }
+    }
+
+    ~MappedFactors() { munmap(const_cast<std::byte *>(base_), bytes_); }
+
+    MappedFactors(const MappedFactors &) = delete;
+    MappedFactors &operator=(const MappedFactors &) = delete;
+
+    const FileHeader &header() const { return *reinterpret_cast<const FileHeader *>(base_); }
+
+    Precision precision() const { return precision_of(header()); }
+
+    // Czynniki w double; tylko dla precision() == Precision::full
+    LuView view() const { return typed_view<double>(); }
+
+    // Czynniki w float; tylko dla precision() == Precision::single
+    BasicLuView<float> single_view() const { return typed_view<float>(); }
+
+private:
+    template <typename T>
+    BasicLuView<T> typed_view() const {
+        const std::size_t n = header().n;
+        const auto *lu = reinterpret_cast<const T *>(base_ + sizeof(FileHeader));
+        const auto *pivots = reinterpret_cast<const std::uint32_t *>(lu + n * n);
+        return BasicLuView<T>{n, lu, pivots};
+    }
+
+    const std::byte *base_{nullptr};
+    std::size_t bytes_{0};
+};
+
+// Trwały magazyn czynników LU w katalogu: jeden plik <skrót>.lu na macierz.
+// Przy starcie tylko indeksuje nagłówki; pliki są odwzorowywane przy pierwszym trafieniu.
+// Z Precision::single nowe czynniki są zapisywane jako float, więc ten sam limit mieści dwa razy więcej macierzy.
+class FactorStore {
+public:
+    struct Stats {
+        std::size_t entries{};
+        std::size_t mapped{};
+        std::uint64_t hits{};
+        std::uint64_t misses{};
+        std::uint64_t writes{};
+        std::size_t bytes{};
+    };
+
+    FactorStore(std::string directory, std::size_t max_bytes, Precision precision = Precision::full)
+        : directory_(std::move(directory)), max_bytes_(max_bytes), precision_(precision) {
+        std::filesystem::create_directories(directory_);
+        for (const auto &item : std::filesystem::directory_iterator(directory_)) {
+            if (item.is_regular_file() && item.path().extension() == ".lu") {
+                index_file_locked(item.path().string());
+            }
+        }
+    }
+
+    // Czynniki dla skrótu i wymiaru albo nullptr; wynik utrzymuje odwzorowanie przy życiu
+    std::shared_ptr<const MappedFactors> find(std::uint64_t key, std::size_t n) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it == entries_.end()) {
+            // Plik mógł zapisać inny proces serwera współdzielący katalog
+            it = index_file_locked(path_of(key));
+        }
+        if (it == entries_.end() || it->second.n != n) {
+            ++misses_;
+            return nullptr;
+        }
+        Entry &entry = it->second;
+        if (!entry.mapped) {
+            try {
+                entry.mapped = std::make_shared<const MappedFactors>(entry.path);
+            } catch (const std::exception &) {
+                drop_locked(it);
+                ++misses_;
+                return nullptr;
+            }
+        }
+        entry.last_use = ++clock_;
+        ++hits_;
+        return entry.mapped;
+    }
+
+    Precision precision() const { return precision_; }
+
+    // Zapis przez plik tymczasowy i rename, więc czytelnicy nigdy nie widzą niepełnego pliku
+    void save(std::uint64_t key, const LuFactors &factors) { save(key, factors, precision_); }
+
+    void save(std::uint64_t key, const LuFactors &factors, Precision precision) {
+        const std::size_t n = factors.n;
+        const std::string path = path_of(key);
+        const std::string temp = path + ".tmp." + std::to_string(getpid());
+
+        const int fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd == -1) {
+            throw std::runtime_error(detail::errno_message(("create " + temp + " failed").c_str()));
+        }
+        FileHeader header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.key = key;
+        header.n = n;
+        header.element_bytes = static_cast<std::uint64_t>(precision);
+        std::vector<float> narrowed;
+        const void *lu = factors.lu.data();
+        if (precision == Precision::single) {
+            narrowed.assign(factors.lu.begin(), factors.lu.end());
+            lu = narrowed.data();
+        }
+        const bool ok = detail::fd_write_full(fd, &header, sizeof(header)) &&
+                        detail::fd_write_full(fd, lu, n * n * static_cast<std::size_t>(precision)) &&
+                        detail::fd_write_full(fd, factors.pivots.data(), n * sizeof(std::uint32_t)) &&
+                        fsync(fd) == 0;
+        close(fd);
+        if (!ok || std::rename(temp.c_str(), path.c_str()) != 0) {
+            const std::string message = detail::errno_message(("write " + path + " failed").c_str());
+            std::remove(temp.c_str());
+            throw std::runtime_error(message);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            bytes_ -= it->second.bytes;
+        }
+        Entry entry;
+        entry.path = path;
+        entry.n = n;
+        entry.bytes = file_bytes(n, precision);
+        entry.last_use = ++clock_;
+        bytes_ += entry.bytes;
+        entries_[key] = std::move(entry);
+        ++writes_;
+        evict_locked(key);
+    }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Stats result;
+        result.entries = entries_.size();
+        for (const auto &[key, entry] : entries_) {
+            result.mapped += entry.mapped ? 1 : 0;
+        }
+        result.hits = hits_;
+        result.misses = misses_;
+        result.writes = writes_;
+        result.bytes = bytes_;
+        return result;
+    }
+
+private:
+    struct Entry {
+        std::string path;
+        std::size_t n{};
+        std::size_t bytes{};
+        std::uint64_t last_use{};
+        std::shared_ptr<const MappedFactors> mapped;
+    };
+
+    std::string path_of(std::uint64_t key) const { return directory_ + "/" + key_name(key) + ".lu"; }
+
+    std::map<std::uint64_t, Entry>::iterator index_file_locked(const std::string &path) {
+        FileHeader header{};
+        if (!read_header(path, header)) {
+            return entries_.end();
+        }
+        auto it = entries_.find(header.key);
+        if (it != entries_.end()) {
+            return it;
+        }
+        Entry entry;
+        entry.path = path;
+        entry.n = header.n;
+        entry.bytes = file_bytes(header.n, precision_of(header));
+        entry.last_use = ++clock_;
+        bytes_ += entry.bytes;
+        return entries_.emplace(header.key, std::move(entry)).first;
+    }
+
+    static bool read_header(const std::string &path, FileHeader &header) {
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            return false;
+        }
+        struct stat info {};
+        const bool ok = fstat(fd, &info) == 0 && detail::fd_read_full(fd, &header, sizeof(header)) &&
+                        std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 && header.version == kVersion &&
+                        valid_element_bytes(header.element_bytes) &&
+                        static_cast<std::size_t>(info.st_size) == file_bytes(header.n, precision_of(header));
+        close(fd);
+        return ok;
+    }
+
+    void drop_locked(std::map<std::uint64_t, Entry>::iterator it) {
+        bytes_ -= it->second.bytes;
+        std::remove(it->second.path.c_str());
+        entries_.erase(it);
+    }
+
+    // Usuwa najdawniej używane pliki ponad limit (0 = bez limitu); trwające odwzorowania pozostają ważne
+    void evict_locked(std::uint64_t keep) {
+        while (max_bytes_ != 0 && bytes_ > max_bytes_ && entries_.size() > 1) {
+            auto oldest = entries_.end();
+            for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+                if (it->first != keep && (oldest == entries_.end() || it->second.last_use < oldest->second.last_use)) {
+                    oldest = it;
+                }
+            }
+            if (oldest == entries_.end()) {
+                return;
+            }
+            drop_locked(oldest);
+        }
+    }
+
+    std::string directory_;
+    std::size_t max_bytes_;
+    Precision precision_;
+    mutable std::mutex mutex_;
+    std::map<std::uint64_t, Entry> entries_;
+    std::size_t bytes_{0};
+    std::uint64_t clock_{0};
+    std::uint64_t hits_{0};
+    std::uint64_t misses_{0};
+    std::uint64_t writes_{0};
+};
+
+} // namespace store
@@ -0,0 +1,216 @@
+#pragma once
+
+#include "async_pipeline.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace sched {
+
+// Szacowany koszt eliminacji Gaussa dla układu n x n (liczba operacji zmiennoprzecinkowych)
+inline double estimate_flops(std::size_t n) {
+    const double size = static_cast<double>(n);
+    return 2.0 / 3.0 * size * size * size + 2.0 * size * size;
+}
+
+struct TenantPolicy {
+    double weight{1.0};
+    std::size_t max_running{0}; // 0 = bez limitu
+};
+
+// Parsuje "nazwa=waga[,limit]" z linii poleceń serwera
+inline std::pair<std::string, TenantPolicy> parse_tenant_policy(const std::string &spec) {
+    const auto eq = spec.find('=');
+    if (eq == std::string::npos || eq == 0) {
+        throw std::invalid_argument("Tenant policy must look like name=weight[,cap]: " + spec);
+    }
+    TenantPolicy policy;
+    std::istringstream iss(spec.substr(eq + 1));
+    char comma = 0;
+    if (!(iss >> policy.weight) || policy.weight <= 0.0) {
+        throw std::invalid_argument("Tenant weight must be positive: " + spec);
+    }
+    if (iss >> comma) {
+        if (comma != ',' || !(iss >> policy.max_running)) {
+            throw std::invalid_argument("Tenant cap must follow a comma: " + spec);
+        }
+    }
+    return {spec.substr(0, eq), policy};
+}
+
+// Ważone sprawiedliwe kolejkowanie (WFQ) żądań według kosztu w flopach, z limitem równoległości na tenanta.
+// Przydzielone korutyny są wznawiane w puli obliczeniowej; po obliczeniach trzeba wywołać release().
+// Nazwy tenantów wybiera klient, więc powyżej kMaxTenants bezczynni tenanci bez polityki są usuwani.
+class FairScheduler {
+public:
+    static constexpr std::size_t kMaxTenants = 1024;
+
+    FairScheduler(async::ComputePool &pool, TenantPolicy default_policy = {})
+        : pool_(pool), default_policy_(default_policy) {}
+
+    void set_policy(const std::string &tenant, TenantPolicy policy) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Tenant &state = tenant_locked(tenant);
+        state.policy = policy;
+        state.configured = true;
+    }
+
+    auto admit(std::string tenant, double flops) {
+        struct Awaiter {
+            FairScheduler &scheduler;
+            std::string tenant;
+            double flops;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { scheduler.enqueue(tenant, flops, handle); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{*this, std::move(tenant), flops};
+    }
+
+    void release(const std::string &tenant, double flops, std::chrono::milliseconds service) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Tenant &state = tenant_locked(tenant);
+        --state.running;
+        --running_;
+        ++state.completed;
+        state.served_flops += flops;
+        state.service_ms += static_cast<std::uint64_t>(service.count());
+        dispatch_locked();
+    }
+
+    // Koszt pracy wykonanej za tenanta w cudzym slocie (np. jego prawa strona w bloku innego żądania):
+    // przesuwa znacznik zakończenia jak admit(), ale bez kolejkowania
+    void charge(const std::string &tenant, double flops) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Tenant &state = tenant_locked(tenant);
+        state.last_finish = std::max(virtual_time_, state.last_finish) + flops / state.policy.weight;
+        ++state.submitted;
+        ++state.completed;
+        state.served_flops += flops;
+    }
+
+    std::string report() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::ostringstream oss;
+        oss << "scheduler_virtual_time " << virtual_time_ << "\n";
+        oss << "scheduler_tenants " << tenants_.size() << " evicted=" << evicted_ << "\n";
+        for (const auto &[name, state] : tenants_) {
+            oss << "tenant name=" << name << " weight=" << state.policy.weight
+                << " cap=" << state.policy.max_running << " queued=" << state.queue.size()
+                << " running=" << state.running << " submitted=" << state.submitted
+                << " completed=" << state.completed << " served_gflop=" << state.served_flops / 1e9
+                << " wait_ms_total=" << state.wait_ms << " service_ms_total=" << state.service_ms << "\n";
+        }
+        return oss.str();
+    }
+
+private:
+    struct Job {
+        double start_tag;
+        double finish_tag;
+        std::chrono::steady_clock::time_point enqueued;
+        std::coroutine_handle<> handle;
+    };
+
+    struct Tenant {
+        TenantPolicy policy;
+        bool configured{false}; // polityka z --tenant; taki tenant nie jest usuwany
+        double last_finish{0.0};
+        std::deque<Job> queue;
+        std::size_t running{0};
+        std::uint64_t submitted{0};
+        std::uint64_t completed{0};
+        double served_flops{0.0};
+        std::uint64_t wait_ms{0};
+        std::uint64_t service_ms{0};
+    };
+
+    Tenant &tenant_locked(const std::string &name) {
+        auto it = tenants_.find(name);
+        if (it == tenants_.end()) {
+            if (tenants_.size() >= kMaxTenants) {
+                evict_idle_locked();
+            }
+            it = tenants_.emplace(name, Tenant{}).first;
+            it->second.policy = default_policy_;
+        }
+        return it->second;
+    }
+
+    // Bezczynny tenant wraca z czystym znacznikiem zakończenia, tak jak po długiej przerwie w WFQ
+    void evict_idle_locked() {
+        for (auto it = tenants_.begin(); it != tenants_.end();) {
+            if (!it->second.configured && it->second.queue.empty() && it->second.running == 0) {
+                it = tenants_.erase(it);
+                ++evicted_;
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void enqueue(const std::string &tenant, double flops, std::coroutine_handle<> handle) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Tenant &state = tenant_locked(tenant);
+        const double start = std::max(virtual_time_, state.last_finish);
+        const double finish = start + flops / state.policy.weight;
+        state.last_finish = finish;
+        state.queue.push_back(Job{start, finish, std::chrono::steady_clock::now(), handle});
+        ++state.submitted;
+        dispatch_locked();
+    }
+
+    // Wybiera zadanie o najmniejszym znaczniku zakończenia spośród tenantów poniżej limitu
+    void dispatch_locked() {
+        while (running_ < pool_.slots()) {
+            Tenant *best = nullptr;
+            double best_finish = std::numeric_limits<double>::infinity();
+            for (auto &[name, state] : tenants_) {
+                if (state.queue.empty()) {
+                    continue;
+                }
+                if (state.policy.max_running != 0 && state.running >= state.policy.max_running) {
+                    continue;
+                }
+                if (state.queue.front().finish_tag < best_finish) {
+                    best_finish = state.queue.front().finish_tag;
+                    best = &state;
+                }
+            }
+            if (best == nullptr) {
+                return;
+            }
+
+            Job job = best->queue.front();
+            best->queue.pop_front();
+            virtual_time_ = std::max(virtual_time_, job.start_tag);
+            ++best->running;
+            ++running_;
+            best->wait_ms += static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - job.enqueued)
+                    .count());
+            pool_.post(job.handle);
+        }
+    }
+
+    async::ComputePool &pool_;
+    TenantPolicy default_policy_;
+    mutable std::mutex mutex_;
+    std::map<std::string, Tenant> tenants_;
+    std::size_t running_{0};
+    double virtual_time_{0.0};
+    std::uint64_t evicted_{0};
+};
+
+} // namespace sched
@@ -1,12 +1,15 @@
 #pragma once
 
 #include "matrix.hpp"
+#include "probes.hpp"
 
 #include <algorithm>
 #include <cerrno>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <limits>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -34,6 +37,7 @@ struct WorkerTask {
     std::size_t column;
     std::size_t start_row;
     std::size_t end_row;
+    std::size_t columns; // kolumny [column, column + columns) jednym zadaniem (eliminacja bez wyboru, zob. rbt)
 };
 
 struct WorkerAck {
@@ -75,7 +79,98 @@ inline bool fd_read_full(int fd, void *buffer, std::size_t bytes) {
     return true;
 }
 
-[[noreturn]] inline void worker_loop(int read_fd, int write_fd, double *shared_data, std::size_t width) {
+// Mapa niezerowych kafelków kTile x kTile: 0 oznacza, że cały kafelek jest zerowy.
+// Bity są tylko ustawiane (wypełnienie), więc mapa pozostaje zachowawcza przez całą eliminację.
+constexpr std::size_t kTile = 64;
+
+inline std::size_t tile_count(std::size_t extent) {
+    return (extent + kTile - 1) / kTile;
+}
+
+inline void build_tile_map(const double *data, std::size_t rows, std::size_t width, std::uint8_t *tiles) {
+    const std::size_t tile_cols = tile_count(width);
+    std::fill(tiles, tiles + tile_count(rows) * tile_cols, std::uint8_t{0});
+    for (std::size_t row = 0; row < rows; ++row) {
+        std::uint8_t *row_tiles = &tiles[(row / kTile) * tile_cols];
+        const double *row_ptr = &data[row * width];
+        for (std::size_t kt = 0; kt < tile_cols; ++kt) {
+            if (row_tiles[kt]) {
+                continue;
+            }
+            const std::size_t k_end = std::min(width, (kt + 1) * kTile);
+            for (std::size_t k = kt * kTile; k < k_end; ++k) {
+                if (row_ptr[k] != 0.0) {
+                    row_tiles[kt] = 1;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Odejmuje wielokrotności wiersza `column` od wierszy [start_row, end_row), pomijając
+// kafelki z zerowymi mnożnikami i zerowe kafelki wiersza głównego
+inline void eliminate_rows(double *data, std::size_t width, std::size_t column, std::size_t start_row,
+                           std::size_t end_row, std::uint8_t *tiles) {
+    const std::size_t tile_cols = tile_count(width);
+    const std::size_t col_tile = column / kTile;
+    const double *pivot_row = &data[column * width];
+    const double pivot = pivot_row[column];
+    const std::uint8_t *pivot_tiles = &tiles[col_tile * tile_cols];
+
+    std::size_t row = start_row;
+    while (row < end_row) {
+        std::uint8_t *row_tiles = &tiles[(row / kTile) * tile_cols];
+        const std::size_t tile_end = std::min(end_row, (row / kTile + 1) * kTile);
+        if (!row_tiles[col_tile]) {
+            row = tile_end;
+            continue;
+        }
+
+        for (; row < tile_end; ++row) {
+            double *row_ptr = &data[row * width];
+            const double factor = row_ptr[column] / pivot;
+            if (factor == 0.0) {
+                continue;
+            }
+            // Mnożnik zostaje w miejscu wyeliminowanego elementu (część L faktoryzacji LU)
+            row_ptr[column] = factor;
+            // Sąsiednie niezerowe kafelki wiersza głównego przetwarzane jedną pętlą
+            for (std::size_t kt = col_tile; kt < tile_cols;) {
+                if (!pivot_tiles[kt]) {
+                    ++kt;
+                    continue;
+                }
+                const std::size_t run_begin = kt;
+                while (kt < tile_cols && pivot_tiles[kt]) {
+                    if (!row_tiles[kt]) {
+                        row_tiles[kt] = 1;
+                    }
+                    ++kt;
+                }
+                const std::size_t k_begin = std::max(column + 1, run_begin * kTile);
+                const std::size_t k_end = std::min(width, kt * kTile);
+                for (std::size_t k = k_begin; k < k_end; ++k) {
+                    row_ptr[k] -= factor * pivot_row[k];
+                }
+            }
+        }
+    }
+}
+
+// Eliminacja kolumn [first, first + count) w wierszach [start_row, end_row) wiersz po wierszu: wiersz zostaje
+// w pamięci podręcznej na cały panel, a wiersze główne panelu muszą być już wyeliminowane
+inline void eliminate_panel(double *data, std::size_t width, std::size_t first, std::size_t count,
+                            std::size_t start_row, std::size_t end_row, std::uint8_t *tiles) {
+    for (std::size_t row = start_row; row < end_row; ++row) {
+        for (std::size_t column = first; column < first + count; ++column) {
+            eliminate_rows(data, width, column, row, row + 1, tiles);
+        }
+    }
+}
+
+[[noreturn]] inline void worker_loop(int read_fd, int write_fd, double *shared_data, std::size_t width,
+                                     std::uint8_t *tiles) {
     for (;;) {
         WorkerTask task{};
         if (!fd_read_full(read_fd, &task, sizeof(task))) {
@@ -88,17 +183,13 @@ inline bool fd_read_full(int fd, void *buffer, std::size_t bytes) {
             _exit(0);
         }
 
-        if (task.start_row < task.end_row) {
-            const double pivot = shared_data[task.column * width + task.column];
-            const double *pivot_row = &shared_data[task.column * width];
-            for (std::size_t row = task.start_row; row < task.end_row; ++row) {
-                double *row_ptr = &shared_data[row * width];
-                const double factor = row_ptr[task.column] / pivot;
-                for (std::size_t k = task.column; k < width; ++k) {
-                    row_ptr[k] -= factor * pivot_row[k];
-                }
-            }
+        GAUS_PROBE3(worker__task__start, task.column, task.start_row, task.end_row);
+        if (task.start_row < task.end_row && task.columns > 1) {
+            eliminate_panel(shared_data, width, task.column, task.columns, task.start_row, task.end_row, tiles);
+        } else if (task.start_row < task.end_row) {
+            eliminate_rows(shared_data, width, task.column, task.start_row, task.end_row, tiles);
         }
+        GAUS_PROBE3(worker__task__end, task.column, task.start_row, task.end_row);
 
         WorkerAck ack{0};
         if (!fd_write_full(write_fd, &ack, sizeof(ack))) {
@@ -120,23 +211,22 @@ inline std::vector<double> gaussian_sequential(const CppMatrix &augmented) {
     const std::size_t width = augmented.cols;
     constexpr double kEpsilon = 1e-12;
 
-    std::vector<double> data = augmented.data;
+    auto data = augmented.data;
     auto at = [width, &data](std::size_t r, std::size_t c) -> double & {
         return data[r * width + c];
     };
 
+    std::vector<std::uint8_t, memory::TrackingAllocator<std::uint8_t>> tiles(detail::tile_count(n) *
+                                                                             detail::tile_count(width));
+    detail::build_tile_map(data.data(), n, width, tiles.data());
+
     for (std::size_t col = 0; col < n; ++col) {
         const double pivot = at(col, col);
         if (std::fabs(pivot) < kEpsilon) {
             throw std::runtime_error("Matrix is singular or ill-conditioned");
         }
 
-        for (std::size_t row = col + 1; row < n; ++row) {
-            const double factor = at(row, col) / pivot;
-            for (std::size_t k = col; k < width; ++k) {
-                at(row, k) -= factor * at(col, k);
-            }
-        }
+        detail::eliminate_rows(data.data(), width, col, col + 1, n, tiles.data());
     }
 
     std::vector<double> solution(n, 0.0);
@@ -157,59 +247,191 @@ inline std::vector<double> gaussian_sequential(const CppMatrix &augmented) {
     return solution;
 }
 
-// Równoległa wersja eliminacji Gaussa z użyciem fork() i współdzielonej pamięci
-inline std::vector<double> gaussian_parallel(const CppMatrix &augmented, std::size_t max_processes = 0) {
-    detail::validate_augmented(augmented);
+namespace detail {
 
-    const std::size_t n = augmented.rows;
-    if (n < 2) {
-        return gaussian_sequential(augmented);
+// Współdzielona (MAP_SHARED) przestrzeń robocza: macierz rows x width oraz mapa kafelków
+class SharedWorkspace {
+public:
+    SharedWorkspace(std::size_t rows, std::size_t width)
+        : rows_(rows), width_(width), matrix_bytes_(rows * width * sizeof(double)),
+          bytes_(matrix_bytes_ + tile_count(rows) * tile_count(width)), charge_(bytes_) {
+        void *ptr = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) {
+            throw std::runtime_error("mmap failed: " + std::string(std::strerror(errno)));
+        }
+        data_ = static_cast<double *>(ptr);
     }
 
-    const std::size_t width = augmented.cols;
-    const std::size_t total_elements = n * width;
-    const std::size_t total_bytes = total_elements * sizeof(double);
+    ~SharedWorkspace() { munmap(data_, bytes_); }
+
+    SharedWorkspace(const SharedWorkspace &) = delete;
+    SharedWorkspace &operator=(const SharedWorkspace &) = delete;
+
+    double *data() const { return data_; }
+    std::uint8_t *tiles() const { return reinterpret_cast<std::uint8_t *>(data_) + matrix_bytes_; }
+    std::size_t rows() const { return rows_; }
+    std::size_t width() const { return width_; }
+
+    void build_tiles() { build_tile_map(data_, rows_, width_, tiles()); }
+
+    // Zamiana wierszy wraz z zachowawczym scaleniem wierszy mapy kafelków
+    void swap_rows(std::size_t a, std::size_t b) {
+        std::swap_ranges(&data_[a * width_], &data_[a * width_] + width_, &data_[b * width_]);
+        const std::size_t tile_cols = tile_count(width_);
+        std::uint8_t *tiles_a = &tiles()[(a / kTile) * tile_cols];
+        std::uint8_t *tiles_b = &tiles()[(b / kTile) * tile_cols];
+        for (std::size_t kt = 0; kt < tile_cols; ++kt) {
+            tiles_a[kt] = tiles_b[kt] = static_cast<std::uint8_t>(tiles_a[kt] | tiles_b[kt]);
+        }
+    }
 
-    double *shared_data = static_cast<double *>(mmap(nullptr, total_bytes, PROT_READ | PROT_WRITE,
-                                                     MAP_SHARED | MAP_ANONYMOUS, -1, 0));
-    if (shared_data == MAP_FAILED) {
-        throw std::runtime_error("mmap failed: " + std::string(std::strerror(errno)));
+private:
+    std::size_t rows_;
+    std::size_t width_;
+    std::size_t matrix_bytes_;
+    std::size_t bytes_;
+    memory::ScopedCharge charge_;
+    double *data_{nullptr};
+};
+
+// Procesy potomne (fork) eliminujące kolejne kolumny w przestrzeni roboczej; komunikacja przez potoki
+class WorkerProcessPool {
+public:
+    WorkerProcessPool(SharedWorkspace &workspace, std::size_t max_processes) : workspace_(workspace) {
+        const std::size_t n = workspace.rows();
+        const long cpu_available = sysconf(_SC_NPROCESSORS_ONLN);
+        std::size_t process_budget = max_processes > 0
+                                         ? max_processes
+                                         : static_cast<std::size_t>(cpu_available > 0 ? cpu_available : 1);
+        process_budget = std::max<std::size_t>(1, std::min(process_budget, n > 1 ? n - 1 : 1));
+
+        workers_.reserve(process_budget);
+        for (std::size_t i = 0; i < process_budget; ++i) {
+            spawn_worker();
+        }
     }
 
-    struct SharedMatrixGuard {
-        double *ptr;
-        std::size_t bytes;
-        ~SharedMatrixGuard() {
-            if (ptr && ptr != MAP_FAILED) {
-                munmap(ptr, bytes);
+    // Ścieżka błędu: zamknięcie potoków kończy workery, które są następnie zbierane (bez procesów zombie)
+    ~WorkerProcessPool() {
+        for (auto &worker : workers_) {
+            close_fd(worker.write_fd);
+            close_fd(worker.read_fd);
+        }
+        for (const auto &worker : workers_) {
+            int status = 0;
+            while (waitpid(worker.pid, &status, 0) == -1 && errno == EINTR) {
             }
+            forget_child(worker.pid);
         }
-    } matrix_guard{shared_data, total_bytes};
+    }
 
-    std::copy(augmented.data.begin(), augmented.data.end(), shared_data);
+    WorkerProcessPool(const WorkerProcessPool &) = delete;
+    WorkerProcessPool &operator=(const WorkerProcessPool &) = delete;
+
+    // Eliminuje kolumnę `col` we wszystkich wierszach poniżej niej
+    void eliminate_column(std::size_t col) {
+        const std::size_t n = workspace_.rows();
+        const std::size_t remaining_rows = n - col - 1;
+        if (remaining_rows == 0) {
+            return;
+        }
+
+        const std::size_t active_workers = std::min(workers_.size(), remaining_rows);
+        const std::size_t chunk = (remaining_rows + active_workers - 1) / active_workers;
+
+        std::size_t assigned = 0;
+        for (; assigned < active_workers; ++assigned) {
+            const std::size_t start = col + 1 + assigned * chunk;
+            if (start >= n) {
+                break;
+            }
+            const std::size_t end = std::min(n, start + chunk);
+            send_task(assigned, WorkerCommand::Work, col, start, end);
+        }
+
+        for (std::size_t idx = 0; idx < assigned; ++idx) {
+            wait_ack(idx);
+        }
+    }
+
+    // Eliminuje kolumny [first, first + count) we wszystkich wierszach poniżej panelu jednym zadaniem na workera.
+    // Tylko bez wyboru elementu głównego: wiersze panelu są wtedy wierszami głównymi i muszą być już wyeliminowane.
+    void eliminate_columns(std::size_t first, std::size_t count) {
+        const std::size_t n = workspace_.rows();
+        const std::size_t begin = first + count;
+        if (begin >= n) {
+            return;
+        }
+
+        const std::size_t remaining_rows = n - begin;
+        const std::size_t active_workers = std::min(workers_.size(), remaining_rows);
+        const std::size_t chunk = (remaining_rows + active_workers - 1) / active_workers;
+
+        std::size_t assigned = 0;
+        for (; assigned < active_workers; ++assigned) {
+            const std::size_t start = begin + assigned * chunk;
+            if (start >= n) {
+                break;
+            }
+            send_task(assigned, WorkerCommand::Work, first, start, std::min(n, start + chunk), count);
+        }
+
+        for (std::size_t idx = 0; idx < assigned; ++idx) {
+            wait_ack(idx);
+        }
+    }
 
-    const long cpu_available = sysconf(_SC_NPROCESSORS_ONLN);
-    std::size_t process_budget = max_processes > 0
-                                     ? max_processes
-                                     : static_cast<std::size_t>(cpu_available > 0 ? cpu_available : 1);
-    process_budget = std::max<std::size_t>(1, std::min(process_budget, n - 1));
+    // Normalne zakończenie: polecenie Exit, potwierdzenia i kontrola statusu workerów
+    void shutdown() {
+        for (std::size_t idx = 0; idx < workers_.size(); ++idx) {
+            send_task(idx, WorkerCommand::Exit, 0, 0, 0);
+        }
 
+        for (std::size_t idx = 0; idx < workers_.size(); ++idx) {
+            wait_ack(idx);
+        }
+
+        std::vector<WorkerProcess> workers;
+        workers.swap(workers_);
+        bool abnormal = false;
+        for (auto &worker : workers) {
+            int status = 0;
+            while (waitpid(worker.pid, &status, 0) == -1) {
+                if (errno != EINTR) {
+                    throw std::runtime_error(errno_message("waitpid failed"));
+                }
+            }
+            forget_child(worker.pid);
+            abnormal = abnormal || !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+            close_fd(worker.write_fd);
+            close_fd(worker.read_fd);
+        }
+        if (abnormal) {
+            throw std::runtime_error("worker exited abnormally");
+        }
+    }
+
+private:
     struct WorkerProcess {
         pid_t pid{-1};
         int write_fd{-1};
         int read_fd{-1};
     };
 
-    auto close_fd = [](int fd) {
+    static void close_fd(int &fd) {
         if (fd >= 0) {
             close(fd);
+            fd = -1;
         }
-    };
+    }
 
-    std::vector<WorkerProcess> workers;
-    workers.reserve(process_budget);
+    static void forget_child(pid_t pid) {
+        if (const auto &ledger = memory::current_ledger()) {
+            ledger->remove_child(pid);
+        }
+    }
 
-    auto spawn_worker = [&]() {
+    void spawn_worker() {
         int to_child[2]{-1, -1};
         int to_parent[2]{-1, -1};
         if (pipe(to_child) == -1 || pipe(to_parent) == -1) {
@@ -217,7 +439,7 @@ inline std::vector<double> gaussian_parallel(const CppMatrix &augmented, std::si
             if (to_child[1] != -1) close(to_child[1]);
             if (to_parent[0] != -1) close(to_parent[0]);
             if (to_parent[1] != -1) close(to_parent[1]);
-            throw std::runtime_error(detail::errno_message("pipe failed"));
+            throw std::runtime_error(errno_message("pipe failed"));
         }
 
         const pid_t pid = fork();
@@ -226,113 +448,346 @@ inline std::vector<double> gaussian_parallel(const CppMatrix &augmented, std::si
             close(to_child[1]);
             close(to_parent[0]);
             close(to_parent[1]);
-            throw std::runtime_error(detail::errno_message("fork failed"));
+            throw std::runtime_error(errno_message("fork failed"));
         }
 
         if (pid == 0) {
             close(to_child[1]);
             close(to_parent[0]);
-            detail::worker_loop(to_child[0], to_parent[1], shared_data, width);
+            worker_loop(to_child[0], to_parent[1], workspace_.data(), workspace_.width(), workspace_.tiles());
         }
 
         close(to_child[0]);
         close(to_parent[1]);
-        workers.push_back(WorkerProcess{pid, to_child[1], to_parent[0]});
-    };
-
-    for (std::size_t i = 0; i < process_budget; ++i) {
-        spawn_worker();
+        workers_.push_back(WorkerProcess{pid, to_child[1], to_parent[0]});
+        if (const auto &ledger = memory::current_ledger()) {
+            ledger->add_child(pid);
+        }
     }
 
-    constexpr double kEpsilon = 1e-12;
-
-    auto send_task = [&](std::size_t worker_index, detail::WorkerCommand command, std::size_t column,
-                         std::size_t start, std::size_t end) {
-        detail::WorkerTask task{};
+    void send_task(std::size_t worker_index, WorkerCommand command, std::size_t column, std::size_t start,
+                   std::size_t end, std::size_t columns = 1) {
+        WorkerTask task{};
         task.command = static_cast<std::size_t>(command);
         task.column = column;
         task.start_row = start;
         task.end_row = end;
-        if (!detail::fd_write_full(workers[worker_index].write_fd, &task, sizeof(task))) {
-            throw std::runtime_error(detail::errno_message("write to worker failed"));
+        task.columns = columns;
+        if (!fd_write_full(workers_[worker_index].write_fd, &task, sizeof(task))) {
+            throw std::runtime_error(errno_message("write to worker failed"));
         }
-    };
+    }
 
-    auto wait_ack = [&](std::size_t worker_index) {
-        detail::WorkerAck ack{};
-        if (!detail::fd_read_full(workers[worker_index].read_fd, &ack, sizeof(ack))) {
-            throw std::runtime_error(detail::errno_message("read from worker failed"));
+    void wait_ack(std::size_t worker_index) {
+        WorkerAck ack{};
+        if (!fd_read_full(workers_[worker_index].read_fd, &ack, sizeof(ack))) {
+            throw std::runtime_error(errno_message("read from worker failed"));
         }
         if (ack.status != 0) {
             throw std::runtime_error("worker reported failure");
         }
-    };
+    }
+
+    SharedWorkspace &workspace_;
+    std::vector<WorkerProcess> workers_;
+};
+
+} // namespace detail
+
+// Równoległa wersja eliminacji Gaussa z użyciem fork() i współdzielonej pamięci
+inline std::vector<double> gaussian_parallel(const CppMatrix &augmented, std::size_t max_processes = 0) {
+    detail::validate_augmented(augmented);
+
+    const std::size_t n = augmented.rows;
+    if (n < 2) {
+        return gaussian_sequential(augmented);
+    }
 
+    const std::size_t width = augmented.cols;
+    detail::SharedWorkspace workspace(n, width);
+    double *shared_data = workspace.data();
+    std::copy(augmented.data.begin(), augmented.data.end(), shared_data);
+    workspace.build_tiles();
+
+    detail::WorkerProcessPool workers(workspace, max_processes);
+
+    constexpr double kEpsilon = 1e-12;
     for (std::size_t col = 0; col < n; ++col) {
         const double pivot = shared_data[col * width + col];
         if (std::fabs(pivot) < kEpsilon) {
             throw std::runtime_error("Matrix is singular or ill-conditioned");
         }
 
-        const std::size_t remaining_rows = n - col - 1;
-        if (remaining_rows == 0) {
-            continue;
+        GAUS_PROBE2(column__start, col, n);
+        workers.eliminate_column(col);
+        GAUS_PROBE2(column__end, col, n);
+    }
+
+    workers.shutdown();
+
+    std::vector<double> solution(n, 0.0);
+    for (std::size_t i = n; i-- > 0;) {
+        double rhs = shared_data[i * width + (width - 1)];
+        for (std::size_t j = i + 1; j < n; ++j) {
+            rhs -= shared_data[i * width + j] * solution[j];
         }
 
-        const std::size_t active_workers = std::min(process_budget, remaining_rows);
-        const std::size_t chunk = (remaining_rows + active_workers - 1) / active_workers;
+        const double pivot = shared_data[i * width + i];
+        if (std::fabs(pivot) < kEpsilon) {
+            throw std::runtime_error("Matrix is singular or ill-conditioned");
+        }
 
-        std::size_t assigned = 0;
-        for (; assigned < active_workers; ++assigned) {
-            const std::size_t start = col + 1 + assigned * chunk;
-            if (start >= n) {
-                break;
+        solution[i] = rhs / pivot;
+    }
+
+    return solution;
+}
+
+// Widok na czynniki LU (PA = LU, L z jedynkami na przekątnej zapisane pod przekątną).
+// Nie jest właścicielem danych - mogą pochodzić z pamięci lub z pliku odwzorowanego przez mmap.
+// T = float dla czynników przechowywanych w pojedynczej precyzji (zob. refine_solve).
+template <typename T>
+struct BasicLuView {
+    std::size_t n{};
+    const T *lu{};
+    const std::uint32_t *pivots{}; // pivots[k] = wiersz zamieniony z k w kroku k
+};
+
+using LuView = BasicLuView<double>;
+
+struct LuFactors {
+    std::size_t n{};
+    std::vector<double> lu;
+    std::vector<std::uint32_t> pivots;
+
+    LuView view() const { return LuView{n, lu.data(), pivots.data()}; }
+};
+
+// Faktoryzacja LU z częściowym wyborem elementu głównego części współczynników macierzy rozszerzonej.
+// Wybór i zamiana wierszy w procesie nadrzędnym, eliminacja w workerach jak w gaussian_parallel.
+inline LuFactors lu_factor(const CppMatrix &augmented, std::size_t max_processes = 0) {
+    detail::validate_augmented(augmented);
+    const std::size_t n = augmented.rows;
+    constexpr double kEpsilon = 1e-12;
+
+    detail::SharedWorkspace workspace(n, n);
+    double *shared_data = workspace.data();
+    for (std::size_t r = 0; r < n; ++r) {
+        std::copy_n(&augmented.data[r * augmented.cols], n, &shared_data[r * n]);
+    }
+    workspace.build_tiles();
+
+    LuFactors factors;
+    factors.n = n;
+    factors.pivots.resize(n);
+
+    detail::WorkerProcessPool workers(workspace, max_processes);
+    for (std::size_t col = 0; col < n; ++col) {
+        std::size_t best = col;
+        for (std::size_t row = col + 1; row < n; ++row) {
+            if (std::fabs(shared_data[row * n + col]) > std::fabs(shared_data[best * n + col])) {
+                best = row;
             }
-            const std::size_t end = std::min(n, start + chunk);
-            send_task(assigned, detail::WorkerCommand::Work, col, start, end);
+        }
+        if (std::fabs(shared_data[best * n + col]) < kEpsilon) {
+            throw std::runtime_error("Matrix is singular or ill-conditioned");
+        }
+        factors.pivots[col] = static_cast<std::uint32_t>(best);
+        if (best != col) {
+            workspace.swap_rows(col, best);
         }
 
-        for (std::size_t idx = 0; idx < assigned; ++idx) {
-            wait_ack(idx);
+        GAUS_PROBE2(column__start, col, n);
+        workers.eliminate_column(col);
+        GAUS_PROBE2(column__end, col, n);
+    }
+    workers.shutdown();
+
+    factors.lu.assign(shared_data, shared_data + n * n);
+    return factors;
+}
+
+// Rozwiązanie LUx = Pb w O(n^2); arytmetyka zawsze w double
+template <typename T>
+std::vector<double> lu_solve(const BasicLuView<T> &factors, const double *rhs) {
+    const std::size_t n = factors.n;
+    std::vector<double> x(rhs, rhs + n);
+    for (std::size_t k = 0; k < n; ++k) {
+        std::swap(x[k], x[factors.pivots[k]]);
+    }
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const T *row = &factors.lu[i * n];
+        double value = x[i];
+        for (std::size_t j = 0; j < i; ++j) {
+            value -= row[j] * x[j];
         }
+        x[i] = value;
     }
 
-    for (std::size_t idx = 0; idx < workers.size(); ++idx) {
-        send_task(idx, detail::WorkerCommand::Exit, 0, 0, 0);
+    for (std::size_t i = n; i-- > 0;) {
+        const T *row = &factors.lu[i * n];
+        double value = x[i];
+        for (std::size_t j = i + 1; j < n; ++j) {
+            value -= row[j] * x[j];
+        }
+        x[i] = value / row[i];
     }
+    return x;
+}
 
-    for (std::size_t idx = 0; idx < workers.size(); ++idx) {
-        wait_ack(idx);
+// LUX = PB dla k prawych stron naraz; blok n x k wierszami (wiersz i to i-te składowe wszystkich prawych stron).
+// Podstawienia idą kafelkami po kTile wierszy: kafelek wierszy X z już policzonej części zostaje w pamięci
+// podręcznej, a każdy element L i U jest czytany raz na cały blok zamiast raz na prawą stronę.
+inline void lu_solve_block(const LuView &factors, double *block, std::size_t k) {
+    constexpr std::size_t kTile = 64;
+    const std::size_t n = factors.n;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (factors.pivots[i] != i) {
+            std::swap_ranges(&block[i * k], &block[(i + 1) * k], &block[factors.pivots[i] * k]);
+        }
     }
 
-    for (const auto &worker : workers) {
-        int status = 0;
-        while (waitpid(worker.pid, &status, 0) == -1) {
-            if (errno != EINTR) {
-                throw std::runtime_error(detail::errno_message("waitpid failed"));
+    // x_i -= sum_j row[j] * x_j dla j z [first, last); cztery wiersze źródłowe na jeden przebieg po x_i
+    auto subtract = [&](std::size_t i, std::size_t first, std::size_t last) {
+        const double *row = &factors.lu[i * n];
+        double *__restrict target = &block[i * k];
+        std::size_t j = first;
+        for (; j + 4 <= last; j += 4) {
+            const double *__restrict s0 = &block[j * k];
+            const double *__restrict s1 = s0 + k;
+            const double *__restrict s2 = s1 + k;
+            const double *__restrict s3 = s2 + k;
+            const double f0 = row[j];
+            const double f1 = row[j + 1];
+            const double f2 = row[j + 2];
+            const double f3 = row[j + 3];
+            for (std::size_t c = 0; c < k; ++c) {
+                target[c] -= f0 * s0[c] + f1 * s1[c] + f2 * s2[c] + f3 * s3[c];
             }
         }
-        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
-            throw std::runtime_error("worker exited abnormally");
+        for (; j < last; ++j) {
+            const double *__restrict source = &block[j * k];
+            const double factor = row[j];
+            for (std::size_t c = 0; c < k; ++c) {
+                target[c] -= factor * source[c];
+            }
+        }
+    };
+
+    for (std::size_t i0 = 0; i0 < n; i0 += kTile) {
+        const std::size_t i1 = std::min(n, i0 + kTile);
+        for (std::size_t j0 = 0; j0 < i0; j0 += kTile) {
+            const std::size_t j1 = std::min(i0, j0 + kTile);
+            for (std::size_t i = i0; i < i1; ++i) {
+                subtract(i, j0, j1);
+            }
+        }
+        for (std::size_t i = i0; i < i1; ++i) {
+            subtract(i, i0, i);
         }
-        close_fd(worker.write_fd);
-        close_fd(worker.read_fd);
     }
 
-    std::vector<double> solution(n, 0.0);
-    for (std::size_t i = n; i-- > 0;) {
-        double rhs = shared_data[i * width + (width - 1)];
-        for (std::size_t j = i + 1; j < n; ++j) {
-            rhs -= shared_data[i * width + j] * solution[j];
+    for (std::size_t i1 = n; i1 > 0;) {
+        const std::size_t i0 = i1 > kTile ? i1 - kTile : 0;
+        for (std::size_t j0 = i1; j0 < n; j0 += kTile) {
+            const std::size_t j1 = std::min(n, j0 + kTile);
+            for (std::size_t i = i0; i < i1; ++i) {
+                subtract(i, j0, j1);
+            }
+        }
+        for (std::size_t i = i1; i-- > i0;) {
+            subtract(i, i + 1, i1);
+            const double inverse = 1.0 / factors.lu[i * n + i];
+            for (std::size_t c = 0; c < k; ++c) {
+                block[i * k + c] *= inverse;
+            }
         }
+        i1 = i0;
+    }
+}
 
-        const double pivot = shared_data[i * width + i];
-        if (std::fabs(pivot) < kEpsilon) {
-            throw std::runtime_error("Matrix is singular or ill-conditioned");
+// Prawa strona (ostatnia kolumna) macierzy rozszerzonej
+inline std::vector<double> augmented_rhs(const CppMatrix &augmented) {
+    std::vector<double> rhs(augmented.rows);
+    for (std::size_t r = 0; r < augmented.rows; ++r) {
+        rhs[r] = augmented(r, augmented.cols - 1);
+    }
+    return rhs;
+}
+
+// Reszta r = b - Ax macierzy rozszerzonej; zwraca skalowaną resztę ||r|| / (||A|| ||x|| + ||b||) w normie maksimum
+inline double residual_into(const CppMatrix &augmented, const std::vector<double> &x, std::vector<double> &residual) {
+    const std::size_t n = augmented.rows;
+    residual.resize(n);
+    double r_norm = 0.0;
+    double a_norm = 0.0;
+    double b_norm = 0.0;
+    double x_norm = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double *row = &augmented.data[i * augmented.cols];
+        double value = row[n];
+        double row_sum = 0.0;
+        for (std::size_t j = 0; j < n; ++j) {
+            value -= row[j] * x[j];
+            row_sum += std::fabs(row[j]);
         }
+        residual[i] = value;
+        r_norm = std::max(r_norm, std::fabs(value));
+        a_norm = std::max(a_norm, row_sum);
+        b_norm = std::max(b_norm, std::fabs(row[n]));
+        x_norm = std::max(x_norm, std::fabs(x[i]));
+    }
+    const double scale = a_norm * x_norm + b_norm;
+    return scale > 0.0 ? r_norm / scale : r_norm;
+}
 
-        solution[i] = rhs / pivot;
+// Skalowana reszta ||Ax - b|| / (||A|| ||x|| + ||b||) w normie maksimum
+inline double scaled_residual(const CppMatrix &augmented, const std::vector<double> &x) {
+    std::vector<double> residual;
+    return residual_into(augmented, x, residual);
+}
+
+struct Refinement {
+    double residual{};         // skalowana reszta zwróconego x
+    std::size_t corrections{}; // liczba wykonanych poprawek
+};
+
+// Iteracyjne poprawianie w podwójnej precyzji wspólne dla silników: `residual_of(x, r)` liczy r = b - Ax
+// z oryginalną macierzą i zwraca skalowaną resztę, `correct(r)` rozwiązuje równanie poprawki przybliżonymi
+// czynnikami. Kończy, gdy skalowana reszta spadnie do poziomu double, przestanie maleć co najmniej dwukrotnie
+// albo po `max_corrections` poprawkach.
+template <typename Residual, typename Correct>
+Refinement refine(std::vector<double> &x, std::size_t max_corrections, Residual &&residual_of, Correct &&correct) {
+    constexpr double kTarget = 1e-15;
+    std::vector<double> residual(x.size());
+    double previous = std::numeric_limits<double>::infinity();
+    Refinement result;
+    for (;; ++result.corrections) {
+        result.residual = residual_of(x, residual);
+        if (!(result.residual > kTarget) || result.residual > 0.5 * previous ||
+            result.corrections == max_corrections) {
+            return result;
+        }
+        previous = result.residual;
+        const std::vector<double> correction = correct(residual);
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            x[i] += correction[i];
+        }
     }
+}
 
-    return solution;
+// Poprawianie rozwiązania z czynników (np. float): czynniki rozwiązują tylko równania poprawek LU d = P(b - Ax),
+// a resztę liczy się z oryginalną macierzą; `iterations` to liczba wykonanych poprawek.
+template <typename T>
+std::vector<double> refine_solve(const CppMatrix &augmented, const BasicLuView<T> &factors,
+                                 std::size_t max_iterations, std::size_t &iterations) {
+    const std::vector<double> rhs = augmented_rhs(augmented);
+    std::vector<double> x = lu_solve(factors, rhs.data());
+    auto residual_of = [&](const std::vector<double> &current, std::vector<double> &residual) {
+        return residual_into(augmented, current, residual);
+    };
+    auto correct = [&](const std::vector<double> &residual) { return lu_solve(factors, residual.data()); };
+    iterations = refine(x, max_iterations, residual_of, correct).corrections;
+    return x;
 }
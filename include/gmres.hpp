@@ -0,0 +1,180 @@
+#pragma once
+
+#include "gaussian.hpp"
+#include "matrix.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace krylov {
+
+// GMRES(m) z prawostronnym prekondycjonowaniem: A M^{-1} u = b, x = M^{-1} u. M^{-1} to zwykle podstawienia LU
+// nieco innej macierzy (np. z poprzedniego kroku Newtona), więc każda iteracja kosztuje O(n^2) zamiast O(n^3).
+struct Options {
+    std::size_t restart{30};        // długość bazy Kryłowa przed restartem
+    std::size_t max_iterations{20}; // łącznie, po wszystkich restartach
+    double tolerance{1e-14};        // skalowana reszta ||b - Ax|| / (||A|| ||x|| + ||b||) jak w scaled_residual
+};
+
+struct Result {
+    std::vector<double> x;
+    std::size_t iterations{};
+    double residual{}; // skalowana reszta zwróconego x
+    bool converged{};
+};
+
+namespace detail {
+
+inline double dot(const std::vector<double> &a, const std::vector<double> &b) {
+    double sum = 0.0;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+inline double max_abs(const std::vector<double> &v) {
+    double value = 0.0;
+    for (double element : v) {
+        value = std::max(value, std::fabs(element));
+    }
+    return value;
+}
+
+// r = b - A x dla macierzy rozszerzonej wierszami; zwraca ||A||_inf
+inline double residual(const CppMatrix &augmented, const std::vector<double> &x, std::vector<double> &r) {
+    const std::size_t n = augmented.rows;
+    double a_norm = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double *row = &augmented.data[i * augmented.cols];
+        double value = row[n];
+        double row_sum = 0.0;
+        for (std::size_t j = 0; j < n; ++j) {
+            value -= row[j] * x[j];
+            row_sum += std::fabs(row[j]);
+        }
+        r[i] = value;
+        a_norm = std::max(a_norm, row_sum);
+    }
+    return a_norm;
+}
+
+inline void multiply(const CppMatrix &augmented, const std::vector<double> &x, std::vector<double> &y) {
+    const std::size_t n = augmented.rows;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double *row = &augmented.data[i * augmented.cols];
+        double value = 0.0;
+        for (std::size_t j = 0; j < n; ++j) {
+            value += row[j] * x[j];
+        }
+        y[i] = value;
+    }
+}
+
+} // namespace detail
+
+// Rozwiązanie [A | b] startujące od x0 = M^{-1} b. `precondition(v)` zwraca M^{-1} v jako std::vector<double>.
+// Zbieżność jest sprawdzana na prawdziwej reszcie po każdym cyklu; przy restarcie i na końcu x jest aktualizowane.
+template <typename Precondition>
+Result gmres(const CppMatrix &augmented, Precondition &&precondition, const Options &options = {}) {
+    ::detail::validate_augmented(augmented);
+    const std::size_t n = augmented.rows;
+    const std::vector<double> b = augmented_rhs(augmented);
+    const double b_norm = detail::max_abs(b);
+
+    Result result;
+    result.x = precondition(b.data());
+    std::vector<double> r(n);
+    std::vector<double> w(n);
+    const std::size_t restart = std::max<std::size_t>(1, options.restart);
+    for (;;) {
+        const double a_norm = detail::residual(augmented, result.x, r);
+        const double scale = a_norm * detail::max_abs(result.x) + b_norm;
+        const double target = options.tolerance * scale;
+        result.residual = scale > 0.0 ? detail::max_abs(r) / scale : detail::max_abs(r);
+        if (result.residual <= options.tolerance) {
+            result.converged = true;
+            return result;
+        }
+        if (result.iterations >= options.max_iterations) {
+            return result;
+        }
+
+        // Arnoldi z ortogonalizacją Grama-Schmidta (zmodyfikowaną) i obrotami Givensa na bieżąco
+        const std::size_t m = std::min(restart, options.max_iterations - result.iterations);
+        const double beta = std::sqrt(detail::dot(r, r));
+        std::vector<std::vector<double>> basis(m + 1, std::vector<double>(n));
+        std::vector<double> hessenberg((m + 1) * m, 0.0); // kolumnami: h(i, j) = hessenberg[j * (m + 1) + i]
+        std::vector<double> cs(m);
+        std::vector<double> sn(m);
+        std::vector<double> g(m + 1, 0.0);
+        for (std::size_t i = 0; i < n; ++i) {
+            basis[0][i] = r[i] / beta;
+        }
+        g[0] = beta;
+
+        std::size_t k = 0;
+        while (k < m) {
+            const std::vector<double> z = precondition(basis[k].data());
+            detail::multiply(augmented, z, w);
+            double *h = &hessenberg[k * (m + 1)];
+            for (std::size_t i = 0; i <= k; ++i) {
+                h[i] = detail::dot(w, basis[i]);
+                for (std::size_t e = 0; e < n; ++e) {
+                    w[e] -= h[i] * basis[i][e];
+                }
+            }
+            h[k + 1] = std::sqrt(detail::dot(w, w));
+            const bool breakdown = !(h[k + 1] > 0.0); // przestrzeń Kryłowa niezmiennicza: rozwiązanie dokładne
+            if (!breakdown) {
+                for (std::size_t e = 0; e < n; ++e) {
+                    basis[k + 1][e] = w[e] / h[k + 1];
+                }
+            }
+
+            for (std::size_t i = 0; i < k; ++i) {
+                const double upper = cs[i] * h[i] + sn[i] * h[i + 1];
+                h[i + 1] = -sn[i] * h[i] + cs[i] * h[i + 1];
+                h[i] = upper;
+            }
+            const double radius = std::hypot(h[k], h[k + 1]);
+            cs[k] = radius > 0.0 ? h[k] / radius : 1.0;
+            sn[k] = radius > 0.0 ? h[k + 1] / radius : 0.0;
+            h[k] = radius;
+            h[k + 1] = 0.0;
+            g[k + 1] = -sn[k] * g[k];
+            g[k] = cs[k] * g[k];
+            ++k;
+            ++result.iterations;
+            // |g[k]| to 2-norma reszty, nie mniejsza od normy maksimum, więc warunek jest ostrożny
+            if (std::fabs(g[k]) <= target || breakdown) {
+                break;
+            }
+        }
+
+        // y z trójkątnego H y = g, potem x += M^{-1} (V y)
+        std::vector<double> y(k);
+        for (std::size_t i = k; i-- > 0;) {
+            double value = g[i];
+            for (std::size_t j = i + 1; j < k; ++j) {
+                value -= hessenberg[j * (m + 1) + i] * y[j];
+            }
+            const double diagonal = hessenberg[i * (m + 1) + i];
+            y[i] = diagonal != 0.0 ? value / diagonal : 0.0;
+        }
+        std::fill(w.begin(), w.end(), 0.0);
+        for (std::size_t i = 0; i < k; ++i) {
+            for (std::size_t e = 0; e < n; ++e) {
+                w[e] += y[i] * basis[i][e];
+            }
+        }
+        const std::vector<double> correction = precondition(w.data());
+        for (std::size_t e = 0; e < n; ++e) {
+            result.x[e] += correction[e];
+        }
+    }
+}
+
+} // namespace krylov
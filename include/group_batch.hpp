@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace batch {
+
+template <typename Slot>
+struct Group {
+    std::chrono::steady_clock::time_point opened;
+    std::vector<std::pair<Slot *, std::coroutine_handle<>>> members;
+};
+
+// Pola wspólne slotów łączonych w grupy; konkretny slot dziedziczy po GroupSlot<Slot> i dodaje swoje dane
+template <typename Slot>
+struct GroupSlot {
+    std::size_t width{0}; // liczba slotów w grupie, w której slot został rozwiązany
+    bool solved{false};
+    std::string error; // błąd rozwiązania grupy; slot pozostaje nierozwiązany
+    std::shared_ptr<Group<Slot>> group;
+};
+
+// Łączy żądania o tym samym kluczu w grupę rozwiązywaną jednym wywołaniem. Pierwsze żądanie otwiera grupę
+// i zostaje liderem: czeka do deadline() i w kolejce harmonogramu, a żądania z tym samym kluczem, które
+// przyjdą w tym czasie, dołączają do grupy i są zawieszane. Lider rozwiązuje całą grupę i wznawia pozostałych.
+template <typename Key, typename Slot>
+class GroupBatcher {
+public:
+    struct Stats {
+        std::uint64_t batches{};
+        std::uint64_t members{};
+        std::size_t widest{};
+    };
+
+    GroupBatcher(std::size_t max_width, std::chrono::microseconds hold)
+        : max_width_(std::max<std::size_t>(1, max_width)), hold_(hold) {}
+
+    // `co_await join(...)` zwraca true dla lidera (od razu), false dla członka wznowionego po rozwiązaniu
+    auto join(const Key &key, Slot &slot) {
+        struct Awaiter {
+            GroupBatcher &batcher;
+            Key key;
+            Slot &slot;
+            bool leader{false};
+            bool await_ready() const noexcept { return false; }
+            bool await_suspend(std::coroutine_handle<> handle) {
+                // Członka może wznowić lider z innego wątku zaraz po enqueue: potem nie wolno dotykać ramki
+                if (batcher.enqueue(key, slot, handle)) {
+                    leader = true;
+                    return false;
+                }
+                return true;
+            }
+            bool await_resume() const noexcept { return leader; }
+        };
+        return Awaiter{*this, key, slot};
+    }
+
+    // Chwila, do której lider przytrzymuje otwartą grupę przed wejściem do harmonogramu
+    std::chrono::steady_clock::time_point deadline(const Slot &leader) const { return leader.group->opened + hold_; }
+
+    // Wywoływane przez lidera w slocie obliczeniowym: zamyka grupę, wywołuje `solve(slots, k)` i przekazuje
+    // pozostałe korutyny do `resume`. Wyjątek z `solve` trafia do `error` każdego slotu; członkowie są
+    // wznawiani zawsze.
+    template <typename Solve, typename Resume>
+    void solve_group(const Key &key, Slot &leader, Solve &&solve, Resume &&resume) {
+        std::shared_ptr<Group<Slot>> group = std::move(leader.group);
+        std::vector<std::pair<Slot *, std::coroutine_handle<>>> members;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = open_.find(key);
+            if (it != open_.end() && it->second == group) {
+                open_.erase(it);
+            }
+            members.swap(group->members);
+        }
+
+        const std::size_t k = members.size();
+        std::vector<Slot *> slots(k);
+        for (std::size_t s = 0; s < k; ++s) {
+            slots[s] = members[s].first;
+        }
+        try {
+            solve(slots.data(), k);
+            for (Slot *slot : slots) {
+                slot->solved = true;
+            }
+        } catch (const std::exception &e) {
+            for (Slot *slot : slots) {
+                slot->error = e.what();
+            }
+        }
+        for (Slot *slot : slots) {
+            slot->width = k;
+            slot->group.reset();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++stats_.batches;
+            stats_.members += k;
+            stats_.widest = std::max(stats_.widest, k);
+        }
+
+        for (auto &[slot, handle] : members) {
+            if (handle) {
+                resume(handle);
+            }
+        }
+    }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+private:
+    // true: slot otworzył nową grupę (lider); false: dołączył do otwartej
+    bool enqueue(const Key &key, Slot &slot, std::coroutine_handle<> handle) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::shared_ptr<Group<Slot>> &group = open_[key];
+        if (!group || group->members.size() >= max_width_) {
+            group = std::make_shared<Group<Slot>>();
+            group->opened = std::chrono::steady_clock::now();
+            group->members.emplace_back(&slot, std::coroutine_handle<>{});
+            slot.group = group;
+            return true;
+        }
+        group->members.emplace_back(&slot, handle);
+        slot.group = group;
+        return false;
+    }
+
+    std::size_t max_width_;
+    std::chrono::microseconds hold_;
+    mutable std::mutex mutex_;
+    std::map<Key, std::shared_ptr<Group<Slot>>> open_;
+    Stats stats_;
+};
+
+} // namespace batch
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "gaussian.hpp"
+#include "matrix.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Opcjonalny backend LAPACK (np. OpenBLAS, MKL, reference LAPACK): kompilacja z -DGAUS_WITH_LAPACK
+// i linkowanie z -llapack (zob. LAPACK=1 ./compile.sh). Bez tego makra funkcje zgłaszają błąd,
+// a serwer używa silników z gaussian.hpp.
+
+#if defined(GAUS_WITH_LAPACK)
+// Interfejs Fortran (LP64): argumenty przez wskaźnik, ukryte długości argumentów znakowych na końcu
+extern "C" {
+void dgetrf_(const int *m, const int *n, double *a, const int *lda, int *ipiv, int *info);
+void dgetrs_(const char *trans, const int *n, const int *nrhs, const double *a, const int *lda, const int *ipiv,
+             double *b, const int *ldb, int *info, std::size_t trans_len);
+void dpotrf_(const char *uplo, const int *n, double *a, const int *lda, int *info, std::size_t uplo_len);
+void dpotrs_(const char *uplo, const int *n, const int *nrhs, const double *a, const int *lda, double *b,
+             const int *ldb, int *info, std::size_t uplo_len);
+}
+#endif
+
+namespace lapack {
+
+#if defined(GAUS_WITH_LAPACK)
+constexpr bool kAvailable = true;
+#else
+constexpr bool kAvailable = false;
+#endif
+
+namespace detail {
+
+using Buffer = std::vector<double, memory::TrackingAllocator<double>>;
+
+// Próg osobliwości jak w gaussian_parallel i lu_factor, żeby silniki zgłaszały te same macierze
+constexpr double kEpsilon = 1e-12;
+
+inline int checked_dimension(std::size_t n) {
+    if (n == 0 || n > static_cast<std::size_t>(INT_MAX)) {
+        throw std::invalid_argument("Matrix dimension is outside of the LAPACK integer range");
+    }
+    return static_cast<int>(n);
+}
+
+inline void require_available() {
+    if (!kAvailable) {
+        throw std::runtime_error("LAPACK backend is not compiled in (build with LAPACK=1 ./compile.sh)");
+    }
+}
+
+// Część współczynników macierzy rozszerzonej wierszami (n x n) i prawa strona osobno
+inline Buffer coefficients(const CppMatrix &augmented) {
+    const std::size_t n = augmented.rows;
+    Buffer a(n * n);
+    for (std::size_t r = 0; r < n; ++r) {
+        std::copy_n(&augmented.data[r * augmented.cols], n, &a[r * n]);
+    }
+    return a;
+}
+
+inline void getrf(int n, double *a, int *ipiv) {
+    int info = 0;
+#if defined(GAUS_WITH_LAPACK)
+    dgetrf_(&n, &n, a, &n, ipiv, &info);
+#else
+    (void)n, (void)a, (void)ipiv;
+    require_available();
+#endif
+    if (info < 0) {
+        throw std::runtime_error("dgetrf: invalid argument " + std::to_string(-info));
+    }
+    for (int k = 0; k < n; ++k) {
+        if (std::fabs(a[static_cast<std::size_t>(k) * n + k]) < kEpsilon) {
+            throw std::runtime_error("Matrix is singular or ill-conditioned");
+        }
+    }
+}
+
+} // namespace detail
+
+// A x = b przez dgetrf/dgetrs. Bufor wierszami to A^T w układzie kolumnowym Fortranu, więc faktoryzowany
+// jest bez transpozycji (P A^T = L U), a rozwiązanie liczy dgetrs z trans = 'T'.
+inline std::vector<double> solve_lu(const CppMatrix &augmented) {
+    ::detail::validate_augmented(augmented);
+    detail::require_available();
+    const int n = detail::checked_dimension(augmented.rows);
+    detail::Buffer a = detail::coefficients(augmented);
+    std::vector<double> x = augmented_rhs(augmented);
+    std::vector<int> ipiv(n);
+    detail::getrf(n, a.data(), ipiv.data());
+#if defined(GAUS_WITH_LAPACK)
+    const int one = 1;
+    int info = 0;
+    dgetrs_("T", &n, &one, a.data(), &n, ipiv.data(), x.data(), &n, &info, 1);
+    if (info != 0) {
+        throw std::runtime_error("dgetrs: invalid argument " + std::to_string(-info));
+    }
+#endif
+    return x;
+}
+
+// Czynniki LU w formacie lu_factor z gaussian.hpp (PA = LU wierszami, pivots od 0), np. do magazynu czynników
+inline LuFactors lu_factor(const CppMatrix &augmented) {
+    ::detail::validate_augmented(augmented);
+    detail::require_available();
+    const std::size_t n = augmented.rows;
+    const int dim = detail::checked_dimension(n);
+    detail::Buffer a(n * n);
+    for (std::size_t r = 0; r < n; ++r) {
+        for (std::size_t c = 0; c < n; ++c) {
+            a[c * n + r] = augmented.data[r * augmented.cols + c];
+        }
+    }
+    std::vector<int> ipiv(n);
+    detail::getrf(dim, a.data(), ipiv.data());
+
+    LuFactors factors;
+    factors.n = n;
+    factors.lu.resize(n * n);
+    factors.pivots.resize(n);
+    for (std::size_t c = 0; c < n; ++c) {
+        for (std::size_t r = 0; r < n; ++r) {
+            factors.lu[r * n + c] = a[c * n + r];
+        }
+        factors.pivots[c] = static_cast<std::uint32_t>(ipiv[c] - 1);
+    }
+    return factors;
+}
+
+// A x = b dla macierzy symetrycznej dodatnio określonej przez dpotrf/dpotrs (Cholesky, połowa pracy LU).
+// Symetria jest sprawdzana, bo dpotrf czyta tylko jeden trójkąt i dla innych macierzy dałby zły wynik.
+inline std::vector<double> solve_cholesky(const CppMatrix &augmented) {
+    ::detail::validate_augmented(augmented);
+    detail::require_available();
+    const std::size_t n = augmented.rows;
+    const int dim = detail::checked_dimension(n);
+    detail::Buffer a = detail::coefficients(augmented);
+    for (std::size_t r = 0; r < n; ++r) {
+        for (std::size_t c = r + 1; c < n; ++c) {
+            const double upper = a[r * n + c];
+            const double lower = a[c * n + r];
+            if (std::fabs(upper - lower) > 1e-12 * std::max({1.0, std::fabs(upper), std::fabs(lower)})) {
+                throw std::runtime_error("Matrix is not symmetric");
+            }
+        }
+    }
+    std::vector<double> x = augmented_rhs(augmented);
+#if defined(GAUS_WITH_LAPACK)
+    int info = 0;
+    dpotrf_("L", &dim, a.data(), &dim, &info, 1);
+    if (info > 0) {
+        throw std::runtime_error("Matrix is not positive definite");
+    }
+    if (info < 0) {
+        throw std::runtime_error("dpotrf: invalid argument " + std::to_string(-info));
+    }
+    const int one = 1;
+    dpotrs_("L", &dim, &one, a.data(), &dim, x.data(), &dim, &info, 1);
+    if (info != 0) {
+        throw std::runtime_error("dpotrs: invalid argument " + std::to_string(-info));
+    }
+#else
+    (void)dim;
+#endif
+    return x;
+}
+
+} // namespace lapack
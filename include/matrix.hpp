@@ -1,5 +1,7 @@
 #pragma once
 
+#include "memory_stats.hpp"
+
 #include <random>
 #include <sstream>
 #include <stdexcept>
@@ -9,7 +11,7 @@
 struct CppMatrix {
     std::size_t rows{};
     std::size_t cols{};
-    std::vector<double> data;
+    std::vector<double, memory::TrackingAllocator<double>> data;
 
     double &operator()(std::size_t r, std::size_t c) {
         return data[r * cols + c];
@@ -0,0 +1,351 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace memory {
+
+// Liczniki pamięci jednego żądania: bajty z alokatorów oraz szczytowe RSS/PSS procesu i workerów
+class RequestLedger {
+public:
+    void charge(std::size_t bytes) {
+        const std::size_t now = current_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        raise(peak_bytes_, now);
+    }
+
+    void release(std::size_t bytes) {
+        current_.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    void note_sample(std::size_t rss_kb, std::size_t pss_kb, std::size_t pte_kb) {
+        raise(peak_rss_kb_, rss_kb);
+        raise(peak_pss_kb_, pss_kb);
+        raise(peak_pte_kb_, pte_kb);
+    }
+
+    void add_child(pid_t pid) {
+        std::lock_guard<std::mutex> lock(children_mutex_);
+        children_.push_back(pid);
+    }
+
+    void remove_child(pid_t pid) {
+        std::lock_guard<std::mutex> lock(children_mutex_);
+        children_.erase(std::remove(children_.begin(), children_.end(), pid), children_.end());
+    }
+
+    std::vector<pid_t> children() const {
+        std::lock_guard<std::mutex> lock(children_mutex_);
+        return children_;
+    }
+
+    std::size_t current_bytes() const { return current_.load(std::memory_order_relaxed); }
+    std::size_t peak_bytes() const { return peak_bytes_.load(std::memory_order_relaxed); }
+    std::size_t peak_rss_kb() const { return peak_rss_kb_.load(std::memory_order_relaxed); }
+    std::size_t peak_pss_kb() const { return peak_pss_kb_.load(std::memory_order_relaxed); }
+    std::size_t peak_pte_kb() const { return peak_pte_kb_.load(std::memory_order_relaxed); }
+
+private:
+    static void raise(std::atomic<std::size_t> &target, std::size_t value) {
+        std::size_t seen = target.load(std::memory_order_relaxed);
+        while (seen < value && !target.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    std::atomic<std::size_t> current_{0};
+    std::atomic<std::size_t> peak_bytes_{0};
+    std::atomic<std::size_t> peak_rss_kb_{0};
+    std::atomic<std::size_t> peak_pss_kb_{0};
+    std::atomic<std::size_t> peak_pte_kb_{0};
+    mutable std::mutex children_mutex_;
+    std::vector<pid_t> children_;
+};
+
+// Licznik żądania obsługiwanego przez bieżący wątek (pusty poza żądaniem)
+inline std::shared_ptr<RequestLedger> &current_ledger() {
+    thread_local std::shared_ptr<RequestLedger> ledger;
+    return ledger;
+}
+
+class LedgerScope {
+public:
+    explicit LedgerScope(std::shared_ptr<RequestLedger> ledger)
+        : previous_(std::exchange(current_ledger(), std::move(ledger))) {}
+
+    ~LedgerScope() { current_ledger() = std::move(previous_); }
+
+    LedgerScope(const LedgerScope &) = delete;
+    LedgerScope &operator=(const LedgerScope &) = delete;
+
+private:
+    std::shared_ptr<RequestLedger> previous_;
+};
+
+// resize() kontenerów z TrackingAllocator w tym wątku nie zeruje elementów typów trywialnych (zob. SkipZeroFill)
+inline bool &skip_zero_fill() {
+    thread_local bool skip = false;
+    return skip;
+}
+
+// Bufor, który zaraz zostanie w całości nadpisany (np. odczytem z gniazda), powstaje bez zerowania:
+// jego strony dotyka dopiero pierwszy zapis, a nie seryjne zerowanie w wątku wywołującym
+class SkipZeroFill {
+public:
+    SkipZeroFill() : previous_(std::exchange(skip_zero_fill(), true)) {}
+    ~SkipZeroFill() { skip_zero_fill() = previous_; }
+
+    SkipZeroFill(const SkipZeroFill &) = delete;
+    SkipZeroFill &operator=(const SkipZeroFill &) = delete;
+
+private:
+    bool previous_;
+};
+
+// Obciąża licznik bieżącego żądania na czas życia obiektu (bufory spoza alokatorów C++, np. mmap, XDR)
+class ScopedCharge {
+public:
+    explicit ScopedCharge(std::size_t bytes) : ledger_(current_ledger()), bytes_(bytes) {
+        if (ledger_) {
+            ledger_->charge(bytes_);
+        }
+    }
+
+    ~ScopedCharge() {
+        if (ledger_) {
+            ledger_->release(bytes_);
+        }
+    }
+
+    ScopedCharge(const ScopedCharge &) = delete;
+    ScopedCharge &operator=(const ScopedCharge &) = delete;
+
+private:
+    std::shared_ptr<RequestLedger> ledger_;
+    std::size_t bytes_;
+};
+
+// Alokator przypisujący pamięć do licznika żądania, w którym kontener powstał
+template <typename T>
+class TrackingAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    TrackingAllocator() noexcept : ledger_(current_ledger()) {}
+
+    template <typename U>
+    TrackingAllocator(const TrackingAllocator<U> &other) noexcept : ledger_(other.ledger()) {}
+
+    T *allocate(std::size_t count) {
+        T *ptr = std::allocator<T>{}.allocate(count);
+        if (ledger_) {
+            ledger_->charge(count * sizeof(T));
+        }
+        return ptr;
+    }
+
+    void deallocate(T *ptr, std::size_t count) noexcept {
+        if (ledger_) {
+            ledger_->release(count * sizeof(T));
+        }
+        std::allocator<T>{}.deallocate(ptr, count);
+    }
+
+    template <typename U>
+    void construct(U *ptr) {
+        if constexpr (std::is_trivially_default_constructible_v<U>) {
+            if (skip_zero_fill()) {
+                ::new (static_cast<void *>(ptr)) U;
+                return;
+            }
+        }
+        ::new (static_cast<void *>(ptr)) U();
+    }
+
+    template <typename U, typename... Args>
+    void construct(U *ptr, Args &&...args) {
+        ::new (static_cast<void *>(ptr)) U(std::forward<Args>(args)...);
+    }
+
+    // Kopia kontenera należy do żądania, które ją wykonuje
+    TrackingAllocator select_on_container_copy_construction() const { return TrackingAllocator{}; }
+
+    const std::shared_ptr<RequestLedger> &ledger() const noexcept { return ledger_; }
+
+    template <typename U>
+    bool operator==(const TrackingAllocator<U> &other) const noexcept {
+        return ledger_ == other.ledger();
+    }
+
+    template <typename U>
+    bool operator!=(const TrackingAllocator<U> &other) const noexcept {
+        return !(*this == other);
+    }
+
+private:
+    std::shared_ptr<RequestLedger> ledger_;
+};
+
+struct ProcessSample {
+    std::size_t rss_kb{};
+    std::size_t pss_kb{};
+    std::size_t pte_kb{};
+};
+
+namespace detail {
+
+inline std::size_t read_kb_field(const std::string &path, const std::string &field) {
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.compare(0, field.size(), field) == 0 && line.size() > field.size() &&
+            line[field.size()] == ':') {
+            std::istringstream iss(line.substr(field.size() + 1));
+            std::size_t value = 0;
+            iss >> value;
+            return value;
+        }
+    }
+    return 0;
+}
+
+} // namespace detail
+
+// RSS/PSS z smaps_rollup oraz rozmiar tablic stron (VmPTE) procesu
+inline ProcessSample read_process_sample(pid_t pid) {
+    const std::string base = "/proc/" + std::to_string(pid);
+    ProcessSample sample;
+    sample.rss_kb = detail::read_kb_field(base + "/smaps_rollup", "Rss");
+    sample.pss_kb = detail::read_kb_field(base + "/smaps_rollup", "Pss");
+    sample.pte_kb = detail::read_kb_field(base + "/status", "VmPTE");
+    return sample;
+}
+
+// Zasoby procesu, które przy długiej pracy nie powinny rosnąć (deskryptory, wątki, procesy potomne)
+struct ProcessHealth {
+    std::size_t rss_kb{};
+    std::size_t fds{};
+    std::size_t threads{};
+    std::size_t children{};
+    std::size_t zombies{}; // potomkowie w stanie Z (niezebrani przez waitpid)
+};
+
+inline ProcessHealth read_process_health(pid_t pid) {
+    const std::string base = "/proc/" + std::to_string(pid);
+    ProcessHealth health;
+    health.rss_kb = detail::read_kb_field(base + "/status", "VmRSS");
+    health.threads = detail::read_kb_field(base + "/status", "Threads");
+
+    std::error_code error;
+    for (std::filesystem::directory_iterator it(base + "/fd", error), end; !error && it != end; it.increment(error)) {
+        ++health.fds;
+    }
+    // /proc/<pid>/stat: "pid (comm) state ppid ..."; comm może zawierać spacje, więc parsowanie od ostatniego ')'
+    for (std::filesystem::directory_iterator it("/proc", error), end; !error && it != end; it.increment(error)) {
+        std::ifstream in(it->path() / "stat");
+        std::string line;
+        if (!std::getline(in, line)) {
+            continue;
+        }
+        const auto paren = line.rfind(')');
+        if (paren == std::string::npos) {
+            continue;
+        }
+        std::istringstream fields(line.substr(paren + 1));
+        char state = 0;
+        pid_t parent = 0;
+        if (fields >> state >> parent && parent == pid) {
+            ++health.children;
+            health.zombies += state == 'Z' ? 1 : 0;
+        }
+    }
+    return health;
+}
+
+// Wątek próbkujący pamięć procesu i workerów żądania aż do zniszczenia obiektu.
+// RSS jest wspólne dla całego procesu, więc przy równoległych żądaniach jest to górne oszacowanie.
+class RssSampler {
+public:
+    explicit RssSampler(std::shared_ptr<RequestLedger> ledger,
+                        std::chrono::milliseconds interval = std::chrono::milliseconds(25))
+        : ledger_(std::move(ledger)), interval_(interval) {
+        if (ledger_) {
+            sample_once();
+            thread_ = std::thread([this]() { run(); });
+        }
+    }
+
+    ~RssSampler() {
+        if (thread_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            cv_.notify_one();
+            thread_.join();
+            sample_once();
+        }
+    }
+
+    RssSampler(const RssSampler &) = delete;
+    RssSampler &operator=(const RssSampler &) = delete;
+
+private:
+    void sample_once() {
+        ProcessSample total = read_process_sample(getpid());
+        std::size_t rss_kb = total.rss_kb;
+        std::size_t pss_kb = total.pss_kb;
+        std::size_t pte_kb = total.pte_kb;
+        for (pid_t child : ledger_->children()) {
+            const ProcessSample sample = read_process_sample(child);
+            // Workery dzielą przestrzeń roboczą mmap z rodzicem: RSS się dubluje, PSS sumuje się poprawnie
+            rss_kb = std::max(rss_kb, sample.rss_kb);
+            pss_kb += sample.pss_kb;
+            pte_kb += sample.pte_kb;
+        }
+        ledger_->note_sample(rss_kb, pss_kb, pte_kb);
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!cv_.wait_for(lock, interval_, [this]() { return stop_; })) {
+            lock.unlock();
+            sample_once();
+            lock.lock();
+        }
+    }
+
+    std::shared_ptr<RequestLedger> ledger_;
+    std::chrono::milliseconds interval_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_{false};
+    std::thread thread_;
+};
+
+inline std::string format_bytes(std::size_t bytes) {
+    std::ostringstream oss;
+    oss.setf(std::ios::fixed);
+    oss.precision(1);
+    oss << static_cast<double>(bytes) / (1024.0 * 1024.0) << " MiB";
+    return oss.str();
+}
+
+} // namespace memory
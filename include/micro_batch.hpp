@@ -0,0 +1,183 @@
+#pragma once
+
+#include "group_batch.hpp"
+#include "matrix.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace micro {
+
+// Liczba układów rozwiązywanych naraz: jeden wektor rejestrów SIMD liczb double (AVX: 4, SSE2: 2)
+#if defined(__AVX__)
+constexpr std::size_t kLanes = 4;
+#else
+constexpr std::size_t kLanes = 2;
+#endif
+
+// Wektory GCC/Clang: operacje arytmetyczne i porównania działają na wszystkich pasach naraz w każdej kompilacji
+using Lanes = double __attribute__((vector_size(kLanes * sizeof(double))));
+using LaneMask = std::int64_t __attribute__((vector_size(kLanes * sizeof(double))));
+
+// Eliminacja Gaussa z częściowym wyborem elementu głównego dla kLanes układów n x (n+1) naraz w układzie
+// struktury tablic: a[r * (n + 1) + c] zawiera element (r, c) wszystkich układów. Wybór elementu głównego
+// jest osobny dla każdego pasa. Po powrocie kolumna n zawiera rozwiązania; singular[s] = 1 dla układów
+// osobliwych (ich wartości są bez znaczenia).
+inline void solve_lanes(std::size_t n, Lanes *a, std::uint8_t *singular) {
+    constexpr double kEpsilon = 1e-12;
+    const std::size_t width = n + 1;
+    std::fill(singular, singular + kLanes, std::uint8_t{0});
+
+    for (std::size_t col = 0; col < n; ++col) {
+        Lanes best = a[col * width + col];
+        best = best < 0.0 ? -best : best;
+        LaneMask best_row = LaneMask{} + static_cast<std::int64_t>(col);
+        for (std::size_t r = col + 1; r < n; ++r) {
+            Lanes value = a[r * width + col];
+            value = value < 0.0 ? -value : value;
+            const LaneMask better = value > best;
+            best = better ? value : best;
+            best_row = better ? LaneMask{} + static_cast<std::int64_t>(r) : best_row;
+        }
+        for (std::size_t s = 0; s < kLanes; ++s) {
+            const std::size_t row = static_cast<std::size_t>(best_row[s]);
+            if (best[s] < kEpsilon) {
+                // Osobliwy układ dostaje jednostkowy element główny, żeby nie psuć pozostałych pasów NaN-ami
+                singular[s] = 1;
+                a[col * width + col][s] = 1.0;
+            } else if (row != col) {
+                for (std::size_t c = col; c < width; ++c) {
+                    const double value = a[col * width + c][s];
+                    a[col * width + c][s] = a[row * width + c][s];
+                    a[row * width + c][s] = value;
+                }
+            }
+        }
+
+        const Lanes *pivot_row = &a[col * width];
+        const Lanes pivot = pivot_row[col];
+        for (std::size_t r = col + 1; r < n; ++r) {
+            Lanes *row = &a[r * width];
+            const Lanes factor = row[col] / pivot;
+            for (std::size_t c = col + 1; c < width; ++c) {
+                row[c] -= factor * pivot_row[c];
+            }
+        }
+    }
+
+    // Podstawienie wstecz: x_i trafia w miejsce prawej strony wiersza i
+    for (std::size_t i = n; i-- > 0;) {
+        Lanes *row = &a[i * width];
+        Lanes x = row[n];
+        for (std::size_t j = i + 1; j < n; ++j) {
+            x -= row[j] * a[j * width + n];
+        }
+        row[n] = x / row[i];
+    }
+}
+
+// Mały układ czekający na rozwiązanie w paczce; macierz należy do wywołującego do czasu wznowienia
+struct Slot : batch::GroupSlot<Slot> {
+    const CppMatrix *matrix{};
+    std::vector<double> solution;
+    bool singular{false};
+};
+
+namespace detail {
+
+// Pakowanie kolejnych kLanes układów do struktury tablic, rozwiązanie i rozpakowanie wyników. Puste pasy
+// ostatniej paczki dostają układ jednostkowy.
+inline void solve_slice(Slot *const *slots, std::size_t k, std::size_t n) {
+    const std::size_t width = n + 1;
+    std::vector<Lanes> block(n * width);
+    std::uint8_t singular[kLanes];
+    for (std::size_t first = 0; first < k; first += kLanes) {
+        const std::size_t lanes = std::min(kLanes, k - first);
+        for (std::size_t s = 0; s < kLanes; ++s) {
+            for (std::size_t r = 0; r < n; ++r) {
+                for (std::size_t c = 0; c < width; ++c) {
+                    block[r * width + c][s] = s < lanes ? slots[first + s]->matrix->data[r * width + c]
+                                                        : (r == c ? 1.0 : 0.0);
+                }
+            }
+        }
+        solve_lanes(n, block.data(), singular);
+        for (std::size_t s = 0; s < lanes; ++s) {
+            Slot &slot = *slots[first + s];
+            slot.solution.resize(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                slot.solution[i] = block[i * width + n][s];
+            }
+            slot.singular = singular[s] != 0;
+        }
+    }
+}
+
+} // namespace detail
+
+// Łączy małe układy tego samego rozmiaru od różnych klientów w paczkę rozwiązywaną solve_lanes (GroupBatcher
+// z rozmiarem układu jako kluczem); lider przytrzymuje grupę przez `window` od otwarcia.
+class MicroBatcher {
+public:
+    using Stats = batch::GroupBatcher<std::size_t, Slot>::Stats;
+
+    MicroBatcher(std::size_t max_n, std::size_t max_width, std::chrono::microseconds window)
+        : max_n_(max_n), groups_(max_width, window) {}
+
+    std::size_t max_n() const { return max_n_; }
+
+    auto join(Slot &slot) { return groups_.join(slot.matrix->rows, slot); }
+
+    std::chrono::steady_clock::time_point deadline(const Slot &leader) const { return groups_.deadline(leader); }
+
+    // Dzieli paczkę między `threads` wątków (każdy z własnym blokiem struktury tablic)
+    template <typename Resume>
+    void solve_group(Slot &leader, std::size_t threads, Resume &&resume) {
+        const std::size_t n = leader.matrix->rows;
+        auto solve = [n, threads](Slot *const *slots, std::size_t k) {
+            // Co najmniej kMinSystems układów na wątek, żeby narzut wątku nie przewyższył zysku; części są
+            // wielokrotnościami kLanes, więc tylko ostatnia paczka może mieć puste pasy
+            constexpr std::size_t kMinSystems = 16;
+            const std::size_t parts = std::max<std::size_t>(1, std::min(threads, k / kMinSystems));
+            const std::size_t chunk = ((k + parts - 1) / parts + kLanes - 1) / kLanes * kLanes;
+            // Wyjątek części (np. brak pamięci) jest przekazywany po dołączeniu wszystkich wątków
+            std::vector<std::exception_ptr> failures((k + chunk - 1) / chunk);
+            auto part = [&](std::size_t first) {
+                try {
+                    detail::solve_slice(&slots[first], std::min(chunk, k - first), n);
+                } catch (...) {
+                    failures[first / chunk] = std::current_exception();
+                }
+            };
+            std::vector<std::thread> helpers;
+            for (std::size_t first = chunk; first < k; first += chunk) {
+                helpers.emplace_back(part, first);
+            }
+            part(0);
+            for (auto &helper : helpers) {
+                helper.join();
+            }
+            for (const std::exception_ptr &failure : failures) {
+                if (failure) {
+                    std::rethrow_exception(failure);
+                }
+            }
+        };
+        groups_.solve_group(n, leader, solve, std::forward<Resume>(resume));
+    }
+
+    Stats stats() const { return groups_.stats(); }
+
+private:
+    std::size_t max_n_;
+    batch::GroupBatcher<std::size_t, Slot> groups_;
+};
+
+} // namespace micro
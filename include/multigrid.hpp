@@ -0,0 +1,553 @@
+#pragma once
+
+#include "memory_stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace mg {
+
+using Field = std::vector<double, memory::TrackingAllocator<double>>;
+
+// Operator o stałym stencilu 7-punktowym (5-punktowym dla nz = 1) na siatce nx*ny*nz z zerowym brzegiem
+// Dirichleta: (A u)_p = center*u_p + off_x*(u_W + u_E) + off_y*(u_S + u_N) + off_z*(u_D + u_U).
+// Indeks punktu: (k*ny + j)*nx + i.
+struct Stencil {
+    std::size_t nx{1};
+    std::size_t ny{1};
+    std::size_t nz{1};
+    double center{0.0};
+    double off_x{0.0};
+    double off_y{0.0};
+    double off_z{0.0};
+
+    std::size_t points() const { return nx * ny * nz; }
+
+    // points() bez przepełnienia: false, gdy nx*ny*nz nie mieści się w size_t (wymiary z żądania klienta)
+    bool checked_points(std::size_t &points) const {
+        return !__builtin_mul_overflow(nx, ny, &points) && !__builtin_mul_overflow(points, nz, &points);
+    }
+};
+
+struct Options {
+    double tolerance{1e-8}; // względna norma residuum ||b - Au|| / ||b||
+    std::size_t max_cycles{50};
+    std::size_t pre_smooth{2};
+    std::size_t post_smooth{2};
+    std::size_t threads{0}; // 0 = liczba rdzeni
+};
+
+struct Result {
+    Field solution;
+    std::size_t cycles{0};
+    std::size_t levels{0};
+    double relative_residual{0.0};
+};
+
+// Szacowany koszt (flopy) rozwiązania cyklami V: O(N) na cykl
+inline double estimate_flops(std::size_t points) { return 400.0 * static_cast<double>(points); }
+
+namespace detail {
+
+// Stała grupa wątków dla pętli po wierszach siatki; wątek wywołujący liczy pierwszą część zakresu
+class WorkTeam {
+public:
+    explicit WorkTeam(std::size_t threads) {
+        const std::size_t count = std::max<std::size_t>(1, threads);
+        for (std::size_t index = 1; index < count; ++index) {
+            workers_.emplace_back([this, index]() { run(index); });
+        }
+    }
+
+    ~WorkTeam() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_cv_.notify_all();
+        for (auto &worker : workers_) {
+            worker.join();
+        }
+    }
+
+    WorkTeam(const WorkTeam &) = delete;
+    WorkTeam &operator=(const WorkTeam &) = delete;
+
+    std::size_t size() const { return workers_.size() + 1; }
+
+    // body(begin, end) dla rozłącznych części [0, count); małe zakresy liczone są bez synchronizacji
+    void parallel_for(std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)> &body) {
+        if (workers_.empty() || count < 2 * grain) {
+            body(0, count);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            body_ = &body;
+            count_ = count;
+            pending_ = workers_.size();
+            ++generation_;
+        }
+        start_cv_.notify_all();
+        body(0, chunk_end(0));
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this]() { return pending_ == 0; });
+        body_ = nullptr;
+    }
+
+private:
+    std::size_t chunk_end(std::size_t index) const { return count_ * (index + 1) / size(); }
+
+    void run(std::size_t index) {
+        std::size_t seen = 0;
+        for (;;) {
+            const std::function<void(std::size_t, std::size_t)> *body = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_cv_.wait(lock, [&]() { return stop_ || generation_ != seen; });
+                if (stop_) {
+                    return;
+                }
+                seen = generation_;
+                body = body_;
+            }
+            const std::size_t begin = count_ * index / size();
+            (*body)(begin, chunk_end(index));
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                --pending_;
+            }
+            done_cv_.notify_one();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void(std::size_t, std::size_t)> *body_{nullptr};
+    std::size_t count_{0};
+    std::size_t pending_{0};
+    std::size_t generation_{0};
+    bool stop_{false};
+};
+
+// Gęsty rozkład LU z częściowym wyborem elementu głównego dla najgrubszego poziomu
+class DenseLu {
+public:
+    explicit DenseLu(const Stencil &op) : n_(op.points()), lu_(n_ * n_, 0.0), pivots_(n_) {
+        const std::size_t plane = op.nx * op.ny;
+        for (std::size_t p = 0; p < n_; ++p) {
+            const std::size_t i = p % op.nx;
+            const std::size_t j = (p / op.nx) % op.ny;
+            const std::size_t k = p / plane;
+            double *row = &lu_[p * n_];
+            row[p] = op.center;
+            if (i > 0) {
+                row[p - 1] = op.off_x;
+            }
+            if (i + 1 < op.nx) {
+                row[p + 1] = op.off_x;
+            }
+            if (j > 0) {
+                row[p - op.nx] = op.off_y;
+            }
+            if (j + 1 < op.ny) {
+                row[p + op.nx] = op.off_y;
+            }
+            if (k > 0) {
+                row[p - plane] = op.off_z;
+            }
+            if (k + 1 < op.nz) {
+                row[p + plane] = op.off_z;
+            }
+        }
+
+        for (std::size_t col = 0; col < n_; ++col) {
+            std::size_t pivot = col;
+            for (std::size_t r = col + 1; r < n_; ++r) {
+                if (std::fabs(lu_[r * n_ + col]) > std::fabs(lu_[pivot * n_ + col])) {
+                    pivot = r;
+                }
+            }
+            if (std::fabs(lu_[pivot * n_ + col]) < 1e-300) {
+                throw std::runtime_error("Coarsest multigrid operator is singular");
+            }
+            pivots_[col] = pivot;
+            if (pivot != col) {
+                std::swap_ranges(&lu_[col * n_], &lu_[col * n_] + n_, &lu_[pivot * n_]);
+            }
+            const double diagonal = lu_[col * n_ + col];
+            for (std::size_t r = col + 1; r < n_; ++r) {
+                double *row = &lu_[r * n_];
+                const double factor = row[col] / diagonal;
+                row[col] = factor;
+                if (factor == 0.0) {
+                    continue;
+                }
+                const double *pivot_row = &lu_[col * n_];
+                for (std::size_t c = col + 1; c < n_; ++c) {
+                    row[c] -= factor * pivot_row[c];
+                }
+            }
+        }
+    }
+
+    void solve(const Field &rhs, Field &x) const {
+        x.assign(rhs.begin(), rhs.end());
+        for (std::size_t col = 0; col < n_; ++col) {
+            std::swap(x[col], x[pivots_[col]]);
+        }
+        for (std::size_t r = 0; r < n_; ++r) {
+            double sum = x[r];
+            for (std::size_t c = 0; c < r; ++c) {
+                sum -= lu_[r * n_ + c] * x[c];
+            }
+            x[r] = sum;
+        }
+        for (std::size_t r = n_; r-- > 0;) {
+            double sum = x[r];
+            for (std::size_t c = r + 1; c < n_; ++c) {
+                sum -= lu_[r * n_ + c] * x[c];
+            }
+            x[r] = sum / lu_[r * n_ + r];
+        }
+    }
+
+private:
+    std::size_t n_;
+    Field lu_;
+    std::vector<std::size_t> pivots_;
+};
+
+struct Level {
+    Stencil op;
+    bool coarsen_x{false};
+    bool coarsen_y{false};
+    bool coarsen_z{false};
+    Field u;
+    Field f;
+    Field r;
+};
+
+// Sąsiedzi punktu p w kierunku osi; brzeg Dirichleta daje zero
+inline double neighbour_sum(const Stencil &op, const double *u, std::size_t p, std::size_t i, std::size_t j,
+                            std::size_t k) {
+    const std::size_t plane = op.nx * op.ny;
+    double sum = 0.0;
+    if (i > 0) {
+        sum += op.off_x * u[p - 1];
+    }
+    if (i + 1 < op.nx) {
+        sum += op.off_x * u[p + 1];
+    }
+    if (j > 0) {
+        sum += op.off_y * u[p - op.nx];
+    }
+    if (j + 1 < op.ny) {
+        sum += op.off_y * u[p + op.nx];
+    }
+    if (k > 0) {
+        sum += op.off_z * u[p - plane];
+    }
+    if (k + 1 < op.nz) {
+        sum += op.off_z * u[p + plane];
+    }
+    return sum;
+}
+
+// Punkty i wagi jednej osi dla restrykcji (do trzech) lub interpolacji (do dwóch)
+struct Taps {
+    std::size_t index[3];
+    double weight[3];
+    std::size_t count{0};
+};
+
+inline Taps interpolation_taps(std::size_t fine, std::size_t coarse_n, bool coarsened) {
+    Taps taps;
+    if (!coarsened) {
+        taps.index[0] = fine;
+        taps.weight[0] = 1.0;
+        taps.count = 1;
+        return taps;
+    }
+    if (fine % 2 == 1) {
+        const std::size_t c = (fine - 1) / 2;
+        if (c < coarse_n) {
+            taps.index[0] = c;
+            taps.weight[0] = 1.0;
+            taps.count = 1;
+        }
+        return taps;
+    }
+    const std::size_t c = fine / 2;
+    if (c >= 1) {
+        taps.index[taps.count] = c - 1;
+        taps.weight[taps.count] = 0.5;
+        ++taps.count;
+    }
+    if (c < coarse_n) {
+        taps.index[taps.count] = c;
+        taps.weight[taps.count] = 0.5;
+        ++taps.count;
+    }
+    return taps;
+}
+
+// Wagi pełnego uśredniania (1/4, 1/2, 1/4) punktu grubego c wzdłuż osi
+inline Taps restriction_taps(std::size_t coarse, bool coarsened) {
+    Taps taps;
+    if (!coarsened) {
+        taps.index[0] = coarse;
+        taps.weight[0] = 1.0;
+        taps.count = 1;
+        return taps;
+    }
+    for (std::size_t t = 0; t < 3; ++t) {
+        taps.index[t] = 2 * coarse + t;
+        taps.weight[t] = t == 1 ? 0.5 : 0.25;
+    }
+    taps.count = 3;
+    return taps;
+}
+
+} // namespace detail
+
+// Geometryczny multigrid (cykle V) bez składania macierzy: red-black Gauss-Seidel jako wygładzacz,
+// pełne uśrednianie i interpolacja liniowa, rozkład LU na najgrubszym poziomie. Osie krótsze niż 3 punkty
+// nie są zagęszczane (semi-coarsening). Najlepiej zbiega dla rozmiarów osi postaci 2^k - 1.
+class Solver {
+public:
+    static constexpr std::size_t kCoarsestPoints = 512;
+
+    Solver(const Stencil &op, const Options &options)
+        : options_(options), team_(options.threads != 0 ? options.threads : std::thread::hardware_concurrency()) {
+        std::size_t points = 0;
+        if (op.nx == 0 || op.ny == 0 || op.nz == 0) {
+            throw std::invalid_argument("Stencil grid dimensions must be positive");
+        }
+        if (!op.checked_points(points)) {
+            throw std::invalid_argument("Stencil grid has too many points");
+        }
+        if (op.center == 0.0 || !std::isfinite(op.center) || !std::isfinite(op.off_x) || !std::isfinite(op.off_y) ||
+            !std::isfinite(op.off_z)) {
+            throw std::invalid_argument("Stencil needs a finite, non-zero center coefficient");
+        }
+
+        // Część reakcyjna stencilu nie zależy od kroku siatki; część dyfuzyjna skaluje się przez 1/4 na osi zagęszczanej
+        const double reaction = op.center + 2.0 * (op.off_x + op.off_y + op.off_z);
+        Stencil current = op;
+        for (;;) {
+            detail::Level level;
+            level.op = current;
+            level.coarsen_x = current.nx >= 3;
+            level.coarsen_y = current.ny >= 3;
+            level.coarsen_z = current.nz >= 3;
+            level.u.assign(current.points(), 0.0);
+            level.f.assign(current.points(), 0.0);
+            level.r.assign(current.points(), 0.0);
+            const bool last = current.points() <= kCoarsestPoints ||
+                              !(level.coarsen_x || level.coarsen_y || level.coarsen_z);
+            levels_.push_back(std::move(level));
+            if (last) {
+                break;
+            }
+
+            const detail::Level &fine = levels_.back();
+            Stencil coarse = current;
+            if (fine.coarsen_x) {
+                coarse.nx = (current.nx - 1) / 2;
+                coarse.off_x = current.off_x / 4.0;
+            }
+            if (fine.coarsen_y) {
+                coarse.ny = (current.ny - 1) / 2;
+                coarse.off_y = current.off_y / 4.0;
+            }
+            if (fine.coarsen_z) {
+                coarse.nz = (current.nz - 1) / 2;
+                coarse.off_z = current.off_z / 4.0;
+            }
+            coarse.center = reaction - 2.0 * (coarse.off_x + coarse.off_y + coarse.off_z);
+            current = coarse;
+        }
+        coarse_solver_ = std::make_unique<detail::DenseLu>(levels_.back().op);
+    }
+
+    Result solve(const double *rhs) {
+        detail::Level &top = levels_.front();
+        top.f.assign(rhs, rhs + top.op.points());
+        std::fill(top.u.begin(), top.u.end(), 0.0);
+
+        Result result;
+        result.levels = levels_.size();
+        const double rhs_norm = norm(top.f);
+        if (rhs_norm == 0.0) {
+            result.solution = top.u;
+            return result;
+        }
+
+        double relative = 1.0;
+        while (result.cycles < options_.max_cycles) {
+            vcycle(0);
+            ++result.cycles;
+            residual(top);
+            relative = norm(top.r) / rhs_norm;
+            if (!std::isfinite(relative)) {
+                throw std::runtime_error("Multigrid diverged (is the stencil elliptic?)");
+            }
+            if (relative <= options_.tolerance) {
+                break;
+            }
+        }
+        result.relative_residual = relative;
+        result.solution = top.u;
+        return result;
+    }
+
+private:
+    static constexpr std::size_t kRowGrain = 16;
+
+    void vcycle(std::size_t index) {
+        detail::Level &level = levels_[index];
+        if (index + 1 == levels_.size()) {
+            coarse_solver_->solve(level.f, level.u);
+            return;
+        }
+        detail::Level &coarse = levels_[index + 1];
+        for (std::size_t s = 0; s < options_.pre_smooth; ++s) {
+            smooth(level);
+        }
+        residual(level);
+        restrict_residual(level, coarse);
+        std::fill(coarse.u.begin(), coarse.u.end(), 0.0);
+        vcycle(index + 1);
+        prolong_correction(coarse, level);
+        for (std::size_t s = 0; s < options_.post_smooth; ++s) {
+            smooth(level);
+        }
+    }
+
+    // Red-black Gauss-Seidel: punkty jednego koloru nie sąsiadują, więc wiersze liczone są równolegle
+    void smooth(detail::Level &level) {
+        const Stencil &op = level.op;
+        double *u = level.u.data();
+        const double *f = level.f.data();
+        for (std::size_t color = 0; color < 2; ++color) {
+            team_.parallel_for(op.ny * op.nz, kRowGrain, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t row = begin; row < end; ++row) {
+                    const std::size_t j = row % op.ny;
+                    const std::size_t k = row / op.ny;
+                    const std::size_t base = row * op.nx;
+                    for (std::size_t i = (color + j + k) & 1; i < op.nx; i += 2) {
+                        const std::size_t p = base + i;
+                        u[p] = (f[p] - detail::neighbour_sum(op, u, p, i, j, k)) / op.center;
+                    }
+                }
+            });
+        }
+    }
+
+    void residual(detail::Level &level) {
+        const Stencil &op = level.op;
+        const double *u = level.u.data();
+        const double *f = level.f.data();
+        double *r = level.r.data();
+        team_.parallel_for(op.ny * op.nz, kRowGrain, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t row = begin; row < end; ++row) {
+                const std::size_t j = row % op.ny;
+                const std::size_t k = row / op.ny;
+                const std::size_t base = row * op.nx;
+                for (std::size_t i = 0; i < op.nx; ++i) {
+                    const std::size_t p = base + i;
+                    r[p] = f[p] - op.center * u[p] - detail::neighbour_sum(op, u, p, i, j, k);
+                }
+            }
+        });
+    }
+
+    void restrict_residual(const detail::Level &fine, detail::Level &coarse) {
+        const Stencil &fo = fine.op;
+        const Stencil &co = coarse.op;
+        const double *r = fine.r.data();
+        double *f = coarse.f.data();
+        team_.parallel_for(co.ny * co.nz, kRowGrain, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t row = begin; row < end; ++row) {
+                const std::size_t jc = row % co.ny;
+                const std::size_t kc = row / co.ny;
+                const detail::Taps ty = detail::restriction_taps(jc, fine.coarsen_y);
+                const detail::Taps tz = detail::restriction_taps(kc, fine.coarsen_z);
+                for (std::size_t ic = 0; ic < co.nx; ++ic) {
+                    const detail::Taps tx = detail::restriction_taps(ic, fine.coarsen_x);
+                    double sum = 0.0;
+                    for (std::size_t c = 0; c < tz.count; ++c) {
+                        for (std::size_t b = 0; b < ty.count; ++b) {
+                            const double *fine_row = &r[(tz.index[c] * fo.ny + ty.index[b]) * fo.nx];
+                            for (std::size_t a = 0; a < tx.count; ++a) {
+                                sum += tz.weight[c] * ty.weight[b] * tx.weight[a] * fine_row[tx.index[a]];
+                            }
+                        }
+                    }
+                    f[row * co.nx + ic] = sum;
+                }
+            }
+        });
+    }
+
+    void prolong_correction(const detail::Level &coarse, detail::Level &fine) {
+        const Stencil &fo = fine.op;
+        const Stencil &co = coarse.op;
+        const double *e = coarse.u.data();
+        double *u = fine.u.data();
+        team_.parallel_for(fo.ny * fo.nz, kRowGrain, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t row = begin; row < end; ++row) {
+                const std::size_t j = row % fo.ny;
+                const std::size_t k = row / fo.ny;
+                const detail::Taps ty = detail::interpolation_taps(j, co.ny, fine.coarsen_y);
+                const detail::Taps tz = detail::interpolation_taps(k, co.nz, fine.coarsen_z);
+                for (std::size_t i = 0; i < fo.nx; ++i) {
+                    const detail::Taps tx = detail::interpolation_taps(i, co.nx, fine.coarsen_x);
+                    double correction = 0.0;
+                    for (std::size_t c = 0; c < tz.count; ++c) {
+                        for (std::size_t b = 0; b < ty.count; ++b) {
+                            const double *coarse_row = &e[(tz.index[c] * co.ny + ty.index[b]) * co.nx];
+                            for (std::size_t a = 0; a < tx.count; ++a) {
+                                correction += tz.weight[c] * ty.weight[b] * tx.weight[a] * coarse_row[tx.index[a]];
+                            }
+                        }
+                    }
+                    u[row * fo.nx + i] += correction;
+                }
+            }
+        });
+    }
+
+    double norm(const Field &values) const {
+        double sum = 0.0;
+        for (double value : values) {
+            sum += value * value;
+        }
+        return std::sqrt(sum);
+    }
+
+    Options options_;
+    detail::WorkTeam team_;
+    std::vector<detail::Level> levels_;
+    std::unique_ptr<detail::DenseLu> coarse_solver_;
+};
+
+inline Result solve(const Stencil &op, const double *rhs, const Options &options = {}) {
+    Solver solver(op, options);
+    return solver.solve(rhs);
+}
+
+} // namespace mg
@@ -0,0 +1,299 @@
+#pragma once
+
+#include "matrix.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace native {
+
+// Natywny protokół SOLVE_GAUSS obok ONC RPC: ramki z nagłówkiem o stałej długości, liczby little-endian
+// i double w formacie IEEE 754 little-endian. Na x86-64 i AArch64 to układ pamięci, więc macierz jest
+// wysyłana i odbierana przez writev/recvmsg prosto z buforów rozwiązania bez konwersji XDR.
+//
+// Żądanie:   RequestHeader, tenant (tenant_bytes bajtów), rows * cols double wierszami
+// Odpowiedź: ReplyHeader, potem count double (Status::ok) albo count bajtów komunikatu błędu
+// Połączenie obsługuje kolejne ramki; odpowiedź przychodzi przed odczytem następnego żądania.
+
+constexpr std::uint32_t kMagic = 0x53554147; // "GAUS"
+constexpr std::uint16_t kVersion = 1;
+constexpr std::uint16_t kSolveGauss = 1; // SOLVE_GAUSS z gaus_rpc.x
+constexpr std::uint32_t kMaxTenantBytes = 255;
+
+enum class Status : std::uint32_t {
+    ok = 0,
+    solve_failed = 1, // błąd numeryczny lub serwera, komunikat w treści
+    bad_request = 2,  // nieobsługiwana procedura lub niezgodne rozmiary; serwer zamyka połączenie
+};
+
+struct RequestHeader {
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::uint16_t procedure; // numer procedury z gaus_rpc.x; obsługiwany jest SOLVE_GAUSS
+    std::uint32_t rows;
+    std::uint32_t cols;
+    std::uint32_t tenant_bytes;
+    std::uint32_t engine; // silnik jak w SOLVE_WITH_ENGINE; 0 = wybór serwera
+};
+
+struct ReplyHeader {
+    std::uint32_t magic;
+    std::uint32_t status;
+    std::uint64_t count;
+};
+
+static_assert(sizeof(RequestHeader) == 24 && sizeof(ReplyHeader) == 16, "native frame headers must be packed");
+
+namespace detail {
+
+constexpr bool kBigEndian = std::endian::native == std::endian::big;
+
+inline std::uint16_t swap(std::uint16_t value) { return __builtin_bswap16(value); }
+inline std::uint32_t swap(std::uint32_t value) { return __builtin_bswap32(value); }
+inline std::uint64_t swap(std::uint64_t value) { return __builtin_bswap64(value); }
+
+// Zamiana kolejności bajtów nagłówków i double na łączu; na maszynach little-endian nic nie robi
+inline void to_wire(RequestHeader &header) {
+    if constexpr (kBigEndian) {
+        header.magic = swap(header.magic);
+        header.version = swap(header.version);
+        header.procedure = swap(header.procedure);
+        header.rows = swap(header.rows);
+        header.cols = swap(header.cols);
+        header.tenant_bytes = swap(header.tenant_bytes);
+        header.engine = swap(header.engine);
+    }
+}
+
+inline void to_wire(ReplyHeader &header) {
+    if constexpr (kBigEndian) {
+        header.magic = swap(header.magic);
+        header.status = swap(header.status);
+        header.count = swap(header.count);
+    }
+}
+
+inline void swap_values(double *values, std::size_t count) {
+    if constexpr (kBigEndian) {
+        for (std::size_t i = 0; i < count; ++i) {
+            std::uint64_t bits;
+            std::memcpy(&bits, &values[i], sizeof(bits));
+            bits = swap(bits);
+            std::memcpy(&values[i], &bits, sizeof(bits));
+        }
+    }
+}
+
+// readv/writev do skutku: po częściowym transferze przesuwa wskaźniki w `iov`
+template <typename Transfer>
+bool transfer_all(int fd, iovec *iov, int count, Transfer &&transfer) {
+    while (count > 0) {
+        const ssize_t done = transfer(fd, iov, count);
+        if (done == -1 && errno == EINTR) {
+            continue;
+        }
+        if (done <= 0) {
+            return false;
+        }
+        std::size_t left = static_cast<std::size_t>(done);
+        while (count > 0 && left >= iov->iov_len) {
+            left -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char *>(iov->iov_base) + left;
+            iov->iov_len -= left;
+        }
+    }
+    return true;
+}
+
+inline bool read_all(int fd, iovec *iov, int count) { return transfer_all(fd, iov, count, ::readv); }
+inline bool write_all(int fd, iovec *iov, int count) { return transfer_all(fd, iov, count, ::writev); }
+
+inline std::string errno_message(const char *prefix) { return std::string(prefix) + ": " + std::strerror(errno); }
+
+} // namespace detail
+
+// Serwer: wynik odczytu bez blokowania; pending = gniazdo nie ma więcej danych, reszta przy kolejnej gotowości
+enum class Receive { complete, pending, closed };
+
+namespace detail {
+
+// Dalszy odczyt do `iov` od bajtu `done` z MSG_DONTWAIT; `done` rośnie o odebrane bajty
+inline Receive receive_some(int fd, const iovec *iov, int count, std::size_t &done) {
+    for (;;) {
+        iovec rest[2];
+        int left = 0;
+        std::size_t skip = done;
+        for (int i = 0; i < count; ++i) {
+            if (skip >= iov[i].iov_len) {
+                skip -= iov[i].iov_len;
+                continue;
+            }
+            rest[left++] = iovec{static_cast<char *>(iov[i].iov_base) + skip, iov[i].iov_len - skip};
+            skip = 0;
+        }
+        if (left == 0) {
+            return Receive::complete;
+        }
+        msghdr message{};
+        message.msg_iov = rest;
+        message.msg_iovlen = static_cast<std::size_t>(left);
+        const ssize_t received = recvmsg(fd, &message, MSG_DONTWAIT);
+        if (received == -1 && errno == EINTR) {
+            continue;
+        }
+        if (received == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return Receive::pending;
+        }
+        if (received <= 0) {
+            return Receive::closed;
+        }
+        done += static_cast<std::size_t>(received);
+    }
+}
+
+} // namespace detail
+
+// Serwer: nagłówek kolejnej ramki, odbierany w częściach; kolejność bajtów zamieniana po odebraniu całości
+inline Receive receive_header(int fd, RequestHeader &header, std::size_t &done) {
+    const iovec iov{&header, sizeof(header)};
+    const Receive status = detail::receive_some(fd, &iov, 1, done);
+    if (status == Receive::complete) {
+        detail::to_wire(header);
+    }
+    return status;
+}
+
+// Serwer: tenant i macierz prosto do buforów o rozmiarach z nagłówka (tenant_bytes, rows * cols)
+inline Receive receive_payload(int fd, std::string &tenant, CppMatrix &matrix, std::size_t &done) {
+    const iovec iov[2] = {{tenant.data(), tenant.size()}, {matrix.data.data(), matrix.data.size() * sizeof(double)}};
+    const Receive status = detail::receive_some(fd, iov, 2, done);
+    if (status == Receive::complete) {
+        detail::swap_values(matrix.data.data(), matrix.data.size());
+    }
+    return status;
+}
+
+// Odpowiedź z wartościami wysyłana writev prosto z wektora rozwiązania
+inline bool write_values(int fd, const double *values, std::size_t count) {
+    ReplyHeader header{kMagic, static_cast<std::uint32_t>(Status::ok), count};
+    detail::to_wire(header);
+    std::vector<double> swapped;
+    if constexpr (detail::kBigEndian) {
+        swapped.assign(values, values + count);
+        detail::swap_values(swapped.data(), count);
+        values = swapped.data();
+    }
+    iovec iov[2] = {{&header, sizeof(header)}, {const_cast<double *>(values), count * sizeof(double)}};
+    return detail::write_all(fd, iov, 2);
+}
+
+inline bool write_error(int fd, Status status, const std::string &message) {
+    ReplyHeader header{kMagic, static_cast<std::uint32_t>(status), message.size()};
+    detail::to_wire(header);
+    iovec iov[2] = {{&header, sizeof(header)}, {const_cast<char *>(message.data()), message.size()}};
+    return detail::write_all(fd, iov, 2);
+}
+
+// Klient protokołu natywnego: jedno połączenie TCP, kolejne układy wysyłane synchronicznie
+class Client {
+public:
+    Client(const std::string &host, std::uint16_t port) {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo *found = nullptr;
+        const int rc = getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &found);
+        if (rc != 0) {
+            throw std::runtime_error("getaddrinfo failed: " + std::string(gai_strerror(rc)));
+        }
+        for (addrinfo *it = found; it != nullptr && fd_ == -1; it = it->ai_next) {
+            fd_ = socket(it->ai_family, it->ai_socktype | SOCK_CLOEXEC, it->ai_protocol);
+            if (fd_ != -1 && ::connect(fd_, it->ai_addr, it->ai_addrlen) != 0) {
+                close(fd_);
+                fd_ = -1;
+            }
+        }
+        freeaddrinfo(found);
+        if (fd_ == -1) {
+            throw std::runtime_error(detail::errno_message(("cannot connect to " + host + ":" +
+                                                            std::to_string(port)).c_str()));
+        }
+        const int one = 1;
+        setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+
+    ~Client() { close(fd_); }
+
+    Client(const Client &) = delete;
+    Client &operator=(const Client &) = delete;
+
+    // Rozwiązanie układu [A | b]; wyjątek, gdy serwer zgłosi błąd lub połączenie zostanie zerwane
+    std::vector<double> solve(const CppMatrix &augmented, const std::string &tenant = {}, std::uint32_t engine = 0) {
+        if (tenant.size() > kMaxTenantBytes) {
+            throw std::invalid_argument("Tenant name is too long");
+        }
+        RequestHeader header{kMagic, kVersion, kSolveGauss, static_cast<std::uint32_t>(augmented.rows),
+                             static_cast<std::uint32_t>(augmented.cols), static_cast<std::uint32_t>(tenant.size()),
+                             engine};
+        detail::to_wire(header);
+        const double *values = augmented.data.data();
+        std::vector<double> swapped;
+        if constexpr (detail::kBigEndian) {
+            swapped.assign(augmented.data.begin(), augmented.data.end());
+            detail::swap_values(swapped.data(), swapped.size());
+            values = swapped.data();
+        }
+        iovec request[3] = {{&header, sizeof(header)},
+                            {const_cast<char *>(tenant.data()), tenant.size()},
+                            {const_cast<double *>(values), augmented.data.size() * sizeof(double)}};
+        if (!detail::write_all(fd_, request, 3)) {
+            throw std::runtime_error(detail::errno_message("native send failed"));
+        }
+
+        ReplyHeader reply{};
+        iovec head{&reply, sizeof(reply)};
+        if (!detail::read_all(fd_, &head, 1)) {
+            throw std::runtime_error("native connection closed by server");
+        }
+        detail::to_wire(reply);
+        if (reply.magic != kMagic) {
+            throw std::runtime_error("invalid native reply");
+        }
+        if (reply.status != static_cast<std::uint32_t>(Status::ok)) {
+            std::string message(std::min<std::uint64_t>(reply.count, 4096), '\0');
+            iovec body{message.data(), message.size()};
+            detail::read_all(fd_, &body, 1);
+            throw std::runtime_error("server error: " + message);
+        }
+        std::vector<double> solution(reply.count);
+        iovec body{solution.data(), solution.size() * sizeof(double)};
+        if (!detail::read_all(fd_, &body, 1)) {
+            throw std::runtime_error("native connection closed by server");
+        }
+        detail::swap_values(solution.data(), solution.size());
+        return solution;
+    }
+
+private:
+    int fd_{-1};
+};
+
+} // namespace native
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+
+// Statyczne sondy USDT (dostawca "gaus") dla eBPF/bpftrace/perf, np.:
+//   bpftrace -e 'usdt:./gaus_server:gaus:solve__end { @us = hist(arg3); }'
+// Wyłączona sonda to pojedyncza instrukcja nop w kodzie i notatka w sekcji .note.stapsdt pliku ELF.
+// Gdy jest <sys/sdt.h> (systemtap-sdt-dev), używane są jej makra; na x86-64 i AArch64 bez niej notatka
+// jest emitowana w tym samym formacie bezpośrednio. -DGAUS_NO_PROBES usuwa sondy całkowicie.
+// Argumenty są przekazywane jako 64-bitowe liczby całkowite.
+
+#if defined(GAUS_NO_PROBES)
+
+#define GAUS_PROBE1(name, a1) ((void)0)
+#define GAUS_PROBE2(name, a1, a2) ((void)0)
+#define GAUS_PROBE3(name, a1, a2, a3) ((void)0)
+#define GAUS_PROBE4(name, a1, a2, a3, a4) ((void)0)
+#define GAUS_PROBE5(name, a1, a2, a3, a4, a5) ((void)0)
+
+#elif __has_include(<sys/sdt.h>)
+
+#include <sys/sdt.h>
+
+#define GAUS_PROBE1(name, a1) DTRACE_PROBE1(gaus, name, static_cast<std::int64_t>(a1))
+#define GAUS_PROBE2(name, a1, a2)                                                                                     \
+    DTRACE_PROBE2(gaus, name, static_cast<std::int64_t>(a1), static_cast<std::int64_t>(a2))
+#define GAUS_PROBE3(name, a1, a2, a3)                                                                                 \
+    DTRACE_PROBE3(gaus, name, static_cast<std::int64_t>(a1), static_cast<std::int64_t>(a2),                          \
+                  static_cast<std::int64_t>(a3))
+#define GAUS_PROBE4(name, a1, a2, a3, a4)                                                                             \
+    DTRACE_PROBE4(gaus, name, static_cast<std::int64_t>(a1), static_cast<std::int64_t>(a2),                          \
+                  static_cast<std::int64_t>(a3), static_cast<std::int64_t>(a4))
+#define GAUS_PROBE5(name, a1, a2, a3, a4, a5)                                                                         \
+    DTRACE_PROBE5(gaus, name, static_cast<std::int64_t>(a1), static_cast<std::int64_t>(a2),                          \
+                  static_cast<std::int64_t>(a3), static_cast<std::int64_t>(a4), static_cast<std::int64_t>(a5))
+
+#elif defined(__ELF__) && (defined(__x86_64__) || defined(__aarch64__))
+
+// Notatka stapsdt: adres nop, adres _.stapsdt.base (do korekty przy prelinkowaniu), semafor (brak),
+// dostawca, nazwa i opis argumentów "-8@<operand>" (ze znakiem, 8 bajtów)
+#define GAUS_PROBE_NOTE(name, args, ...)                                                                              \
+    __asm__ __volatile__("990: nop\n"                                                                                 \
+                         ".pushsection .note.stapsdt,\"?\",\"note\"\n"                                                \
+                         ".balign 4\n"                                                                                \
+                         ".4byte 992f-991f, 994f-993f, 3\n"                                                           \
+                         "991: .asciz \"stapsdt\"\n"                                                                  \
+                         "992: .balign 4\n"                                                                           \
+                         "993: .8byte 990b\n"                                                                         \
+                         ".8byte _.stapsdt.base\n"                                                                    \
+                         ".8byte 0\n"                                                                                 \
+                         ".asciz \"gaus\"\n"                                                                          \
+                         ".asciz \"" #name "\"\n"                                                                     \
+                         ".asciz \"" args "\"\n"                                                                      \
+                         "994: .balign 4\n"                                                                           \
+                         ".popsection\n"                                                                              \
+                         ".ifndef _.stapsdt.base\n"                                                                   \
+                         ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n"                     \
+                         ".weak _.stapsdt.base\n"                                                                     \
+                         ".hidden _.stapsdt.base\n"                                                                   \
+                         "_.stapsdt.base: .space 1\n"                                                                 \
+                         ".size _.stapsdt.base, 1\n"                                                                  \
+                         ".popsection\n"                                                                              \
+                         ".endif\n" ::__VA_ARGS__)
+
+#define GAUS_PROBE_ARG(a) "nor"(static_cast<std::int64_t>(a))
+
+#define GAUS_PROBE1(name, a1) GAUS_PROBE_NOTE(name, "-8@%0", GAUS_PROBE_ARG(a1))
+#define GAUS_PROBE2(name, a1, a2) GAUS_PROBE_NOTE(name, "-8@%0 -8@%1", GAUS_PROBE_ARG(a1), GAUS_PROBE_ARG(a2))
+#define GAUS_PROBE3(name, a1, a2, a3)                                                                                 \
+    GAUS_PROBE_NOTE(name, "-8@%0 -8@%1 -8@%2", GAUS_PROBE_ARG(a1), GAUS_PROBE_ARG(a2), GAUS_PROBE_ARG(a3))
+#define GAUS_PROBE4(name, a1, a2, a3, a4)                                                                             \
+    GAUS_PROBE_NOTE(name, "-8@%0 -8@%1 -8@%2 -8@%3", GAUS_PROBE_ARG(a1), GAUS_PROBE_ARG(a2), GAUS_PROBE_ARG(a3),     \
+                    GAUS_PROBE_ARG(a4))
+#define GAUS_PROBE5(name, a1, a2, a3, a4, a5)                                                                         \
+    GAUS_PROBE_NOTE(name, "-8@%0 -8@%1 -8@%2 -8@%3 -8@%4", GAUS_PROBE_ARG(a1), GAUS_PROBE_ARG(a2),                   \
+                    GAUS_PROBE_ARG(a3), GAUS_PROBE_ARG(a4), GAUS_PROBE_ARG(a5))
+
+#else
+
+#define GAUS_PROBE1(name, a1) ((void)0)
+#define GAUS_PROBE2(name, a1, a2) ((void)0)
+#define GAUS_PROBE3(name, a1, a2, a3) ((void)0)
+#define GAUS_PROBE4(name, a1, a2, a3, a4) ((void)0)
+#define GAUS_PROBE5(name, a1, a2, a3, a4, a5) ((void)0)
+
+#endif
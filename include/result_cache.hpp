@@ -0,0 +1,179 @@
+#pragma once
+
+#include "gaussian.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+#include <pthread.h>
+#include <sys/mman.h>
+
+namespace store {
+
+// Pamięć podręczna rozwiązań w segmencie MAP_SHARED tworzonym przed fork(), więc wspólna dla wszystkich
+// procesów serwera. Czterodrożna asocjacja po skrócie całego układu; wpis mieści rozwiązanie do max_n.
+// Skrót nie wyklucza kolizji, więc wywołujący sprawdza trafienie z własną macierzą i odrzuca je przez reject().
+class SharedResultCache {
+public:
+    struct Stats {
+        std::size_t slots{};
+        std::size_t max_n{};
+        std::uint64_t hits{};
+        std::uint64_t misses{};
+        std::uint64_t inserts{};
+        std::uint64_t rejected{};
+    };
+
+    static constexpr std::size_t kWays = 4;
+
+    SharedResultCache(std::size_t bytes, std::size_t max_n) : max_n_(max_n) {
+        if (max_n_ == 0) {
+            throw std::invalid_argument("Result cache needs a positive max_n");
+        }
+        slot_bytes_ = sizeof(SlotHeader) + max_n_ * sizeof(double);
+        const std::size_t sets = std::max<std::size_t>(1, bytes / (slot_bytes_ * kWays));
+        bytes_ = sizeof(Header) + sets * kWays * slot_bytes_;
+
+        void *ptr = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) {
+            throw std::runtime_error(detail::errno_message("mmap result cache failed"));
+        }
+        base_ = static_cast<std::byte *>(ptr);
+        header_ = new (base_) Header{};
+        header_->sets = sets;
+
+        // Muteks współdzielony między procesami; "robust", bo proces może zginąć trzymając blokadę
+        pthread_mutexattr_t attr;
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+        pthread_mutex_init(&header_->mutex, &attr);
+        pthread_mutexattr_destroy(&attr);
+    }
+
+    ~SharedResultCache() { munmap(base_, bytes_); }
+
+    SharedResultCache(const SharedResultCache &) = delete;
+    SharedResultCache &operator=(const SharedResultCache &) = delete;
+
+    bool lookup(std::uint64_t key, std::size_t n, std::vector<double> &solution) {
+        if (n > max_n_) {
+            return false;
+        }
+        Lock lock(header_->mutex);
+        for (std::size_t way = 0; way < kWays; ++way) {
+            SlotHeader *slot = slot_at(key, way);
+            if (slot->valid && slot->key == key && slot->n == n) {
+                slot->last_use = ++header_->clock;
+                const double *values = values_of(slot);
+                solution.assign(values, values + n);
+                ++header_->hits;
+                return true;
+            }
+        }
+        ++header_->misses;
+        return false;
+    }
+
+    // Trafienie, które nie rozwiązuje układu wywołującego: wpis jest unieważniany i liczy się jak brak
+    void reject(std::uint64_t key, std::size_t n) {
+        Lock lock(header_->mutex);
+        for (std::size_t way = 0; way < kWays; ++way) {
+            SlotHeader *slot = slot_at(key, way);
+            if (slot->valid && slot->key == key && slot->n == n) {
+                slot->valid = 0;
+            }
+        }
+        --header_->hits;
+        ++header_->misses;
+        ++header_->rejected;
+    }
+
+    void insert(std::uint64_t key, const std::vector<double> &solution) {
+        const std::size_t n = solution.size();
+        if (n == 0 || n > max_n_) {
+            return;
+        }
+        Lock lock(header_->mutex);
+        SlotHeader *victim = nullptr;
+        for (std::size_t way = 0; way < kWays; ++way) {
+            SlotHeader *slot = slot_at(key, way);
+            if (slot->valid && slot->key == key) {
+                victim = slot;
+                break;
+            }
+            if (victim == nullptr || !slot->valid || (victim->valid && slot->last_use < victim->last_use)) {
+                victim = slot;
+            }
+        }
+        victim->valid = 0;
+        std::memcpy(values_of(victim), solution.data(), n * sizeof(double));
+        victim->key = key;
+        victim->n = n;
+        victim->last_use = ++header_->clock;
+        victim->valid = 1;
+        ++header_->inserts;
+    }
+
+    Stats stats() {
+        Lock lock(header_->mutex);
+        return Stats{header_->sets * kWays, max_n_, header_->hits, header_->misses, header_->inserts,
+                     header_->rejected};
+    }
+
+private:
+    struct Header {
+        pthread_mutex_t mutex;
+        std::size_t sets;
+        std::uint64_t clock;
+        std::uint64_t hits;
+        std::uint64_t misses;
+        std::uint64_t inserts;
+        std::uint64_t rejected;
+    };
+
+    struct SlotHeader {
+        std::uint64_t key;
+        std::uint64_t n;
+        std::uint64_t last_use;
+        std::uint64_t valid;
+    };
+
+    class Lock {
+    public:
+        explicit Lock(pthread_mutex_t &mutex) : mutex_(mutex) {
+            // Poprzedni właściciel zginął w trakcie zapisu: wpis i tak jest unieważniony przed kopiowaniem
+            if (pthread_mutex_lock(&mutex_) == EOWNERDEAD) {
+                pthread_mutex_consistent(&mutex_);
+            }
+        }
+        ~Lock() { pthread_mutex_unlock(&mutex_); }
+
+        Lock(const Lock &) = delete;
+        Lock &operator=(const Lock &) = delete;
+
+    private:
+        pthread_mutex_t &mutex_;
+    };
+
+    SlotHeader *slot_at(std::uint64_t key, std::size_t way) {
+        const std::size_t set = static_cast<std::size_t>(key % header_->sets);
+        return reinterpret_cast<SlotHeader *>(base_ + sizeof(Header) + (set * kWays + way) * slot_bytes_);
+    }
+
+    static double *values_of(SlotHeader *slot) { return reinterpret_cast<double *>(slot + 1); }
+
+    std::size_t max_n_;
+    std::size_t slot_bytes_{0};
+    std::size_t bytes_{0};
+    std::byte *base_{nullptr};
+    Header *header_{nullptr};
+};
+
+} // namespace store
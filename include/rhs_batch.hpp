@@ -0,0 +1,60 @@
+#pragma once
+
+#include "gaussian.hpp"
+#include "group_batch.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace batch {
+
+// Prawa strona czekająca na rozwiązanie z zapisanymi czynnikami; po rozwiązaniu `values` zawiera x
+struct RhsSlot : GroupSlot<RhsSlot> {
+    std::vector<double> values;
+};
+
+// Łączy prawe strony dla tych samych czynników LU w jeden blok n x k (GroupBatcher z kluczem czynników
+// i rozmiarem układu). Blok jest rozwiązywany jednym przejściem po L i U (lu_solve_block).
+class RhsBatcher {
+public:
+    using Stats = GroupBatcher<std::pair<std::uint64_t, std::size_t>, RhsSlot>::Stats;
+
+    RhsBatcher(std::size_t max_width, std::chrono::microseconds hold) : groups_(max_width, hold) {}
+
+    auto join(std::uint64_t key, RhsSlot &slot) { return groups_.join({key, slot.values.size()}, slot); }
+
+    // Chwila, do której lider przytrzymuje otwartą grupę (--rhs-batch-us) przed wejściem do harmonogramu
+    std::chrono::steady_clock::time_point deadline(const RhsSlot &leader) const { return groups_.deadline(leader); }
+
+    template <typename Resume>
+    void solve_group(std::uint64_t key, RhsSlot &leader, const LuView &factors, Resume &&resume) {
+        auto solve = [&factors](RhsSlot *const *slots, std::size_t k) {
+            const std::size_t n = factors.n;
+            std::vector<double> block(n * k);
+            for (std::size_t c = 0; c < k; ++c) {
+                const std::vector<double> &rhs = slots[c]->values;
+                for (std::size_t i = 0; i < n; ++i) {
+                    block[i * k + c] = rhs[i];
+                }
+            }
+            lu_solve_block(factors, block.data(), k);
+            for (std::size_t c = 0; c < k; ++c) {
+                std::vector<double> &values = slots[c]->values;
+                for (std::size_t i = 0; i < n; ++i) {
+                    values[i] = block[i * k + c];
+                }
+            }
+        };
+        groups_.solve_group({key, leader.values.size()}, leader, solve, std::forward<Resume>(resume));
+    }
+
+    Stats stats() const { return groups_.stats(); }
+
+private:
+    GroupBatcher<std::pair<std::uint64_t, std::size_t>, RhsSlot> groups_;
+};
+
+} // namespace batch
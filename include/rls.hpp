@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <stdexcept>
+#include <vector>
+
+namespace rls {
+
+// Rekursywne najmniejsze kwadraty min ||A x - b|| na rosnącym (lub przesuwanym oknem) zbiorze wierszy.
+// Przechowuje tylko trójkątny czynnik R (n x n) i z = Q^T b: dopisanie wiersza to obroty Givensa, usunięcie
+// najstarszego wiersza z okna to downdate Saundersa (LINPACK dchdd). Koszt O(n^2) na wiersz, rozwiązanie O(n^2).
+class RlsState {
+public:
+    struct Stats {
+        std::uint64_t updates{};
+        std::uint64_t downdates{};
+        std::uint64_t refactorizations{};
+    };
+
+    // window = 0: wszystkie wiersze; inaczej tylko ostatnie `window` wierszy
+    RlsState(std::size_t n, std::size_t window) : n_(n), window_(window), r_(n * n, 0.0), z_(n, 0.0) {
+        if (n_ == 0) {
+            throw std::invalid_argument("RLS needs at least one unknown");
+        }
+        if (window_ != 0 && window_ < n_) {
+            throw std::invalid_argument("RLS window must hold at least n rows");
+        }
+    }
+
+    std::size_t unknowns() const { return n_; }
+    std::size_t window() const { return window_; }
+    std::size_t rows() const { return rows_; }
+    const Stats &stats() const { return stats_; }
+
+    // count wierszy po n+1 wartości: współczynniki a i obserwacja b
+    void add_rows(const double *rows, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            const double *row = rows + i * (n_ + 1);
+            if (window_ != 0) {
+                if (history_.size() == window_) {
+                    const std::vector<double> oldest = std::move(history_.front());
+                    history_.pop_front();
+                    --rows_;
+                    if (!downdate(oldest.data(), oldest[n_])) {
+                        // Usunięcie wiersza jest źle uwarunkowane: R liczony od nowa z wierszy okna
+                        refactor();
+                    }
+                }
+                history_.emplace_back(row, row + n_ + 1);
+            }
+            update(row, row[n_]);
+            ++rows_;
+        }
+    }
+
+    // Rozwiązanie R x = z; pusty wektor, dopóki układ nie ma pełnego rzędu
+    std::vector<double> solve() const {
+        double scale = 0.0;
+        for (std::size_t k = 0; k < n_; ++k) {
+            scale = std::max(scale, std::fabs(r_[k * n_ + k]));
+        }
+        std::vector<double> x(n_, 0.0);
+        for (std::size_t k = n_; k-- > 0;) {
+            const double diagonal = r_[k * n_ + k];
+            if (!(std::fabs(diagonal) > scale * 1e-13) || scale == 0.0) {
+                return {};
+            }
+            double sum = z_[k];
+            for (std::size_t c = k + 1; c < n_; ++c) {
+                sum -= r_[k * n_ + c] * x[c];
+            }
+            x[k] = sum / diagonal;
+        }
+        return x;
+    }
+
+private:
+    // Obroty Givensa wprowadzające wiersz (a, b) do [R | z]
+    void update(const double *a, double b) {
+        std::vector<double> row(a, a + n_);
+        double rhs = b;
+        for (std::size_t k = 0; k < n_; ++k) {
+            if (row[k] == 0.0) {
+                continue;
+            }
+            double *r_row = &r_[k * n_];
+            const double radius = std::hypot(r_row[k], row[k]);
+            const double c = r_row[k] / radius;
+            const double s = row[k] / radius;
+            r_row[k] = radius;
+            row[k] = 0.0;
+            for (std::size_t j = k + 1; j < n_; ++j) {
+                const double upper = r_row[j];
+                r_row[j] = c * upper + s * row[j];
+                row[j] = c * row[j] - s * upper;
+            }
+            const double upper = z_[k];
+            z_[k] = c * upper + s * rhs;
+            rhs = c * rhs - s * upper;
+        }
+        ++stats_.updates;
+    }
+
+    // Usuwa wiersz (x, y) z [R | z]; false, gdy po usunięciu R traciłby dodatnią określoność
+    bool downdate(const double *x, double y) {
+        // R^T p = x
+        std::vector<double> p(n_, 0.0);
+        double norm = 0.0;
+        for (std::size_t j = 0; j < n_; ++j) {
+            double sum = x[j];
+            for (std::size_t i = 0; i < j; ++i) {
+                sum -= r_[i * n_ + j] * p[i];
+            }
+            const double diagonal = r_[j * n_ + j];
+            if (diagonal == 0.0) {
+                return false;
+            }
+            p[j] = sum / diagonal;
+            norm += p[j] * p[j];
+        }
+        if (norm >= 1.0 - 1e-12) {
+            return false;
+        }
+
+        std::vector<double> c(n_);
+        std::vector<double> s(n_);
+        double alpha = std::sqrt(1.0 - norm);
+        for (std::size_t i = n_; i-- > 0;) {
+            const double scale = alpha + std::fabs(p[i]);
+            const double a = alpha / scale;
+            const double b = p[i] / scale;
+            const double length = std::sqrt(a * a + b * b);
+            c[i] = a / length;
+            s[i] = b / length;
+            alpha = scale * length;
+        }
+
+        for (std::size_t j = 0; j < n_; ++j) {
+            double carry = 0.0;
+            for (std::size_t i = j + 1; i-- > 0;) {
+                const double value = r_[i * n_ + j];
+                const double next = c[i] * carry + s[i] * value;
+                r_[i * n_ + j] = c[i] * value - s[i] * carry;
+                carry = next;
+            }
+        }
+        double zeta = y;
+        for (std::size_t i = 0; i < n_; ++i) {
+            z_[i] = (z_[i] - s[i] * zeta) / c[i];
+            zeta = c[i] * zeta - s[i] * z_[i];
+        }
+        ++stats_.downdates;
+        return true;
+    }
+
+    void refactor() {
+        std::fill(r_.begin(), r_.end(), 0.0);
+        std::fill(z_.begin(), z_.end(), 0.0);
+        for (const auto &row : history_) {
+            update(row.data(), row[n_]);
+        }
+        ++stats_.refactorizations;
+    }
+
+    std::size_t n_;
+    std::size_t window_;
+    std::vector<double> r_; // górnotrójkątny, wierszami
+    std::vector<double> z_;
+    std::deque<std::vector<double>> history_; // wiersze okna (tylko gdy window_ != 0)
+    std::size_t rows_{0};
+    Stats stats_;
+};
+
+} // namespace rls
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "gaussian.hpp"
+#include "matrix.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace schur {
+
+// Kondensacja statyczna: niewiadome dzielone na wnętrze I i brzeg B,
+//   S = A_BB - A_BI A_II^{-1} A_IB,   g = b_B - A_BI A_II^{-1} b_I.
+// Wiersze i kolumny S oraz g są w kolejności indeksów brzegowych podanej przez wywołującego.
+struct Result {
+    std::size_t m{};
+    std::vector<double> complement; // m x m wierszami
+    std::vector<double> rhs;        // m wartości
+};
+
+// Koszt eliminacji n - m kolumn wnętrza: pełna eliminacja bez ostatnich m kroków, ok. 2/3 (n^3 - m^3)
+inline double estimate_flops(std::size_t n, std::size_t m) {
+    const double size = static_cast<double>(n);
+    const double kept = static_cast<double>(std::min(n, m));
+    return 2.0 / 3.0 * (size * size * size - kept * kept * kept) + 2.0 * size * size;
+}
+
+// Częściowa faktoryzacja macierzy rozszerzonej n x (n+1): k kroków eliminacji z wyborem elementu głównego
+// tylko wśród wierszy wnętrza, w workerach jak w lu_factor. Po nich prawy dolny blok to [S | g].
+inline Result condense(const CppMatrix &augmented, const std::vector<std::size_t> &interface,
+                       std::size_t max_processes = 0) {
+    detail::validate_augmented(augmented);
+    const std::size_t n = augmented.rows;
+    const std::size_t m = interface.size();
+    if (m == 0 || m > n) {
+        throw std::invalid_argument("Interface must contain between 1 and n unknowns");
+    }
+    std::vector<char> is_interface(n, 0);
+    for (std::size_t index : interface) {
+        if (index >= n || is_interface[index]) {
+            throw std::invalid_argument("Interface indices must be unique and smaller than n");
+        }
+        is_interface[index] = 1;
+    }
+
+    // Kolejność: najpierw wnętrze (rosnąco), potem brzeg w kolejności wywołującego
+    std::vector<std::size_t> order;
+    order.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!is_interface[i]) {
+            order.push_back(i);
+        }
+    }
+    const std::size_t k = order.size();
+    order.insert(order.end(), interface.begin(), interface.end());
+
+    const std::size_t width = n + 1;
+    detail::SharedWorkspace workspace(n, width);
+    double *shared_data = workspace.data();
+    for (std::size_t r = 0; r < n; ++r) {
+        const double *source = &augmented.data[order[r] * augmented.cols];
+        double *target = &shared_data[r * width];
+        for (std::size_t c = 0; c < n; ++c) {
+            target[c] = source[order[c]];
+        }
+        target[n] = source[n];
+    }
+    workspace.build_tiles();
+
+    if (k > 0) {
+        constexpr double kEpsilon = 1e-12;
+        detail::WorkerProcessPool workers(workspace, max_processes);
+        for (std::size_t col = 0; col < k; ++col) {
+            std::size_t best = col;
+            for (std::size_t row = col + 1; row < k; ++row) {
+                if (std::fabs(shared_data[row * width + col]) > std::fabs(shared_data[best * width + col])) {
+                    best = row;
+                }
+            }
+            if (std::fabs(shared_data[best * width + col]) < kEpsilon) {
+                throw std::runtime_error("Interior block is singular or ill-conditioned");
+            }
+            if (best != col) {
+                workspace.swap_rows(col, best);
+            }
+
+            GAUS_PROBE2(column__start, col, n);
+            workers.eliminate_column(col);
+            GAUS_PROBE2(column__end, col, n);
+        }
+        workers.shutdown();
+    }
+
+    Result result;
+    result.m = m;
+    result.complement.resize(m * m);
+    result.rhs.resize(m);
+    for (std::size_t r = 0; r < m; ++r) {
+        const double *row = &shared_data[(k + r) * width];
+        std::copy_n(row + k, m, &result.complement[r * m]);
+        result.rhs[r] = row[n];
+    }
+    return result;
+}
+
+} // namespace schur
@@ -0,0 +1,384 @@
+#pragma once
+
+#include "gaussian.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sparse {
+
+// Macierz rzadka n x n kolumnami (CSC): wiersze kolumny j to row_index[col_start[j] .. col_start[j+1]),
+// rosnąco i bez powtórzeń. Wartości leżą w osobnej tablicy w tej samej kolejności, więc wzorzec może być
+// wspólny dla wielu macierzy.
+struct Pattern {
+    std::size_t n{};
+    std::vector<std::uint32_t> col_start;
+    std::vector<std::uint32_t> row_index;
+
+    std::size_t nonzeros() const { return row_index.size(); }
+
+    bool operator==(const Pattern &other) const {
+        return n == other.n && col_start == other.col_start && row_index == other.row_index;
+    }
+};
+
+inline void validate(const Pattern &pattern) {
+    const std::size_t n = pattern.n;
+    if (n == 0 || pattern.col_start.size() != n + 1 || pattern.col_start[0] != 0 ||
+        pattern.col_start[n] != pattern.row_index.size()) {
+        throw std::invalid_argument("Sparse matrix needs n > 0 and n + 1 column starts ending at the nonzero count");
+    }
+    for (std::size_t j = 0; j < n; ++j) {
+        if (pattern.col_start[j] > pattern.col_start[j + 1]) {
+            throw std::invalid_argument("Sparse column starts must not decrease");
+        }
+        for (std::size_t p = pattern.col_start[j]; p < pattern.col_start[j + 1]; ++p) {
+            const bool sorted = p == pattern.col_start[j] || pattern.row_index[p] > pattern.row_index[p - 1];
+            if (pattern.row_index[p] >= n || !sorted) {
+                throw std::invalid_argument("Sparse row indices must be below n and strictly increasing in a column");
+            }
+        }
+    }
+}
+
+// 64-bitowy skrót wzorca (bez wartości) – klucz analizy symbolicznej
+inline std::uint64_t hash_pattern(const Pattern &pattern) {
+    std::uint64_t hash = 0x9e3779b97f4a7c15ULL ^ (static_cast<std::uint64_t>(pattern.n) * 0xff51afd7ed558ccdULL);
+    auto mix = [&hash](std::uint64_t value) {
+        hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+        hash *= 0xc4ceb9fe1a85ec53ULL;
+    };
+    for (std::uint32_t start : pattern.col_start) {
+        mix(start);
+    }
+    for (std::uint32_t row : pattern.row_index) {
+        mix(row);
+    }
+    hash ^= hash >> 33;
+    return hash;
+}
+
+// Wynik analizy symbolicznej wzorca, niezależny od wartości. LU bez wyboru elementu głównego na wzorcu A + A^T
+// w uporządkowaniu perm ma czynniki o tej samej strukturze: S_j (wiersze kolumny j w L poniżej przekątnej) to
+// zarazem kolumny wiersza j w U na prawo od przekątnej. Wartości czynników leżą w jednej tablicy:
+// [n przekątnych U | L według pozycji S | U według pozycji S].
+struct Symbolic {
+    Pattern pattern;                   // kopia do sprawdzenia kolizji skrótów
+    std::vector<std::uint32_t> perm;   // perm[k] = oryginalny indeks k-tej niewiadomej
+    std::vector<std::uint32_t> parent; // drzewo eliminacji; n = korzeń
+    std::vector<std::size_t> l_start;  // S_j = l_index[l_start[j] .. l_start[j+1]), rosnąco
+    std::vector<std::uint32_t> l_index;
+    // Wiersz j w L (kolumny k < j z j w S_k) z pozycją j w S_k: składniki aktualizacji kolumny j
+    std::vector<std::size_t> row_start;
+    std::vector<std::uint32_t> row_column;
+    std::vector<std::size_t> row_slot;
+    std::vector<std::size_t> value_slot; // niezerowy p macierzy -> miejsce w tablicy wartości czynników
+    double flops{};                      // koszt faktoryzacji numerycznej
+
+    std::size_t factor_nonzeros() const { return l_index.size(); }
+
+    std::size_t bytes() const {
+        return (pattern.col_start.size() + pattern.row_index.size() + perm.size() + parent.size() +
+                l_index.size() + row_column.size()) * sizeof(std::uint32_t) +
+               (l_start.size() + row_start.size() + row_slot.size() + value_slot.size()) * sizeof(std::size_t);
+    }
+};
+
+namespace detail {
+
+// Minimalny stopień na jawnym grafie eliminacji A + A^T: eliminowany jest węzeł o najmniejszej liczbie
+// sąsiadów, a jego sąsiedzi tworzą klikę (przyszłe wypełnienie). Remisy rozstrzyga mniejszy indeks.
+// Suma rozmiarów klik to liczba niezerowych L w tym uporządkowaniu; powyżej max_fill (0 = bez limitu)
+// analiza jest przerywana, zanim graf eliminacji zajmie więcej pamięci.
+inline std::vector<std::uint32_t> minimum_degree(std::vector<std::vector<std::uint32_t>> adjacency,
+                                                 std::size_t max_fill) {
+    const std::size_t n = adjacency.size();
+    std::set<std::pair<std::size_t, std::uint32_t>> queue;
+    for (std::size_t v = 0; v < n; ++v) {
+        queue.emplace(adjacency[v].size(), static_cast<std::uint32_t>(v));
+    }
+    std::vector<std::uint32_t> order;
+    order.reserve(n);
+    std::vector<std::uint32_t> merged;
+    std::size_t fill = 0;
+    while (!queue.empty()) {
+        const std::uint32_t v = queue.begin()->second;
+        queue.erase(queue.begin());
+        order.push_back(v);
+        const std::vector<std::uint32_t> clique = std::move(adjacency[v]);
+        adjacency[v].clear();
+        fill += clique.size();
+        if (max_fill != 0 && fill > max_fill) {
+            throw std::length_error("Sparse factors would exceed " + std::to_string(max_fill) + " nonzeros");
+        }
+        for (std::uint32_t u : clique) {
+            std::vector<std::uint32_t> &neighbours = adjacency[u];
+            queue.erase({neighbours.size(), u});
+            merged.clear();
+            std::set_union(neighbours.begin(), neighbours.end(), clique.begin(), clique.end(),
+                           std::back_inserter(merged));
+            merged.erase(std::remove_if(merged.begin(), merged.end(),
+                                        [u, v](std::uint32_t w) { return w == u || w == v; }),
+                         merged.end());
+            neighbours.swap(merged);
+            queue.emplace(neighbours.size(), u);
+        }
+    }
+    return order;
+}
+
+} // namespace detail
+
+// Uporządkowanie zmniejszające wypełnienie, drzewo eliminacji i struktura czynników. Koszt zależy od
+// wypełnienia, nie od wartości, więc wynik może być użyty dla każdej macierzy o tym samym wzorcu.
+// Wyjątek std::length_error, gdy factor_nonzeros() przekroczyłoby max_factor_nonzeros (0 = bez limitu).
+inline Symbolic analyze(const Pattern &pattern, std::size_t max_factor_nonzeros = 0) {
+    validate(pattern);
+    const std::size_t n = pattern.n;
+    Symbolic symbolic;
+    symbolic.pattern = pattern;
+
+    // Graf A + A^T bez przekątnej
+    std::vector<std::vector<std::uint32_t>> adjacency(n);
+    for (std::size_t j = 0; j < n; ++j) {
+        for (std::size_t p = pattern.col_start[j]; p < pattern.col_start[j + 1]; ++p) {
+            const std::uint32_t i = pattern.row_index[p];
+            if (i != j) {
+                adjacency[i].push_back(static_cast<std::uint32_t>(j));
+                adjacency[j].push_back(i);
+            }
+        }
+    }
+    for (auto &neighbours : adjacency) {
+        std::sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+    }
+    symbolic.perm = detail::minimum_degree(adjacency, max_factor_nonzeros);
+    std::vector<std::uint32_t> inverse(n);
+    for (std::size_t k = 0; k < n; ++k) {
+        inverse[symbolic.perm[k]] = static_cast<std::uint32_t>(k);
+    }
+
+    // S_j = (sąsiedzi j w grafie o numerach > j) ∪ (S_c \ {j} dla dzieci c w drzewie eliminacji)
+    std::vector<std::vector<std::uint32_t>> children(n);
+    std::vector<std::uint32_t> marker(n, std::numeric_limits<std::uint32_t>::max());
+    std::vector<std::uint32_t> column;
+    symbolic.parent.assign(n, static_cast<std::uint32_t>(n));
+    symbolic.l_start.assign(n + 1, 0);
+    for (std::size_t j = 0; j < n; ++j) {
+        column.clear();
+        marker[j] = static_cast<std::uint32_t>(j);
+        for (std::uint32_t neighbour : adjacency[symbolic.perm[j]]) {
+            const std::uint32_t i = inverse[neighbour];
+            if (i > j && marker[i] != j) {
+                marker[i] = static_cast<std::uint32_t>(j);
+                column.push_back(i);
+            }
+        }
+        for (std::uint32_t child : children[j]) {
+            for (std::size_t q = symbolic.l_start[child]; q < symbolic.l_start[child + 1]; ++q) {
+                const std::uint32_t i = symbolic.l_index[q];
+                if (marker[i] != j) {
+                    marker[i] = static_cast<std::uint32_t>(j);
+                    column.push_back(i);
+                }
+            }
+        }
+        std::sort(column.begin(), column.end());
+        symbolic.l_index.insert(symbolic.l_index.end(), column.begin(), column.end());
+        symbolic.l_start[j + 1] = symbolic.l_index.size();
+        if (!column.empty()) {
+            symbolic.parent[j] = column.front();
+            children[column.front()].push_back(static_cast<std::uint32_t>(j));
+        }
+        const double count = static_cast<double>(column.size());
+        symbolic.flops += 2.0 * count * count + count;
+    }
+
+    // Transpozycja struktury L: dla wiersza i kolumny k < i z pozycją i w S_k
+    const std::size_t factor_nonzeros = symbolic.l_index.size();
+    symbolic.row_start.assign(n + 1, 0);
+    for (std::uint32_t i : symbolic.l_index) {
+        ++symbolic.row_start[i + 1];
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        symbolic.row_start[i + 1] += symbolic.row_start[i];
+    }
+    symbolic.row_column.resize(factor_nonzeros);
+    symbolic.row_slot.resize(factor_nonzeros);
+    std::vector<std::size_t> next(symbolic.row_start.begin(), symbolic.row_start.end() - 1);
+    for (std::size_t k = 0; k < n; ++k) {
+        for (std::size_t q = symbolic.l_start[k]; q < symbolic.l_start[k + 1]; ++q) {
+            const std::size_t target = next[symbolic.l_index[q]]++;
+            symbolic.row_column[target] = static_cast<std::uint32_t>(k);
+            symbolic.row_slot[target] = q;
+        }
+    }
+
+    // Miejsce każdego niezerowego A w tablicy wartości czynników (po permutacji wierszy i kolumn)
+    symbolic.value_slot.resize(pattern.nonzeros());
+    auto position = [&symbolic](std::size_t column_index, std::uint32_t row) {
+        const auto first = symbolic.l_index.begin() + static_cast<std::ptrdiff_t>(symbolic.l_start[column_index]);
+        const auto last = symbolic.l_index.begin() + static_cast<std::ptrdiff_t>(symbolic.l_start[column_index + 1]);
+        return static_cast<std::size_t>(std::lower_bound(first, last, row) - symbolic.l_index.begin());
+    };
+    for (std::size_t c = 0; c < n; ++c) {
+        for (std::size_t p = pattern.col_start[c]; p < pattern.col_start[c + 1]; ++p) {
+            const std::uint32_t i = inverse[pattern.row_index[p]];
+            const std::uint32_t j = inverse[c];
+            if (i == j) {
+                symbolic.value_slot[p] = i;
+            } else if (i > j) {
+                symbolic.value_slot[p] = n + position(j, i);
+            } else {
+                symbolic.value_slot[p] = n + factor_nonzeros + position(i, j);
+            }
+        }
+    }
+    return symbolic;
+}
+
+// Czynniki numeryczne dla jednej macierzy o wzorcu `symbolic`
+struct Factors {
+    std::vector<double> values; // [przekątna U | L | U] jak w Symbolic
+    std::size_t perturbed{};    // elementy główne zastąpione progiem
+};
+
+// LU bez wyboru elementu głównego (left-looking, kolumna j z aktualizacji kolumn wiersza j w L). Zbyt mały
+// element główny jest zastępowany ±pivot_floor (statyczny wybór jak w SuperLU_DIST); dokładność odzyskuje
+// poprawianie iteracyjne w solve.
+inline Factors factor(const Symbolic &symbolic, const double *values, double pivot_floor) {
+    const std::size_t n = symbolic.pattern.n;
+    const std::size_t factor_nonzeros = symbolic.factor_nonzeros();
+    Factors factors;
+    factors.values.assign(n + 2 * factor_nonzeros, 0.0);
+    for (std::size_t p = 0; p < symbolic.value_slot.size(); ++p) {
+        factors.values[symbolic.value_slot[p]] += values[p];
+    }
+    double *diagonal = factors.values.data();
+    double *lower = diagonal + n;
+    double *upper = lower + factor_nonzeros;
+
+    std::vector<std::size_t> where(n);
+    for (std::size_t j = 0; j < n; ++j) {
+        for (std::size_t q = symbolic.l_start[j]; q < symbolic.l_start[j + 1]; ++q) {
+            where[symbolic.l_index[q]] = q;
+        }
+        for (std::size_t t = symbolic.row_start[j]; t < symbolic.row_start[j + 1]; ++t) {
+            const std::size_t k = symbolic.row_column[t];
+            const std::size_t slot = symbolic.row_slot[t];
+            const double l_jk = lower[slot];
+            const double u_kj = upper[slot];
+            diagonal[j] -= l_jk * u_kj;
+            // Reszta S_k (wiersze > j) zawiera się w S_j
+            for (std::size_t q = slot + 1; q < symbolic.l_start[k + 1]; ++q) {
+                const std::size_t target = where[symbolic.l_index[q]];
+                lower[target] -= lower[q] * u_kj;
+                upper[target] -= l_jk * upper[q];
+            }
+        }
+        if (!(std::fabs(diagonal[j]) >= pivot_floor)) {
+            diagonal[j] = diagonal[j] < 0.0 ? -pivot_floor : pivot_floor;
+            ++factors.perturbed;
+        }
+        const double inverse = 1.0 / diagonal[j];
+        for (std::size_t q = symbolic.l_start[j]; q < symbolic.l_start[j + 1]; ++q) {
+            lower[q] *= inverse;
+        }
+    }
+    return factors;
+}
+
+// x = (LU)^{-1} b w oryginalnej numeracji niewiadomych
+inline std::vector<double> substitute(const Symbolic &symbolic, const Factors &factors, const double *b) {
+    const std::size_t n = symbolic.pattern.n;
+    const double *diagonal = factors.values.data();
+    const double *lower = diagonal + n;
+    const double *upper = lower + symbolic.factor_nonzeros();
+    std::vector<double> z(n);
+    for (std::size_t k = 0; k < n; ++k) {
+        z[k] = b[symbolic.perm[k]];
+    }
+    for (std::size_t j = 0; j < n; ++j) {
+        const double value = z[j];
+        for (std::size_t q = symbolic.l_start[j]; q < symbolic.l_start[j + 1]; ++q) {
+            z[symbolic.l_index[q]] -= lower[q] * value;
+        }
+    }
+    for (std::size_t j = n; j-- > 0;) {
+        double value = z[j];
+        for (std::size_t q = symbolic.l_start[j]; q < symbolic.l_start[j + 1]; ++q) {
+            value -= upper[q] * z[symbolic.l_index[q]];
+        }
+        z[j] = value / diagonal[j];
+    }
+    std::vector<double> x(n);
+    for (std::size_t k = 0; k < n; ++k) {
+        x[symbolic.perm[k]] = z[k];
+    }
+    return x;
+}
+
+struct Result {
+    std::vector<double> x;
+    std::size_t refinements{};
+    std::size_t perturbed{}; // elementy główne zastąpione progiem
+    double residual{};       // skalowana reszta jak w scaled_residual
+};
+
+// A x = b dla wartości `values` we wzorcu symbolic.pattern: faktoryzacja numeryczna, podstawienia i poprawianie
+// z oryginalną macierzą (refine z gaussian.hpp), aż skalowana reszta spadnie do poziomu double albo przestanie maleć
+inline Result solve(const Symbolic &symbolic, const double *values, const double *b,
+                    std::size_t max_refinements = 10) {
+    const Pattern &pattern = symbolic.pattern;
+    const std::size_t n = pattern.n;
+
+    // ||A||_inf (sumy wierszy) i próg elementu głównego sqrt(eps) ||A||
+    std::vector<double> row_sums(n, 0.0);
+    for (std::size_t p = 0; p < pattern.nonzeros(); ++p) {
+        row_sums[pattern.row_index[p]] += std::fabs(values[p]);
+    }
+    const double a_norm = n > 0 ? *std::max_element(row_sums.begin(), row_sums.end()) : 0.0;
+    const double pivot_floor = std::sqrt(std::numeric_limits<double>::epsilon()) * (a_norm > 0.0 ? a_norm : 1.0);
+    const Factors factors = factor(symbolic, values, pivot_floor);
+
+    double b_norm = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        b_norm = std::max(b_norm, std::fabs(b[i]));
+    }
+    Result result;
+    result.perturbed = factors.perturbed;
+    result.x = substitute(symbolic, factors, b);
+    auto residual_of = [&](const std::vector<double> &x, std::vector<double> &residual) {
+        std::copy_n(b, n, residual.begin());
+        double x_norm = 0.0;
+        for (std::size_t c = 0; c < n; ++c) {
+            x_norm = std::max(x_norm, std::fabs(x[c]));
+            for (std::size_t p = pattern.col_start[c]; p < pattern.col_start[c + 1]; ++p) {
+                residual[pattern.row_index[p]] -= values[p] * x[c];
+            }
+        }
+        double r_norm = 0.0;
+        for (double value : residual) {
+            r_norm = std::max(r_norm, std::fabs(value));
+        }
+        const double scale = a_norm * x_norm + b_norm;
+        return scale > 0.0 ? r_norm / scale : r_norm;
+    };
+    auto correct = [&](const std::vector<double> &residual) { return substitute(symbolic, factors, residual.data()); };
+    const Refinement refinement = refine(result.x, max_refinements, residual_of, correct);
+    result.residual = refinement.residual;
+    result.refinements = refinement.corrections;
+    return result;
+}
+
+} // namespace sparse
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "matrix.hpp"
+
+#include <rpc/rpc.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace wire {
+
+// Od tego rozmiaru (liczba double) konwersja jest dzielona między wątki
+constexpr std::size_t kParallelDecodeMin = std::size_t{1} << 20;
+
+// Argument SOLVE_GAUSS dekodowany prosto do CppMatrix. Na łączu to ten sam format co Matrix z gaus_rpc.x:
+// rows, cols, długość tablicy i 8-bajtowe double big-endian, więc klienci rpcgen działają bez zmian.
+struct MatrixArgs {
+    CppMatrix matrix;
+    std::size_t threads{1};
+    std::size_t max_rows{0};      // większy układ jest odrzucany przed przydziałem bufora; 0 = bez limitu
+    std::size_t invalid_index{0}; // pierwszy element NaN/Inf, gdy dekodowanie zostało odrzucone
+    bool invalid{false};
+    bool too_large{false}; // rows > max_rows albo bufor nie mieści się w pamięci
+    bool misshapen{false}; // macierz nie ma wymiarów n x (n+1)
+};
+
+namespace detail {
+
+// Dzieli wiersze [0, rows) na ciągłe bloki; blok 0 liczy wątek wywołujący
+template <typename Body>
+void for_row_blocks(std::size_t rows, std::size_t threads, Body &&body) {
+    const std::size_t count = std::max<std::size_t>(1, std::min(threads, rows));
+    std::vector<std::thread> workers;
+    workers.reserve(count - 1);
+    for (std::size_t t = 1; t < count; ++t) {
+        workers.emplace_back([&body, t, rows, count]() { body(rows * t / count, rows * (t + 1) / count); });
+    }
+    body(0, rows / count);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+// Bufor powstaje bez zerowania, więc świeżo zmapowane strony nie były jeszcze dotykane. Strony oddawane są
+// też jądru (MADV_DONTNEED; dotyczy bufora ze sterty używanej już wcześniej, zawartość i tak zostanie nadpisana),
+// a potem dotykane przez wątek, który będzie konwertował dany blok wierszy: pierwszy dotyk umieszcza stronę
+// w węźle NUMA tego wątku.
+inline void place_rows(CppMatrix &matrix, std::size_t threads) {
+    const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    auto *bytes = reinterpret_cast<unsigned char *>(matrix.data.data());
+    const std::size_t size = matrix.data.size() * sizeof(double);
+    const auto begin = (reinterpret_cast<std::uintptr_t>(bytes) + page - 1) / page * page;
+    const auto end = (reinterpret_cast<std::uintptr_t>(bytes) + size) / page * page;
+    if (end <= begin || madvise(reinterpret_cast<void *>(begin), end - begin, MADV_DONTNEED) != 0) {
+        return;
+    }
+    const std::size_t row_bytes = matrix.cols * sizeof(double);
+    for_row_blocks(matrix.rows, threads, [&](std::size_t first, std::size_t last) {
+        volatile unsigned char *block = bytes + first * row_bytes;
+        for (std::size_t offset = 0; offset < (last - first) * row_bytes; offset += page) {
+            block[offset] = 0;
+        }
+    });
+}
+
+// Zamiana kolejności bajtów w miejscu i kontrola skończoności; zwraca indeks pierwszej złej wartości albo count
+inline std::size_t swap_and_validate(double *values, std::size_t count) {
+    std::size_t bad = count;
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint64_t bits = 0;
+        std::memcpy(&bits, &values[i], sizeof(bits));
+        if constexpr (std::endian::native == std::endian::little) {
+            bits = __builtin_bswap64(bits);
+        }
+        if (((bits >> 52) & 0x7ff) == 0x7ff && bad == count) {
+            bad = i;
+        }
+        std::memcpy(&values[i], &bits, sizeof(bits));
+    }
+    return bad;
+}
+
+} // namespace detail
+
+// Procedura XDR (tylko dekodowanie): surowe bajty tablicy trafiają od razu do bufora macierzy,
+// a zamiana bajtów i walidacja idą równolegle blokami wierszy
+inline bool_t xdr_matrix_parallel(XDR *xdrs, MatrixArgs *args) {
+    if (xdrs->x_op == XDR_FREE) {
+        return TRUE;
+    }
+    if (xdrs->x_op != XDR_DECODE) {
+        return FALSE;
+    }
+
+    u_int rows = 0;
+    u_int cols = 0;
+    u_int length = 0;
+    if (!xdr_u_int(xdrs, &rows) || !xdr_u_int(xdrs, &cols) || !xdr_u_int(xdrs, &length)) {
+        return FALSE;
+    }
+    if (static_cast<std::uint64_t>(rows) * cols != length) {
+        return FALSE;
+    }
+
+    CppMatrix &matrix = args->matrix;
+    matrix.rows = rows;
+    matrix.cols = cols;
+    // Układ rozszerzony [A | b]: inny kształt jest odrzucany przed przydziałem bufora
+    if (rows == 0 || static_cast<std::uint64_t>(cols) != static_cast<std::uint64_t>(rows) + 1) {
+        args->misshapen = true;
+        return FALSE;
+    }
+    if (args->max_rows != 0 && rows > args->max_rows) {
+        args->too_large = true;
+        return FALSE;
+    }
+    try {
+        memory::SkipZeroFill uninitialized;
+        matrix.data.resize(length);
+    } catch (const std::exception &) {
+        args->too_large = true;
+        return FALSE;
+    }
+    const bool parallel = args->threads > 1 && length >= kParallelDecodeMin;
+    if (parallel) {
+        detail::place_rows(matrix, args->threads);
+    }
+
+    // xdr_opaque przyjmuje u_int; kawałki są wielokrotnością 4 bajtów, więc nie ma dopełnienia
+    constexpr std::size_t kChunkBytes = std::size_t{1} << 30;
+    auto *bytes = reinterpret_cast<char *>(matrix.data.data());
+    const std::size_t total = static_cast<std::size_t>(length) * sizeof(double);
+    for (std::size_t offset = 0; offset < total; offset += kChunkBytes) {
+        const auto chunk = static_cast<u_int>(std::min(kChunkBytes, total - offset));
+        if (!xdr_opaque(xdrs, bytes + offset, chunk)) {
+            return FALSE;
+        }
+    }
+
+    std::atomic<std::size_t> first_bad{length};
+    auto convert = [&](std::size_t first, std::size_t last) {
+        const std::size_t begin = first * cols;
+        const std::size_t bad = detail::swap_and_validate(matrix.data.data() + begin, (last - first) * cols);
+        if (bad != (last - first) * cols) {
+            std::size_t seen = first_bad.load();
+            while (begin + bad < seen && !first_bad.compare_exchange_weak(seen, begin + bad)) {
+            }
+        }
+    };
+    if (parallel) {
+        detail::for_row_blocks(rows, args->threads, convert);
+    } else {
+        convert(0, rows);
+    }
+
+    if (first_bad.load() != length) {
+        args->invalid = true;
+        args->invalid_index = first_bad.load();
+        return FALSE;
+    }
+    return TRUE;
+}
+
+} // namespace wire
@@ -1,23 +1,38 @@
 #include "gaus_rpc.h"
 #include "../include/matrix.hpp"
+#include "../include/native_wire.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
+#include <random>
 #include <string>
 #include <vector>
 
 #include <sys/time.h>
+#include <unistd.h>
 
 namespace {
 
 void print_usage(const char *prog) {
     std::cerr << "Użycie: " << prog
-              << " <host> <mode> [rows cols]\n"
+              << " <host> <mode> [rows cols | nx ny [nz] | n window batches | chains blocks b | n m | n reps [port]\n"
+              << "               | n steps | k reps]\n"
               << "  mode = r  -> macierz losowa (wymaga rows cols)\n"
-              << "  mode = p  -> predefiniowana macierz 3x4 z oczekiwanym wynikiem\n";
+              << "  mode = p  -> predefiniowana macierz 3x4 z oczekiwanym wynikiem\n"
+              << "  mode = s  -> statystyki serwera (pamięć ostatnich żądań, tenanci)\n"
+              << "  mode = g  -> równanie Poissona na siatce nx ny [nz] rozwiązywane multigridem bez macierzy\n"
+              << "  mode = t  -> łańcuchy blokowo-trójdiagonalne: chains łańcuchów po blocks bloków b x b\n"
+              << "  mode = l  -> regresja strumieniowa (RLS): n niewiadomych, okno wierszy (0 = bez okna), liczba paczek\n"
+              << "  mode = c  -> dopełnienie Schura losowego układu n x n na ostatnich m niewiadomych\n"
+              << "  mode = w  -> porównanie ONC RPC i protokołu natywnego (--native-port serwera): reps układów n x n\n"
+              << "  mode = e  -> porównanie silników (gaussian.hpp, LAPACK LU i Cholesky, RBT): reps układów n x n\n"
+              << "  mode = n  -> ciąg steps dryfujących macierzy n x n jednej rodziny SOLVE_NEARBY (GMRES, stare LU)\n"
+              << "  mode = z  -> reps układów rzadkich SOLVE_SPARSE o tym samym wzorcu (siatka k x k, 5 punktów)\n"
+              << "Zmienna GAUS_TENANT ustawia nazwę tenanta (poświadczenia AUTH_SYS) dla harmonogramu serwera.\n";
 }
 
 void print_matrix(const CppMatrix &m) {
@@ -59,6 +74,690 @@ void print_vector(const std::vector<double> &values, const std::string &label) {
     std::cout << "]\n";
 }
 
+// Nazwa tenanta trafia do pola machname poświadczeń AUTH_SYS
+void apply_tenant(CLIENT *clnt) {
+    const char *tenant = std::getenv("GAUS_TENANT");
+    if (tenant == nullptr || tenant[0] == '\0') {
+        return;
+    }
+    AUTH *auth = authunix_create(const_cast<char *>(tenant), getuid(), getgid(), 0, NULL);
+    if (auth != NULL) {
+        auth_destroy(clnt->cl_auth);
+        clnt->cl_auth = auth;
+    }
+}
+
+int print_server_stats(const char *host) {
+    CLIENT *clnt = clnt_create(const_cast<char *>(host), GAUSS_RPC, GAUSS_V, const_cast<char *>("tcp"));
+    if (clnt == NULL) {
+        clnt_pcreateerror(const_cast<char *>(host));
+        return 1;
+    }
+
+    Report *report = get_stats_1(NULL, clnt);
+    if (report == NULL) {
+        clnt_perror(clnt, const_cast<char *>(host));
+        clnt_destroy(clnt);
+        return 1;
+    }
+
+    std::cout << *report;
+    xdr_free(reinterpret_cast<xdrproc_t>(xdr_Report), reinterpret_cast<char *>(report));
+    clnt_destroy(clnt);
+    return 0;
+}
+
+// -laplasjan na siatce jednostkowej z krokiem h = 1/(nx+1); prawa strona z dyskretnego rozwiązania wzorcowego
+int solve_poisson_stencil(const char *host, unsigned int nx, unsigned int ny, unsigned int nz) {
+    const double h = 1.0 / (nx + 1);
+    const double inv_h2 = 1.0 / (h * h);
+    const std::size_t points = static_cast<std::size_t>(nx) * ny * nz;
+
+    std::vector<double> exact(points);
+    std::vector<double> rhs(points);
+    for (std::size_t p = 0; p < points; ++p) {
+        const double x = (p % nx + 1) * h;
+        const double y = ((p / nx) % ny + 1) * h;
+        const double z = (p / (static_cast<std::size_t>(nx) * ny) + 1) * h;
+        exact[p] = std::sin(3.0 * x) * std::cos(2.0 * y) * (1.0 + z);
+    }
+
+    Stencil stencil{};
+    stencil.nx = nx;
+    stencil.ny = ny;
+    stencil.nz = nz;
+    stencil.off_x = -inv_h2;
+    stencil.off_y = -inv_h2;
+    stencil.off_z = nz > 1 ? -inv_h2 : 0.0;
+    stencil.center = -2.0 * (stencil.off_x + stencil.off_y + stencil.off_z);
+    stencil.tolerance = 1e-10;
+    stencil.max_cycles = 50;
+
+    const std::size_t plane = static_cast<std::size_t>(nx) * ny;
+    for (std::size_t p = 0; p < points; ++p) {
+        const std::size_t i = p % nx;
+        const std::size_t j = (p / nx) % ny;
+        const std::size_t k = p / plane;
+        double value = stencil.center * exact[p];
+        value += stencil.off_x * ((i > 0 ? exact[p - 1] : 0.0) + (i + 1 < nx ? exact[p + 1] : 0.0));
+        value += stencil.off_y * ((j > 0 ? exact[p - nx] : 0.0) + (j + 1 < ny ? exact[p + nx] : 0.0));
+        value += stencil.off_z * ((k > 0 ? exact[p - plane] : 0.0) + (k + 1 < nz ? exact[p + plane] : 0.0));
+        rhs[p] = value;
+    }
+    stencil.rhs.rhs_len = static_cast<u_int>(points);
+    stencil.rhs.rhs_val = rhs.data();
+
+    CLIENT *clnt = clnt_create(const_cast<char *>(host), GAUSS_RPC, GAUSS_V, const_cast<char *>("tcp"));
+    if (clnt == NULL) {
+        clnt_pcreateerror(const_cast<char *>(host));
+        return 1;
+    }
+    apply_tenant(clnt);
+    timeval timeout{};
+    timeout.tv_sec = 300;
+    clnt_control(clnt, CLSET_TIMEOUT, reinterpret_cast<char *>(&timeout));
+
+    std::cout << "Siatka " << nx << "x" << ny << "x" << nz << " (" << points << " niewiadomych)\n";
+    Solution *result = solve_stencil_1(&stencil, clnt);
+    if (result == NULL) {
+        clnt_perror(clnt, const_cast<char *>(host));
+        clnt_destroy(clnt);
+        return 1;
+    }
+
+    double max_err = 0.0;
+    for (std::size_t p = 0; p < points && p < result->values.values_len; ++p) {
+        max_err = std::max(max_err, std::fabs(result->values.values_val[p] - exact[p]));
+    }
+    std::cout << "Maksymalny błąd względem rozwiązania wzorcowego: " << std::setprecision(3) << std::scientific
+              << max_err << "\n";
+
+    xdr_free(reinterpret_cast<xdrproc_t>(xdr_Solution), reinterpret_cast<char *>(result));
+    clnt_destroy(clnt);
+    return 0;
+}
+
+// Losowe łańcuchy z przekątną dominującą; wynik sprawdzany residuum po stronie klienta
+int solve_block_chains(const char *host, unsigned int chains, unsigned int blocks, unsigned int b) {
+    const std::size_t area = static_cast<std::size_t>(b) * b;
+    const std::size_t count = static_cast<std::size_t>(chains) * blocks;
+    const std::size_t links = static_cast<std::size_t>(chains) * (blocks - 1);
+    std::mt19937 gen(std::random_device{}());
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    std::vector<double> lower(links * area);
+    std::vector<double> diag(count * area);
+    std::vector<double> upper(links * area);
+    std::vector<double> rhs(count * b);
+    for (auto *values : {&lower, &diag, &upper, &rhs}) {
+        for (auto &value : *values) {
+            value = dist(gen);
+        }
+    }
+    for (std::size_t block = 0; block < count; ++block) {
+        for (std::size_t i = 0; i < b; ++i) {
+            diag[block * area + i * b + i] += 3.0 * b;
+        }
+    }
+
+    BlockTridiag request{};
+    request.chains = chains;
+    request.blocks = blocks;
+    request.b = b;
+    request.lower.lower_len = static_cast<u_int>(lower.size());
+    request.lower.lower_val = lower.data();
+    request.diag.diag_len = static_cast<u_int>(diag.size());
+    request.diag.diag_val = diag.data();
+    request.upper.upper_len = static_cast<u_int>(upper.size());
+    request.upper.upper_val = upper.data();
+    request.rhs.rhs_len = static_cast<u_int>(rhs.size());
+    request.rhs.rhs_val = rhs.data();
+
+    CLIENT *clnt = clnt_create(const_cast<char *>(host), GAUSS_RPC, GAUSS_V, const_cast<char *>("tcp"));
+    if (clnt == NULL) {
+        clnt_pcreateerror(const_cast<char *>(host));
+        return 1;
+    }
+    apply_tenant(clnt);
+    timeval timeout{};
+    timeout.tv_sec = 300;
+    clnt_control(clnt, CLSET_TIMEOUT, reinterpret_cast<char *>(&timeout));
+
+    std::cout << chains << " łańcuchów po " << blocks << " bloków " << b << "x" << b << " (" << count * b
+              << " niewiadomych)\n";
+    Solution *result = solve_block_tridiag_1(&request, clnt);
+    if (result == NULL) {
+        clnt_perror(clnt, const_cast<char *>(host));
+        clnt_destroy(clnt);
+        return 1;
+    }
+
+    double max_residual = 0.0;
+    if (result->values.values_len == count * b) {
+        const double *x = result->values.values_val;
+        for (std::size_t chain = 0; chain < chains; ++chain) {
+            for (std::size_t i = 0; i < blocks; ++i) {
+                const std::size_t block = chain * blocks + i;
+                for (std::size_t row = 0; row < b; ++row) {
+                    double value = -rhs[block * b + row];
+                    for (std::size_t k = 0; k < b; ++k) {
+                        value += diag[block * area + row * b + k] * x[block * b + k];
+                        if (i > 0) {
+                            value += lower[(chain * (blocks - 1) + i - 1) * area + row * b + k] * x[(block - 1) * b + k];
+                        }
+                        if (i + 1 < blocks) {
+                            value += upper[(chain * (blocks - 1) + i) * area + row * b + k] * x[(block + 1) * b + k];
+                        }
+                    }
+                    max_residual = std::max(max_residual, std::fabs(value));
+                }
+            }
+        }
+    }
+    std::cout << "Maksymalne residuum: " << std::setprecision(3) << std::scientific << max_residual << "\n";
+
+    xdr_free(reinterpret_cast<xdrproc_t>(xdr_Solution), reinterpret_cast<char *>(result));
+    clnt_destroy(clnt);
+    return 0;
+}
+
+// Paczki wierszy z zaszumionego modelu liniowego dopisywane do jednej sesji RLS; po każdej paczce
+// serwer zwraca bieżące rozwiązanie najmniejszych kwadratów
+int stream_regression(const char *host, unsigned int n, unsigned int window, unsigned int batches) {
+    CLIENT *clnt = clnt_create(const_cast<char *>(host), GAUSS_RPC, GAUSS_V, const_cast<char *>("tcp"));
+    if (clnt == NULL) {
+        clnt_pcreateerror(const_cast<char *>(host));
+        return 1;
+    }
+    apply_tenant(clnt);
+
+    RlsOpen open{};
+    open.n = n;
+    open.window = window;
+    u_quad_t *session = rls_open_1(&open, clnt);
+    if (session == NULL || *session == 0) {
+        std::cerr << "Serwer odrzucił sesję RLS.\n";
+        clnt_destroy(clnt);
+        return 1;
+    }
+    const u_quad_t id = *session;
+
+    std::vector<double> model(n);
+    for (unsigned int j = 0; j < n; ++j) {
+        model[j] = 1.0 + j;
+    }
+    std::mt19937 gen(std::random_device{}());
+    std::uniform_real_distribution<double> coefficient(-1.0, 1.0);
+    std::uniform_real_distribution<double> noise(-5e-4, 5e-4);
+    const unsigned int batch_rows = std::max(1u, n);
+    std::vector<double> data(static_cast<std::size_t>(batch_rows) * (n + 1));
+    int status = 0;
+    for (unsigned int batch = 0; batch < batches; ++batch) {
+        for (unsigned int r = 0; r < batch_rows; ++r) {
+            double *row = &data[static_cast<std::size_t>(r) * (n + 1)];
+            double b = noise(gen);
+            for (unsigned int j = 0; j < n; ++j) {
+                row[j] = coefficient(gen);
+                b += row[j] * model[j];
+            }
+            row[n] = b;
+        }
+        RlsRows rows{};
+        rows.session = id;
+        rows.rows = batch_rows;
+        rows.data.data_len = static_cast<u_int>(data.size());
+        rows.data.data_val = data.data();
+        Solution *result = rls_update_1(&rows, clnt);
+        if (result == NULL) {
+            clnt_perror(clnt, const_cast<char *>(host));
+            status = 1;
+            break;
+        }
+        double max_err = 0.0;
+        for (unsigned int j = 0; j < n && j < result->values.values_len; ++j) {
+            max_err = std::max(max_err, std::fabs(result->values.values_val[j] - model[j]));
+        }
+        std::cout << "Paczka " << batch + 1 << ": maksymalny błąd współczynników " << std::setprecision(3)
+                  << std::scientific << max_err << "\n";
+        xdr_free(reinterpret_cast<xdrproc_t>(xdr_Solution), reinterpret_cast<char *>(result));
+    }
+
+    u_quad_t close_id = id;
+    rls_close_1(&close_id, clnt);
+    clnt_destroy(clnt);
+    return status;
+}
+
+// Dopełnienie Schura na ostatnich m niewiadomych; x_B z pełnego rozwiązania (SOLVE_GAUSS) musi spełniać S x_B = g
+int condense_interface(const char *host, unsigned int n, unsigned int m) {
+    CppMatrix augmented = make_random_matrix(n, n + 1);
+    for (unsigned int i = 0; i < n; ++i) {
+        augmented(i, i) += 200.0 * n;
+    }
+    std::vector<double> matrix(static_cast<std::size_t>(n) * n);
+    std::vector<double> rhs(n);
+    for (unsigned int r = 0; r < n; ++r) {
+        const std::size_t row = r;
+        std::copy_n(&augmented.data[row * (n + 1)], n, &matrix[row * n]);
+        rhs[r] = augmented(r, n);
+    }
+    std::vector<u_int> interface(m);
+    for (unsigned int i = 0; i < m; ++i) {
+        interface[i] = n - m + i;
+    }
+
+    SchurRequest request{};
+    request.n = n;
+    request.matrix.matrix_len = static_cast<u_int>(matrix.size());
+    request.matrix.matrix_val = matrix.data();
+    request.rhs.rhs_len = n;
+    request.rhs.rhs_val = rhs.data();
+    request.interface.interface_len = m;
+    request.interface.interface_val = interface.data();
+
+    CLIENT *clnt = clnt_create(const_cast<char *>(host), GAUSS_RPC, GAUSS_V, const_cast<char *>("tcp"));
+    if (clnt == NULL) {
+        clnt_pcreateerror(const_cast<char *>(host));
+        return 1;
+    }
+    apply_tenant(clnt);
+    timeval timeout{};
+    timeout.tv_sec = 300;
+    clnt_control(clnt, CLSET_TIMEOUT, reinterpret_cast<char *>(&timeout));
+
+    SchurResult *condensed = schur_complement_1(&request, clnt);
+    if (condensed == NULL) {
+        clnt_perror(clnt, const_cast<char *>(host));
+        clnt_destroy(clnt);
+        return 1;
+    }
+    std::cout << "Dopełnienie Schura " << condensed->m << "x" << condensed->m << " z układu " << n << "x" << n
+              << "\n";
+
+    Matrix full{};
+    full.rows = n;
+    full.cols = n + 1;
+    full.data.data_len = static_cast<u_int>(augmented.data.size());
+    full.data.data_val = augmented.data.data();
+    Solution *solved = solve_gauss_1(&full, clnt);
+    int status = 0;
+    if (solved == NULL) {
+        clnt_perror(clnt, const_cast<char *>(host));
+        status = 1;
+    } else if (condensed->m != m || solved->values.values_len != n) {
+        std::cerr << "Niezgodne rozmiary odpowiedzi.\n";
+        status = 1;
+    } else {
+        const double *x_b = solved->values.values_val + (n - m);
+        double max_residual = 0.0;
+        for (unsigned int r = 0; r < m; ++r) {
+            double value = -condensed->rhs.rhs_val[r];
+            for (unsigned int c = 0; c < m; ++c) {
+                value += condensed->complement.complement_val[static_cast<std::size_t>(r) * m + c] * x_b[c];
+            }
+            max_residual = std::max(max_residual, std::fabs(value));
+        }
+        std::cout << "Maksymalne residuum S x_B - g: " << std::setprecision(3) << std::scientific << max_residual
+                  << "\n";
+    }
+
+    if (solved != NULL) {
+        xdr_free(reinterpret_cast<xdrproc_t>(xdr_Solution), reinterpret_cast<char *>(solved));
+    }
+    xdr_free(reinterpret_cast<xdrproc_t>(xdr_SchurResult), reinterpret_cast<char *>(condensed));
+    clnt_destroy(clnt);
+    return status;
+}
+
+// Ten sam układ wysyłany reps razy przez ONC RPC (TCP) i protokołem natywnym, po jednym niemierzonym wywołaniu
+// rozgrzewającym każdą drogą. Czasy obejmują kodowanie, przesył, rozwiązanie i dekodowanie odpowiedzi; przy
+// --result-cache-mb serwer odpowiada z pamięci wyników, więc różnica to koszt XDR i warstwy rekordów TIRPC.
+int compare_protocols(const char *host, unsigned int n, unsigned int reps, unsigned int native_port) {
+    CppMatrix augmented = make_random_matrix(n, n + 1);
+    for (unsigned int i = 0; i < n; ++i) {
+        augmented(i, i) += 200.0 * n;
+    }
+    const char *tenant = std::getenv("GAUS_TENANT");
+
+    CLIENT *clnt = clnt_create(const_cast<char *>(host), GAUSS_RPC, GAUSS_V, const_cast<char *>("tcp"));
+    if (clnt == NULL) {
+        clnt_pcreateerror(const_cast<char *>(host));
+        return 1;
+    }
+    apply_tenant(clnt);
+    timeval timeout{};
+    timeout.tv_sec = 300;
+    clnt_control(clnt, CLSET_TIMEOUT, reinterpret_cast<char *>(&timeout));
+
+    Matrix rpc_matrix{};
+    rpc_matrix.rows = n;
+    rpc_matrix.cols = n + 1;
+    rpc_matrix.data.data_len = static_cast<u_int>(augmented.data.size());
+    rpc_matrix.data.data_val = augmented.data.data();
+
+    using Clock = std::chrono::steady_clock;
+    std::vector<double> rpc_us;
+    std::vector<double> native_us;
+    std::vector<double> rpc_solution;
+    std::vector<double> native_solution;
+    int status = 0;
+    for (unsigned int rep = 0; rep <= reps; ++rep) {
+        const auto start = Clock::now();
+        Solution *result = solve_gauss_1(&rpc_matrix, clnt);
+        if (result == NULL) {
+            clnt_perror(clnt, const_cast<char *>(host));
+            status = 1;
+            break;
+        }
+        if (rep > 0) {
+            rpc_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        }
+        rpc_solution.assign(result->values.values_val, result->values.values_val + result->values.values_len);
+        xdr_free(reinterpret_cast<xdrproc_t>(xdr_Solution), reinterpret_cast<char *>(result));
+    }
+    clnt_destroy(clnt);
+
+    try {
+        native::Client client(host, static_cast<std::uint16_t>(native_port));
+        for (unsigned int rep = 0; rep <= reps && status == 0; ++rep) {
+            const auto start = Clock::now();
+            native_solution = client.solve(augmented, tenant != nullptr ? tenant : "");
+            if (rep > 0) {
+                native_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+            }
+        }
+    } catch (const std::exception &ex) {
+        std::cerr << "Protokół natywny: " << ex.what() << "\n";
+        status = 1;
+    }
+    if (status != 0) {
+        return status;
+    }
+
+    double max_delta = rpc_solution.size() == native_solution.size() ? 0.0 : INFINITY;
+    for (std::size_t i = 0; i < rpc_solution.size() && i < native_solution.size(); ++i) {
+        max_delta = std::max(max_delta, std::fabs(rpc_solution[i] - native_solution[i]));
+    }
+    const double megabytes = static_cast<double>(augmented.data.size() + n) * sizeof(double) / (1024.0 * 1024.0);
+    auto report = [&](const char *label, std::vector<double> &samples) {
+        std::sort(samples.begin(), samples.end());
+        double total = 0.0;
+        for (double sample : samples) {
+            total += sample;
+        }
+        const double mean = total / samples.size();
+        std::cout << std::left << std::setw(10) << label << std::right << std::fixed << std::setprecision(1)
+                  << " średnio " << std::setw(10) << mean << " us, mediana " << std::setw(10)
+                  << samples[samples.size() / 2] << " us, " << std::setprecision(1) << megabytes / (mean * 1e-6)
+                  << " MiB/s\n";
+        return mean;
+    };
+    std::cout << "Układ " << n << "x" << n + 1 << ", " << reps << " powtórzeń, "
+              << std::setprecision(2) << std::fixed << megabytes << " MiB na żądanie i odpowiedź\n";
+    const double rpc_mean = report("ONC RPC", rpc_us);
+    const double native_mean = report("natywny", native_us);
+    std::cout << "Przyspieszenie: " << std::setprecision(2) << rpc_mean / native_mean << "x, max różnica wyników "
+              << std::scientific << std::setprecision(3) << max_delta << "\n";
+    return max_delta < 1e-9 ? 0 : 1;
+}
+
+// Ten sam symetryczny, dodatnio określony układ z nową prawą stroną w każdym powtórzeniu, rozwiązywany przez
+// SOLVE_WITH_ENGINE każdym silnikiem; czas od wysłania do odebrania odpowiedzi
+int compare_engines(const char *host, unsigned int n, unsigned int reps) {
+    std::mt19937 gen(std::random_device{}());
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    CppMatrix augmented;
+    augmented.rows = n;
+    augmented.cols = n + 1;
+    augmented.data.resize(static_cast<std::size_t>(n) * (n + 1));
+    for (unsigned int r = 0; r < n; ++r) {
+        for (unsigned int c = 0; c < r; ++c) {
+            augmented(r, c) = augmented(c, r) = dist(gen);
+        }
+        augmented(r, r) = n + 1.0;
+    }
+
+    CLIENT *clnt = clnt_create(const_cast<char *>(host), GAUSS_RPC, GAUSS_V, const_cast<char *>("tcp"));
+    if (clnt == NULL) {
+        clnt_pcreateerror(const_cast<char *>(host));
+        return 1;
+    }
+    apply_tenant(clnt);
+    timeval timeout{};
+    timeout.tv_sec = 300;
+    clnt_control(clnt, CLSET_TIMEOUT, reinterpret_cast<char *>(&timeout));
+
+    const char *names[] = {"gaussian.hpp", "LAPACK LU", "LAPACK Cholesky", "RBT bez wyboru"};
+    std::cout << "Układ " << n << "x" << n << " (symetryczny, dodatnio określony), " << reps << " powtórzeń\n";
+    int status = 0;
+    for (unsigned int engine = 1; engine <= 4; ++engine) {
+        std::vector<double> samples;
+        double max_residual = 0.0;
+        for (unsigned int rep = 0; rep < reps; ++rep) {
+            for (unsigned int r = 0; r < n; ++r) {
+                augmented(r, n) = dist(gen);
+            }
+            EngineMatrix request{};
+            request.engine = engine;
+            request.matrix.rows = n;
+            request.matrix.cols = n + 1;
+            request.matrix.data.data_len = static_cast<u_int>(augmented.data.size());
+            request.matrix.data.data_val = augmented.data.data();
+            const auto start = std::chrono::steady_clock::now();
+            Solution *result = solve_with_engine_1(&request, clnt);
+            const double elapsed =
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (result == NULL) {
+                samples.clear();
+                break;
+            }
+            samples.push_back(elapsed);
+            for (unsigned int r = 0; r < n && result->values.values_len == n; ++r) {
+                double value = -augmented(r, n);
+                for (unsigned int c = 0; c < n; ++c) {
+                    value += augmented(r, c) * result->values.values_val[c];
+                }
+                max_residual = std::max(max_residual, std::fabs(value));
+            }
+            xdr_free(reinterpret_cast<xdrproc_t>(xdr_Solution), reinterpret_cast<char *>(result));
+        }
+        std::cout << std::left << std::setw(16) << names[engine - 1] << std::right;
+        if (samples.empty()) {
+            std::cout << " niedostępny (serwer bez LAPACK=1 albo błąd)\n";
+            continue;
+        }
+        std::sort(samples.begin(), samples.end());
+        double total = 0.0;
+        for (double sample : samples) {
+            total += sample;
+        }
+        std::cout << std::fixed << std::setprecision(2) << " średnio " << std::setw(10) << total / samples.size()
+                  << " ms, mediana " << std::setw(10) << samples[samples.size() / 2] << " ms, residuum "
+                  << std::scientific << std::setprecision(2) << max_residual << "\n";
+        if (max_residual > 1e-6) {
+            status = 1;
+        }
+    }
+    clnt_destroy(clnt);
+    return status;
+}
+
+// Ciąg A_k = A_0 + k * drift * E, jak jakobiany kolejnych kroków Newtona, w jednej rodzinie SOLVE_NEARBY.
+// Serwer rozwiązuje GMRES-em ze starymi czynnikami i faktoryzuje ponownie, gdy dryf osłabi prekondycjoner.
+int solve_nearby_sequence(const char *host, unsigned int n, unsigned int steps) {
+    std::mt19937_64 gen(std::random_device{}());
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    constexpr double kDrift = 0.01;
+    CppMatrix base;
+    base.rows = n;
+    base.cols = n + 1;
+    base.data.resize(static_cast<std::size_t>(n) * (n + 1));
+    std::vector<double> direction(static_cast<std::size_t>(n) * n);
+    for (unsigned int r = 0; r < n; ++r) {
+        for (unsigned int c = 0; c < n; ++c) {
+            base(r, c) = dist(gen);
+            direction[static_cast<std::size_t>(r) * n + c] = dist(gen);
+        }
+        base(r, r) += 2.0 * std::sqrt(static_cast<double>(n));
+    }
+
+    CLIENT *clnt = clnt_create(const_cast<char *>(host), GAUSS_RPC, GAUSS_V, const_cast<char *>("tcp"));
+    if (clnt == NULL) {
+        clnt_pcreateerror(const_cast<char *>(host));
+        return 1;
+    }
+    apply_tenant(clnt);
+    timeval timeout{};
+    timeout.tv_sec = 300;
+    clnt_control(clnt, CLSET_TIMEOUT, reinterpret_cast<char *>(&timeout));
+
+    NearbyMatrix request{};
+    request.family = gen();
+    request.matrix.rows = n;
+    request.matrix.cols = n + 1;
+    request.matrix.data.data_len = static_cast<u_int>(base.data.size());
+    CppMatrix augmented = base;
+    double total = 0.0;
+    double max_residual = 0.0;
+    for (unsigned int step = 0; step < steps; ++step) {
+        for (unsigned int r = 0; r < n; ++r) {
+            for (unsigned int c = 0; c < n; ++c) {
+                augmented(r, c) = base(r, c) + step * kDrift * direction[static_cast<std::size_t>(r) * n + c];
+            }
+            augmented(r, n) = dist(gen);
+        }
+        request.matrix.data.data_val = augmented.data.data();
+        const auto start = std::chrono::steady_clock::now();
+        Solution *result = solve_nearby_1(&request, clnt);
+        const double elapsed =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (result == NULL || result->values.values_len != n) {
+            clnt_perror(clnt, const_cast<char *>(host));
+            clnt_destroy(clnt);
+            return 1;
+        }
+        double residual = 0.0;
+        for (unsigned int r = 0; r < n; ++r) {
+            double value = -augmented(r, n);
+            for (unsigned int c = 0; c < n; ++c) {
+                value += augmented(r, c) * result->values.values_val[c];
+            }
+            residual = std::max(residual, std::fabs(value));
+        }
+        xdr_free(reinterpret_cast<xdrproc_t>(xdr_Solution), reinterpret_cast<char *>(result));
+        total += elapsed;
+        max_residual = std::max(max_residual, residual);
+        std::cout << "krok " << std::setw(3) << step << ": " << std::fixed << std::setprecision(2) << std::setw(9)
+                  << elapsed << " ms, residuum " << std::scientific << std::setprecision(2) << residual << "\n";
+    }
+    std::cout << "Łącznie " << std::fixed << std::setprecision(2) << total << " ms dla " << steps
+              << " układów (iteracje i refaktoryzacje: GET_STATS, linia nearby_families)\n";
+    clnt_destroy(clnt);
+    return max_residual < 1e-6 ? 0 : 1;
+}
+
+// Niesymetryczny operator pięciopunktowy na siatce k x k z nowymi losowymi wartościami w każdym powtórzeniu:
+// wzorzec jest ten sam, więc tylko pierwsze żądanie płaci za analizę symboliczną na serwerze
+int solve_sparse_sequence(const char *host, unsigned int k, unsigned int reps) {
+    std::mt19937_64 gen(std::random_device{}());
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    const unsigned int n = k * k;
+    std::vector<unsigned int> col_start{0};
+    std::vector<unsigned int> row_index;
+    for (unsigned int c = 0; c < n; ++c) {
+        const unsigned int x = c % k;
+        const unsigned int y = c / k;
+        if (y > 0) {
+            row_index.push_back(c - k);
+        }
+        if (x > 0) {
+            row_index.push_back(c - 1);
+        }
+        row_index.push_back(c);
+        if (x + 1 < k) {
+            row_index.push_back(c + 1);
+        }
+        if (y + 1 < k) {
+            row_index.push_back(c + k);
+        }
+        col_start.push_back(static_cast<unsigned int>(row_index.size()));
+    }
+    std::vector<double> values(row_index.size());
+    std::vector<double> rhs(n);
+
+    CLIENT *clnt = clnt_create(const_cast<char *>(host), GAUSS_RPC, GAUSS_V, const_cast<char *>("tcp"));
+    if (clnt == NULL) {
+        clnt_pcreateerror(const_cast<char *>(host));
+        return 1;
+    }
+    apply_tenant(clnt);
+    timeval timeout{};
+    timeout.tv_sec = 300;
+    clnt_control(clnt, CLSET_TIMEOUT, reinterpret_cast<char *>(&timeout));
+
+    SparseMatrix request{};
+    request.n = n;
+    request.col_start.col_start_len = static_cast<u_int>(col_start.size());
+    request.col_start.col_start_val = col_start.data();
+    request.row_index.row_index_len = static_cast<u_int>(row_index.size());
+    request.row_index.row_index_val = row_index.data();
+    request.values.values_len = static_cast<u_int>(values.size());
+    request.values.values_val = values.data();
+    request.rhs.rhs_len = n;
+    request.rhs.rhs_val = rhs.data();
+    std::cout << "Siatka " << k << "x" << k << ": n=" << n << ", " << row_index.size() << " niezerowych\n";
+    std::vector<double> repeats;
+    double first = 0.0;
+    double max_residual = 0.0;
+    for (unsigned int rep = 0; rep < reps; ++rep) {
+        for (unsigned int c = 0; c < n; ++c) {
+            for (unsigned int p = col_start[c]; p < col_start[c + 1]; ++p) {
+                values[p] = row_index[p] == c ? 4.0 + dist(gen) : dist(gen);
+            }
+        }
+        for (double &value : rhs) {
+            value = dist(gen);
+        }
+        const auto start = std::chrono::steady_clock::now();
+        Solution *result = solve_sparse_1(&request, clnt);
+        const double elapsed =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (result == NULL || result->values.values_len != n) {
+            clnt_perror(clnt, const_cast<char *>(host));
+            clnt_destroy(clnt);
+            return 1;
+        }
+        std::vector<double> residual(rhs.begin(), rhs.end());
+        for (unsigned int c = 0; c < n; ++c) {
+            for (unsigned int p = col_start[c]; p < col_start[c + 1]; ++p) {
+                residual[row_index[p]] -= values[p] * result->values.values_val[c];
+            }
+        }
+        for (double value : residual) {
+            max_residual = std::max(max_residual, std::fabs(value));
+        }
+        xdr_free(reinterpret_cast<xdrproc_t>(xdr_Solution), reinterpret_cast<char *>(result));
+        if (rep == 0) {
+            first = elapsed;
+        } else {
+            repeats.push_back(elapsed);
+        }
+    }
+    clnt_destroy(clnt);
+
+    std::cout << std::fixed << std::setprecision(2) << "pierwsze żądanie (analiza symboliczna): " << first << " ms\n";
+    if (!repeats.empty()) {
+        std::sort(repeats.begin(), repeats.end());
+        double total = 0.0;
+        for (double sample : repeats) {
+            total += sample;
+        }
+        std::cout << "kolejne " << repeats.size() << " (wzorzec z pamięci): średnio " << total / repeats.size()
+                  << " ms, mediana " << repeats[repeats.size() / 2] << " ms\n";
+    }
+    std::cout << "residuum " << std::scientific << std::setprecision(2) << max_residual << "\n";
+    return max_residual < 1e-6 ? 0 : 1;
+}
+
 } // namespace
 
 int main(int argc, char *argv[]) {
@@ -70,6 +769,130 @@ int main(int argc, char *argv[]) {
     const char *host = argv[1];
     const std::string mode = argv[2];
 
+    if (mode == "s") {
+        if (argc != 3) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        return print_server_stats(host);
+    }
+
+    if (mode == "g") {
+        if (argc != 5 && argc != 6) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        const unsigned long nx = std::strtoul(argv[3], nullptr, 10);
+        const unsigned long ny = std::strtoul(argv[4], nullptr, 10);
+        const unsigned long nz = argc == 6 ? std::strtoul(argv[5], nullptr, 10) : 1;
+        if (nx == 0 || ny == 0 || nz == 0) {
+            std::cerr << "Wymagane dodatnie wymiary siatki.\n";
+            return 1;
+        }
+        return solve_poisson_stencil(host, nx, ny, nz);
+    }
+
+    if (mode == "t") {
+        if (argc != 6) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        const unsigned long chains = std::strtoul(argv[3], nullptr, 10);
+        const unsigned long blocks = std::strtoul(argv[4], nullptr, 10);
+        const unsigned long b = std::strtoul(argv[5], nullptr, 10);
+        if (chains == 0 || blocks == 0 || b == 0) {
+            std::cerr << "Wymagane dodatnie chains, blocks i b.\n";
+            return 1;
+        }
+        return solve_block_chains(host, chains, blocks, b);
+    }
+
+    if (mode == "l") {
+        if (argc != 6) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        const unsigned long n = std::strtoul(argv[3], nullptr, 10);
+        const unsigned long window = std::strtoul(argv[4], nullptr, 10);
+        const unsigned long batches = std::strtoul(argv[5], nullptr, 10);
+        if (n == 0 || (window != 0 && window < n)) {
+            std::cerr << "Wymagane n > 0 i okno 0 albo co najmniej n wierszy.\n";
+            return 1;
+        }
+        return stream_regression(host, n, window, batches);
+    }
+
+    if (mode == "c") {
+        if (argc != 5) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        const unsigned long n = std::strtoul(argv[3], nullptr, 10);
+        const unsigned long m = std::strtoul(argv[4], nullptr, 10);
+        if (m == 0 || m > n) {
+            std::cerr << "Wymagane 0 < m <= n.\n";
+            return 1;
+        }
+        return condense_interface(host, n, m);
+    }
+
+    if (mode == "w") {
+        if (argc != 6) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        const unsigned long n = std::strtoul(argv[3], nullptr, 10);
+        const unsigned long reps = std::strtoul(argv[4], nullptr, 10);
+        const unsigned long port = std::strtoul(argv[5], nullptr, 10);
+        if (n == 0 || reps == 0 || port == 0 || port > 65535) {
+            std::cerr << "Wymagane dodatnie n i reps oraz port protokołu natywnego.\n";
+            return 1;
+        }
+        return compare_protocols(host, n, reps, port);
+    }
+
+    if (mode == "e") {
+        if (argc != 5) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        const unsigned long n = std::strtoul(argv[3], nullptr, 10);
+        const unsigned long reps = std::strtoul(argv[4], nullptr, 10);
+        if (n == 0 || reps == 0) {
+            std::cerr << "Wymagane dodatnie n i reps.\n";
+            return 1;
+        }
+        return compare_engines(host, n, reps);
+    }
+
+    if (mode == "n") {
+        if (argc != 5) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        const unsigned long n = std::strtoul(argv[3], nullptr, 10);
+        const unsigned long steps = std::strtoul(argv[4], nullptr, 10);
+        if (n == 0 || steps == 0) {
+            std::cerr << "Wymagane dodatnie n i steps.\n";
+            return 1;
+        }
+        return solve_nearby_sequence(host, n, steps);
+    }
+
+    if (mode == "z") {
+        if (argc != 5) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        const unsigned long k = std::strtoul(argv[3], nullptr, 10);
+        const unsigned long reps = std::strtoul(argv[4], nullptr, 10);
+        if (k == 0 || reps == 0 || k > 4096) {
+            std::cerr << "Wymagane dodatnie k (najwyżej 4096) i reps.\n";
+            return 1;
+        }
+        return solve_sparse_sequence(host, k, reps);
+    }
+
     CppMatrix cpp_matrix;
     std::vector<double> expected_solution;
 
@@ -116,6 +939,7 @@ int main(int argc, char *argv[]) {
         clnt_pcreateerror(const_cast<char *>(host));
         return 1;
     }
+    apply_tenant(clnt);
 
     // Wydłużony timeout RPC (np. 5 minut) dla dużych macierzy
     timeval timeout{};
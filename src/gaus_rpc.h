@@ -32,6 +32,129 @@ struct Solution {
 };
 typedef struct Solution Solution;
 
+struct Stencil {
+	u_int nx;
+	u_int ny;
+	u_int nz;
+	double center;
+	double off_x;
+	double off_y;
+	double off_z;
+	double tolerance;
+	u_int max_cycles;
+	struct {
+		u_int rhs_len;
+		double *rhs_val;
+	} rhs;
+};
+typedef struct Stencil Stencil;
+
+struct RlsOpen {
+	u_int n;
+	u_int window;
+};
+typedef struct RlsOpen RlsOpen;
+
+struct RlsRows {
+	u_quad_t session;
+	u_int rows;
+	struct {
+		u_int data_len;
+		double *data_val;
+	} data;
+};
+typedef struct RlsRows RlsRows;
+
+struct BlockTridiag {
+	u_int chains;
+	u_int blocks;
+	u_int b;
+	u_int method;
+	struct {
+		u_int lower_len;
+		double *lower_val;
+	} lower;
+	struct {
+		u_int diag_len;
+		double *diag_val;
+	} diag;
+	struct {
+		u_int upper_len;
+		double *upper_val;
+	} upper;
+	struct {
+		u_int rhs_len;
+		double *rhs_val;
+	} rhs;
+};
+typedef struct BlockTridiag BlockTridiag;
+
+struct SchurRequest {
+	u_int n;
+	struct {
+		u_int matrix_len;
+		double *matrix_val;
+	} matrix;
+	struct {
+		u_int rhs_len;
+		double *rhs_val;
+	} rhs;
+	struct {
+		u_int interface_len;
+		u_int *interface_val;
+	} interface;
+};
+typedef struct SchurRequest SchurRequest;
+
+struct SchurResult {
+	u_int m;
+	struct {
+		u_int complement_len;
+		double *complement_val;
+	} complement;
+	struct {
+		u_int rhs_len;
+		double *rhs_val;
+	} rhs;
+};
+typedef struct SchurResult SchurResult;
+
+struct EngineMatrix {
+	u_int engine;
+	Matrix matrix;
+};
+typedef struct EngineMatrix EngineMatrix;
+
+struct NearbyMatrix {
+	u_quad_t family;
+	u_int max_iterations;
+	Matrix matrix;
+};
+typedef struct NearbyMatrix NearbyMatrix;
+
+struct SparseMatrix {
+	u_int n;
+	struct {
+		u_int col_start_len;
+		u_int *col_start_val;
+	} col_start;
+	struct {
+		u_int row_index_len;
+		u_int *row_index_val;
+	} row_index;
+	struct {
+		u_int values_len;
+		double *values_val;
+	} values;
+	struct {
+		u_int rhs_len;
+		double *rhs_val;
+	} rhs;
+};
+typedef struct SparseMatrix SparseMatrix;
+
+typedef char *Report;
+
 #define GAUSS_RPC 0x20000001
 #define GAUSS_V 1
 
@@ -39,12 +162,72 @@ typedef struct Solution Solution;
 #define SOLVE_GAUSS 1
 extern  Solution * solve_gauss_1(Matrix *, CLIENT *);
 extern  Solution * solve_gauss_1_svc(Matrix *, struct svc_req *);
+#define GET_STATS 2
+extern  Report * get_stats_1(void *, CLIENT *);
+extern  Report * get_stats_1_svc(void *, struct svc_req *);
+#define SOLVE_STENCIL 3
+extern  Solution * solve_stencil_1(Stencil *, CLIENT *);
+extern  Solution * solve_stencil_1_svc(Stencil *, struct svc_req *);
+#define RLS_OPEN 4
+extern  u_quad_t * rls_open_1(RlsOpen *, CLIENT *);
+extern  u_quad_t * rls_open_1_svc(RlsOpen *, struct svc_req *);
+#define RLS_UPDATE 5
+extern  Solution * rls_update_1(RlsRows *, CLIENT *);
+extern  Solution * rls_update_1_svc(RlsRows *, struct svc_req *);
+#define RLS_CLOSE 6
+extern  int * rls_close_1(u_quad_t *, CLIENT *);
+extern  int * rls_close_1_svc(u_quad_t *, struct svc_req *);
+#define SOLVE_BLOCK_TRIDIAG 7
+extern  Solution * solve_block_tridiag_1(BlockTridiag *, CLIENT *);
+extern  Solution * solve_block_tridiag_1_svc(BlockTridiag *, struct svc_req *);
+#define SCHUR_COMPLEMENT 8
+extern  SchurResult * schur_complement_1(SchurRequest *, CLIENT *);
+extern  SchurResult * schur_complement_1_svc(SchurRequest *, struct svc_req *);
+#define SOLVE_WITH_ENGINE 9
+extern  Solution * solve_with_engine_1(EngineMatrix *, CLIENT *);
+extern  Solution * solve_with_engine_1_svc(EngineMatrix *, struct svc_req *);
+#define SOLVE_NEARBY 10
+extern  Solution * solve_nearby_1(NearbyMatrix *, CLIENT *);
+extern  Solution * solve_nearby_1_svc(NearbyMatrix *, struct svc_req *);
+#define SOLVE_SPARSE 11
+extern  Solution * solve_sparse_1(SparseMatrix *, CLIENT *);
+extern  Solution * solve_sparse_1_svc(SparseMatrix *, struct svc_req *);
 extern int gauss_rpc_1_freeresult (SVCXPRT *, xdrproc_t, caddr_t);
 
 #else /* K&R C */
 #define SOLVE_GAUSS 1
 extern  Solution * solve_gauss_1();
 extern  Solution * solve_gauss_1_svc();
+#define GET_STATS 2
+extern  Report * get_stats_1();
+extern  Report * get_stats_1_svc();
+#define SOLVE_STENCIL 3
+extern  Solution * solve_stencil_1();
+extern  Solution * solve_stencil_1_svc();
+#define RLS_OPEN 4
+extern  u_quad_t * rls_open_1();
+extern  u_quad_t * rls_open_1_svc();
+#define RLS_UPDATE 5
+extern  Solution * rls_update_1();
+extern  Solution * rls_update_1_svc();
+#define RLS_CLOSE 6
+extern  int * rls_close_1();
+extern  int * rls_close_1_svc();
+#define SOLVE_BLOCK_TRIDIAG 7
+extern  Solution * solve_block_tridiag_1();
+extern  Solution * solve_block_tridiag_1_svc();
+#define SCHUR_COMPLEMENT 8
+extern  SchurResult * schur_complement_1();
+extern  SchurResult * schur_complement_1_svc();
+#define SOLVE_WITH_ENGINE 9
+extern  Solution * solve_with_engine_1();
+extern  Solution * solve_with_engine_1_svc();
+#define SOLVE_NEARBY 10
+extern  Solution * solve_nearby_1();
+extern  Solution * solve_nearby_1_svc();
+#define SOLVE_SPARSE 11
+extern  Solution * solve_sparse_1();
+extern  Solution * solve_sparse_1_svc();
 extern int gauss_rpc_1_freeresult ();
 #endif /* K&R C */
 
@@ -53,10 +236,30 @@ extern int gauss_rpc_1_freeresult ();
 #if defined(__STDC__) || defined(__cplusplus)
 extern  bool_t xdr_Matrix (XDR *, Matrix*);
 extern  bool_t xdr_Solution (XDR *, Solution*);
+extern  bool_t xdr_Stencil (XDR *, Stencil*);
+extern  bool_t xdr_RlsOpen (XDR *, RlsOpen*);
+extern  bool_t xdr_RlsRows (XDR *, RlsRows*);
+extern  bool_t xdr_BlockTridiag (XDR *, BlockTridiag*);
+extern  bool_t xdr_SchurRequest (XDR *, SchurRequest*);
+extern  bool_t xdr_SchurResult (XDR *, SchurResult*);
+extern  bool_t xdr_EngineMatrix (XDR *, EngineMatrix*);
+extern  bool_t xdr_NearbyMatrix (XDR *, NearbyMatrix*);
+extern  bool_t xdr_SparseMatrix (XDR *, SparseMatrix*);
+extern  bool_t xdr_Report (XDR *, Report*);
 
 #else /* K&R C */
 extern bool_t xdr_Matrix ();
 extern bool_t xdr_Solution ();
+extern bool_t xdr_Stencil ();
+extern bool_t xdr_RlsOpen ();
+extern bool_t xdr_RlsRows ();
+extern bool_t xdr_BlockTridiag ();
+extern bool_t xdr_SchurRequest ();
+extern bool_t xdr_SchurResult ();
+extern bool_t xdr_EngineMatrix ();
+extern bool_t xdr_NearbyMatrix ();
+extern bool_t xdr_SparseMatrix ();
+extern bool_t xdr_Report ();
 
 #endif /* K&R C */
 
@@ -9,8 +9,104 @@ struct Solution{
     double values<>;
 };
 
+/* Operator stencilowy na siatce nx*ny*nz (nz = 1 dla 2D) z zerowym brzegiem Dirichleta;
+   rhs ma nx*ny*nz wartości w kolejności (k*ny + j)*nx + i. Zob. include/multigrid.hpp */
+struct Stencil{
+    unsigned int nx;
+    unsigned int ny;
+    unsigned int nz;
+    double center;
+    double off_x;
+    double off_y;
+    double off_z;
+    double tolerance;
+    unsigned int max_cycles;
+    double rhs<>;
+};
+
+/* Sesja rekursywnych najmniejszych kwadratów (zob. include/rls.hpp) */
+struct RlsOpen{
+    unsigned int n;
+    unsigned int window;    /* 0 = wszystkie wiersze; inaczej tylko ostatnie `window` wierszy */
+};
+
+struct RlsRows{
+    unsigned hyper session;
+    unsigned int rows;
+    double data<>;          /* rows wierszy po n+1 wartości: współczynniki i obserwacja */
+};
+
+/* Niezależne łańcuchy blokowo-trójdiagonalne (zob. include/block_tridiag.hpp): chains łańcuchów po blocks
+   bloków b x b wierszami; lower i upper mają po chains*(blocks-1)*b*b wartości, diag chains*blocks*b*b,
+   rhs chains*blocks*b. method: 0 = automatycznie, 1 = Thomas, 2 = redukcja cykliczna */
+struct BlockTridiag{
+    unsigned int chains;
+    unsigned int blocks;
+    unsigned int b;
+    unsigned int method;
+    double lower<>;
+    double diag<>;
+    double upper<>;
+    double rhs<>;
+};
+
+/* Dopełnienie Schura (zob. include/schur.hpp): macierz n x n wierszami, rhs n wartości, interface to indeksy
+   niewiadomych brzegowych. Wynik: complement m x m i rhs m wartości w kolejności interface */
+struct SchurRequest{
+    unsigned int n;
+    double matrix<>;
+    double rhs<>;
+    unsigned int interface<>;
+};
+
+struct SchurResult{
+    unsigned int m;
+    double complement<>;
+    double rhs<>;
+};
+
+/* SOLVE_GAUSS z wyborem silnika (zob. include/lapack_backend.hpp): 0 = automatycznie, 1 = silniki
+   z include/gaussian.hpp, 2 = LAPACK dgetrf/dgetrs, 3 = LAPACK dpotrf/dpotrs (macierz symetryczna
+   dodatnio określona), 4 = przekształcenie motylkowe i LU bez wyboru elementu głównego (include/butterfly.hpp) */
+struct EngineMatrix{
+    unsigned int engine;
+    Matrix matrix;
+};
+
+/* Ciąg podobnych macierzy (zob. include/gmres.hpp): family wybiera klient w obrębie swojego tenanta. Serwer
+   rozwiązuje GMRES-em z czynnikami LU wcześniejszej macierzy rodziny i faktoryzuje ponownie, gdy GMRES nie zbiegnie
+   w max_iterations iteracjach (0 = limit serwera) */
+struct NearbyMatrix{
+    unsigned hyper family;
+    unsigned int max_iterations;
+    Matrix matrix;
+};
+
+/* Układ rzadki n x n kolumnami (CSC, zob. include/sparse_lu.hpp): wiersze kolumny j to
+   row_index[col_start[j] .. col_start[j+1]), rosnąco i bez powtórzeń, values w tej samej kolejności, rhs n wartości.
+   Analiza symboliczna wzorca jest zapamiętywana, więc kolejne macierze o tym samym wzorcu są tylko faktoryzowane */
+struct SparseMatrix{
+    unsigned int n;
+    unsigned int col_start<>;
+    unsigned int row_index<>;
+    double values<>;
+    double rhs<>;
+};
+
+typedef string Report<>;
+
 program GAUSS_RPC{
     version GAUSS_V{
         Solution SOLVE_GAUSS(Matrix) = 1;
+        Report GET_STATS(void) = 2;
+        Solution SOLVE_STENCIL(Stencil) = 3;
+        unsigned hyper RLS_OPEN(RlsOpen) = 4;
+        Solution RLS_UPDATE(RlsRows) = 5;
+        int RLS_CLOSE(unsigned hyper) = 6;
+        Solution SOLVE_BLOCK_TRIDIAG(BlockTridiag) = 7;
+        SchurResult SCHUR_COMPLEMENT(SchurRequest) = 8;
+        Solution SOLVE_WITH_ENGINE(EngineMatrix) = 9;
+        Solution SOLVE_NEARBY(NearbyMatrix) = 10;
+        Solution SOLVE_SPARSE(SparseMatrix) = 11;
     } = 1;
 } = 0x20000001;
\ No newline at end of file
@@ -23,3 +23,153 @@ solve_gauss_1(Matrix *argp, CLIENT *clnt)
 	}
 	return (&clnt_res);
 }
+
+Report *
+get_stats_1(void *argp, CLIENT *clnt)
+{
+	static Report clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, GET_STATS,
+		(xdrproc_t) xdr_void, (caddr_t) argp,
+		(xdrproc_t) xdr_Report, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+Solution *
+solve_stencil_1(Stencil *argp, CLIENT *clnt)
+{
+	static Solution clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SOLVE_STENCIL,
+		(xdrproc_t) xdr_Stencil, (caddr_t) argp,
+		(xdrproc_t) xdr_Solution, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+u_quad_t *
+rls_open_1(RlsOpen *argp, CLIENT *clnt)
+{
+	static u_quad_t clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, RLS_OPEN,
+		(xdrproc_t) xdr_RlsOpen, (caddr_t) argp,
+		(xdrproc_t) xdr_u_quad_t, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+Solution *
+rls_update_1(RlsRows *argp, CLIENT *clnt)
+{
+	static Solution clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, RLS_UPDATE,
+		(xdrproc_t) xdr_RlsRows, (caddr_t) argp,
+		(xdrproc_t) xdr_Solution, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+int *
+rls_close_1(u_quad_t *argp, CLIENT *clnt)
+{
+	static int clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, RLS_CLOSE,
+		(xdrproc_t) xdr_u_quad_t, (caddr_t) argp,
+		(xdrproc_t) xdr_int, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+Solution *
+solve_block_tridiag_1(BlockTridiag *argp, CLIENT *clnt)
+{
+	static Solution clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SOLVE_BLOCK_TRIDIAG,
+		(xdrproc_t) xdr_BlockTridiag, (caddr_t) argp,
+		(xdrproc_t) xdr_Solution, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+SchurResult *
+schur_complement_1(SchurRequest *argp, CLIENT *clnt)
+{
+	static SchurResult clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SCHUR_COMPLEMENT,
+		(xdrproc_t) xdr_SchurRequest, (caddr_t) argp,
+		(xdrproc_t) xdr_SchurResult, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+Solution *
+solve_with_engine_1(EngineMatrix *argp, CLIENT *clnt)
+{
+	static Solution clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SOLVE_WITH_ENGINE,
+		(xdrproc_t) xdr_EngineMatrix, (caddr_t) argp,
+		(xdrproc_t) xdr_Solution, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+Solution *
+solve_nearby_1(NearbyMatrix *argp, CLIENT *clnt)
+{
+	static Solution clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SOLVE_NEARBY,
+		(xdrproc_t) xdr_NearbyMatrix, (caddr_t) argp,
+		(xdrproc_t) xdr_Solution, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+Solution *
+solve_sparse_1(SparseMatrix *argp, CLIENT *clnt)
+{
+	static Solution clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, SOLVE_SPARSE,
+		(xdrproc_t) xdr_SparseMatrix, (caddr_t) argp,
+		(xdrproc_t) xdr_Solution, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
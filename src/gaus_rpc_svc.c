@@ -16,11 +16,20 @@
 #define SIG_PF void(*)(int)
 #endif
 
-static void
+void
 gauss_rpc_1(struct svc_req *rqstp, register SVCXPRT *transp)
 {
 	union {
 		Matrix solve_gauss_1_arg;
+		Stencil solve_stencil_1_arg;
+		RlsOpen rls_open_1_arg;
+		RlsRows rls_update_1_arg;
+		u_quad_t rls_close_1_arg;
+		BlockTridiag solve_block_tridiag_1_arg;
+		SchurRequest schur_complement_1_arg;
+		EngineMatrix solve_with_engine_1_arg;
+		NearbyMatrix solve_nearby_1_arg;
+		SparseMatrix solve_sparse_1_arg;
 	} argument;
 	char *result;
 	xdrproc_t _xdr_argument, _xdr_result;
@@ -37,6 +46,66 @@ gauss_rpc_1(struct svc_req *rqstp, register SVCXPRT *transp)
 		local = (char *(*)(char *, struct svc_req *)) solve_gauss_1_svc;
 		break;
 
+	case GET_STATS:
+		_xdr_argument = (xdrproc_t) xdr_void;
+		_xdr_result = (xdrproc_t) xdr_Report;
+		local = (char *(*)(char *, struct svc_req *)) get_stats_1_svc;
+		break;
+
+	case SOLVE_STENCIL:
+		_xdr_argument = (xdrproc_t) xdr_Stencil;
+		_xdr_result = (xdrproc_t) xdr_Solution;
+		local = (char *(*)(char *, struct svc_req *)) solve_stencil_1_svc;
+		break;
+
+	case RLS_OPEN:
+		_xdr_argument = (xdrproc_t) xdr_RlsOpen;
+		_xdr_result = (xdrproc_t) xdr_u_quad_t;
+		local = (char *(*)(char *, struct svc_req *)) rls_open_1_svc;
+		break;
+
+	case RLS_UPDATE:
+		_xdr_argument = (xdrproc_t) xdr_RlsRows;
+		_xdr_result = (xdrproc_t) xdr_Solution;
+		local = (char *(*)(char *, struct svc_req *)) rls_update_1_svc;
+		break;
+
+	case RLS_CLOSE:
+		_xdr_argument = (xdrproc_t) xdr_u_quad_t;
+		_xdr_result = (xdrproc_t) xdr_int;
+		local = (char *(*)(char *, struct svc_req *)) rls_close_1_svc;
+		break;
+
+	case SOLVE_BLOCK_TRIDIAG:
+		_xdr_argument = (xdrproc_t) xdr_BlockTridiag;
+		_xdr_result = (xdrproc_t) xdr_Solution;
+		local = (char *(*)(char *, struct svc_req *)) solve_block_tridiag_1_svc;
+		break;
+
+	case SCHUR_COMPLEMENT:
+		_xdr_argument = (xdrproc_t) xdr_SchurRequest;
+		_xdr_result = (xdrproc_t) xdr_SchurResult;
+		local = (char *(*)(char *, struct svc_req *)) schur_complement_1_svc;
+		break;
+
+	case SOLVE_WITH_ENGINE:
+		_xdr_argument = (xdrproc_t) xdr_EngineMatrix;
+		_xdr_result = (xdrproc_t) xdr_Solution;
+		local = (char *(*)(char *, struct svc_req *)) solve_with_engine_1_svc;
+		break;
+
+	case SOLVE_NEARBY:
+		_xdr_argument = (xdrproc_t) xdr_NearbyMatrix;
+		_xdr_result = (xdrproc_t) xdr_Solution;
+		local = (char *(*)(char *, struct svc_req *)) solve_nearby_1_svc;
+		break;
+
+	case SOLVE_SPARSE:
+		_xdr_argument = (xdrproc_t) xdr_SparseMatrix;
+		_xdr_result = (xdrproc_t) xdr_Solution;
+		local = (char *(*)(char *, struct svc_req *)) solve_sparse_1_svc;
+		break;
+
 	default:
 		svcerr_noproc (transp);
 		return;
@@ -56,36 +125,3 @@ gauss_rpc_1(struct svc_req *rqstp, register SVCXPRT *transp)
 	}
 	return;
 }
-
-int
-main (int argc, char **argv)
-{
-	register SVCXPRT *transp;
-
-	pmap_unset (GAUSS_RPC, GAUSS_V);
-
-	transp = svcudp_create(RPC_ANYSOCK);
-	if (transp == NULL) {
-		fprintf (stderr, "%s", "cannot create udp service.");
-		exit(1);
-	}
-	if (!svc_register(transp, GAUSS_RPC, GAUSS_V, gauss_rpc_1, IPPROTO_UDP)) {
-		fprintf (stderr, "%s", "unable to register (GAUSS_RPC, GAUSS_V, udp).");
-		exit(1);
-	}
-
-	transp = svctcp_create(RPC_ANYSOCK, 0, 0);
-	if (transp == NULL) {
-		fprintf (stderr, "%s", "cannot create tcp service.");
-		exit(1);
-	}
-	if (!svc_register(transp, GAUSS_RPC, GAUSS_V, gauss_rpc_1, IPPROTO_TCP)) {
-		fprintf (stderr, "%s", "unable to register (GAUSS_RPC, GAUSS_V, tcp).");
-		exit(1);
-	}
-
-	svc_run ();
-	fprintf (stderr, "%s", "svc_run returned");
-	exit (1);
-	/* NOTREACHED */
-}
@@ -30,3 +30,310 @@ xdr_Solution (XDR *xdrs, Solution *objp)
 		 return FALSE;
 	return TRUE;
 }
+
+bool_t
+xdr_Stencil (XDR *xdrs, Stencil *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE) {
+		buf = XDR_INLINE (xdrs, 3 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_u_int (xdrs, &objp->nx))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->ny))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->nz))
+				 return FALSE;
+
+		} else {
+		IXDR_PUT_U_LONG(buf, objp->nx);
+		IXDR_PUT_U_LONG(buf, objp->ny);
+		IXDR_PUT_U_LONG(buf, objp->nz);
+		}
+		 if (!xdr_double (xdrs, &objp->center))
+			 return FALSE;
+		 if (!xdr_double (xdrs, &objp->off_x))
+			 return FALSE;
+		 if (!xdr_double (xdrs, &objp->off_y))
+			 return FALSE;
+		 if (!xdr_double (xdrs, &objp->off_z))
+			 return FALSE;
+		 if (!xdr_double (xdrs, &objp->tolerance))
+			 return FALSE;
+		 if (!xdr_u_int (xdrs, &objp->max_cycles))
+			 return FALSE;
+		 if (!xdr_array (xdrs, (char **)&objp->rhs.rhs_val, (u_int *) &objp->rhs.rhs_len, ~0,
+			sizeof (double), (xdrproc_t) xdr_double))
+			 return FALSE;
+		return TRUE;
+	} else if (xdrs->x_op == XDR_DECODE) {
+		buf = XDR_INLINE (xdrs, 3 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_u_int (xdrs, &objp->nx))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->ny))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->nz))
+				 return FALSE;
+
+		} else {
+		objp->nx = IXDR_GET_U_LONG(buf);
+		objp->ny = IXDR_GET_U_LONG(buf);
+		objp->nz = IXDR_GET_U_LONG(buf);
+		}
+		 if (!xdr_double (xdrs, &objp->center))
+			 return FALSE;
+		 if (!xdr_double (xdrs, &objp->off_x))
+			 return FALSE;
+		 if (!xdr_double (xdrs, &objp->off_y))
+			 return FALSE;
+		 if (!xdr_double (xdrs, &objp->off_z))
+			 return FALSE;
+		 if (!xdr_double (xdrs, &objp->tolerance))
+			 return FALSE;
+		 if (!xdr_u_int (xdrs, &objp->max_cycles))
+			 return FALSE;
+		 if (!xdr_array (xdrs, (char **)&objp->rhs.rhs_val, (u_int *) &objp->rhs.rhs_len, ~0,
+			sizeof (double), (xdrproc_t) xdr_double))
+			 return FALSE;
+	 return TRUE;
+	}
+
+	 if (!xdr_u_int (xdrs, &objp->nx))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->ny))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->nz))
+		 return FALSE;
+	 if (!xdr_double (xdrs, &objp->center))
+		 return FALSE;
+	 if (!xdr_double (xdrs, &objp->off_x))
+		 return FALSE;
+	 if (!xdr_double (xdrs, &objp->off_y))
+		 return FALSE;
+	 if (!xdr_double (xdrs, &objp->off_z))
+		 return FALSE;
+	 if (!xdr_double (xdrs, &objp->tolerance))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->max_cycles))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->rhs.rhs_val, (u_int *) &objp->rhs.rhs_len, ~0,
+		sizeof (double), (xdrproc_t) xdr_double))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_RlsOpen (XDR *xdrs, RlsOpen *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_u_int (xdrs, &objp->n))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->window))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_RlsRows (XDR *xdrs, RlsRows *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_u_quad_t (xdrs, &objp->session))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->rows))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->data.data_val, (u_int *) &objp->data.data_len, ~0,
+		sizeof (double), (xdrproc_t) xdr_double))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_BlockTridiag (XDR *xdrs, BlockTridiag *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE) {
+		buf = XDR_INLINE (xdrs, 4 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_u_int (xdrs, &objp->chains))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->blocks))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->b))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->method))
+				 return FALSE;
+
+		} else {
+		IXDR_PUT_U_LONG(buf, objp->chains);
+		IXDR_PUT_U_LONG(buf, objp->blocks);
+		IXDR_PUT_U_LONG(buf, objp->b);
+		IXDR_PUT_U_LONG(buf, objp->method);
+		}
+		 if (!xdr_array (xdrs, (char **)&objp->lower.lower_val, (u_int *) &objp->lower.lower_len, ~0,
+			sizeof (double), (xdrproc_t) xdr_double))
+			 return FALSE;
+		 if (!xdr_array (xdrs, (char **)&objp->diag.diag_val, (u_int *) &objp->diag.diag_len, ~0,
+			sizeof (double), (xdrproc_t) xdr_double))
+			 return FALSE;
+		 if (!xdr_array (xdrs, (char **)&objp->upper.upper_val, (u_int *) &objp->upper.upper_len, ~0,
+			sizeof (double), (xdrproc_t) xdr_double))
+			 return FALSE;
+		 if (!xdr_array (xdrs, (char **)&objp->rhs.rhs_val, (u_int *) &objp->rhs.rhs_len, ~0,
+			sizeof (double), (xdrproc_t) xdr_double))
+			 return FALSE;
+		return TRUE;
+	} else if (xdrs->x_op == XDR_DECODE) {
+		buf = XDR_INLINE (xdrs, 4 * BYTES_PER_XDR_UNIT);
+		if (buf == NULL) {
+			 if (!xdr_u_int (xdrs, &objp->chains))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->blocks))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->b))
+				 return FALSE;
+			 if (!xdr_u_int (xdrs, &objp->method))
+				 return FALSE;
+
+		} else {
+		objp->chains = IXDR_GET_U_LONG(buf);
+		objp->blocks = IXDR_GET_U_LONG(buf);
+		objp->b = IXDR_GET_U_LONG(buf);
+		objp->method = IXDR_GET_U_LONG(buf);
+		}
+		 if (!xdr_array (xdrs, (char **)&objp->lower.lower_val, (u_int *) &objp->lower.lower_len, ~0,
+			sizeof (double), (xdrproc_t) xdr_double))
+			 return FALSE;
+		 if (!xdr_array (xdrs, (char **)&objp->diag.diag_val, (u_int *) &objp->diag.diag_len, ~0,
+			sizeof (double), (xdrproc_t) xdr_double))
+			 return FALSE;
+		 if (!xdr_array (xdrs, (char **)&objp->upper.upper_val, (u_int *) &objp->upper.upper_len, ~0,
+			sizeof (double), (xdrproc_t) xdr_double))
+			 return FALSE;
+		 if (!xdr_array (xdrs, (char **)&objp->rhs.rhs_val, (u_int *) &objp->rhs.rhs_len, ~0,
+			sizeof (double), (xdrproc_t) xdr_double))
+			 return FALSE;
+	 return TRUE;
+	}
+
+	 if (!xdr_u_int (xdrs, &objp->chains))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->blocks))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->b))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->method))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->lower.lower_val, (u_int *) &objp->lower.lower_len, ~0,
+		sizeof (double), (xdrproc_t) xdr_double))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->diag.diag_val, (u_int *) &objp->diag.diag_len, ~0,
+		sizeof (double), (xdrproc_t) xdr_double))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->upper.upper_val, (u_int *) &objp->upper.upper_len, ~0,
+		sizeof (double), (xdrproc_t) xdr_double))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->rhs.rhs_val, (u_int *) &objp->rhs.rhs_len, ~0,
+		sizeof (double), (xdrproc_t) xdr_double))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_SchurRequest (XDR *xdrs, SchurRequest *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_u_int (xdrs, &objp->n))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->matrix.matrix_val, (u_int *) &objp->matrix.matrix_len, ~0,
+		sizeof (double), (xdrproc_t) xdr_double))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->rhs.rhs_val, (u_int *) &objp->rhs.rhs_len, ~0,
+		sizeof (double), (xdrproc_t) xdr_double))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->interface.interface_val, (u_int *) &objp->interface.interface_len, ~0,
+		sizeof (u_int), (xdrproc_t) xdr_u_int))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_SchurResult (XDR *xdrs, SchurResult *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_u_int (xdrs, &objp->m))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->complement.complement_val, (u_int *) &objp->complement.complement_len, ~0,
+		sizeof (double), (xdrproc_t) xdr_double))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->rhs.rhs_val, (u_int *) &objp->rhs.rhs_len, ~0,
+		sizeof (double), (xdrproc_t) xdr_double))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_EngineMatrix (XDR *xdrs, EngineMatrix *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_u_int (xdrs, &objp->engine))
+		 return FALSE;
+	 if (!xdr_Matrix (xdrs, &objp->matrix))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_NearbyMatrix (XDR *xdrs, NearbyMatrix *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_u_quad_t (xdrs, &objp->family))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->max_iterations))
+		 return FALSE;
+	 if (!xdr_Matrix (xdrs, &objp->matrix))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_SparseMatrix (XDR *xdrs, SparseMatrix *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_u_int (xdrs, &objp->n))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->col_start.col_start_val, (u_int *) &objp->col_start.col_start_len, ~0,
+		sizeof (u_int), (xdrproc_t) xdr_u_int))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->row_index.row_index_val, (u_int *) &objp->row_index.row_index_len, ~0,
+		sizeof (u_int), (xdrproc_t) xdr_u_int))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->values.values_val, (u_int *) &objp->values.values_len, ~0,
+		sizeof (double), (xdrproc_t) xdr_double))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->rhs.rhs_val, (u_int *) &objp->rhs.rhs_len, ~0,
+		sizeof (double), (xdrproc_t) xdr_double))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_Report (XDR *xdrs, Report *objp)
+{
+	register int32_t *buf;
+
+	 if (!xdr_string (xdrs, objp, ~0))
+		 return FALSE;
+	return TRUE;
+}
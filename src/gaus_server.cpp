@@ -1,87 +1,2553 @@
 #include "gaus_rpc.h"
 #include "../include/matrix.hpp"
+#include "../include/async_pipeline.hpp"
+#include "../include/block_tridiag.hpp"
+#include "../include/butterfly.hpp"
+#include "../include/distributed.hpp"
+#include "../include/factor_store.hpp"
+#include "../include/fair_scheduler.hpp"
 #include "../include/gaussian.hpp"
+#include "../include/gmres.hpp"
+#include "../include/lapack_backend.hpp"
+#include "../include/memory_stats.hpp"
+#include "../include/micro_batch.hpp"
+#include "../include/multigrid.hpp"
+#include "../include/native_wire.hpp"
+#include "../include/probes.hpp"
+#include "../include/result_cache.hpp"
+#include "../include/rhs_batch.hpp"
+#include "../include/rls.hpp"
+#include "../include/schur.hpp"
+#include "../include/sparse_lu.hpp"
+#include "../include/xdr_decode.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <csignal>
+#include <cstdint>
 #include <cstdlib>
+#include <filesystem>
+#include <deque>
+#include <map>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
 #include <thread>
 #include <vector>
 
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Dyspozytor wygenerowany przez `rpcgen -m` (src/gaus_rpc_svc.c)
+void gauss_rpc_1(struct svc_req *rqstp, SVCXPRT *transp);
+void gauss_rpc_dispatch(struct svc_req *rqstp, SVCXPRT *transp);
+
 namespace {
 
-struct ServerBanner {
-    ServerBanner() {
-        std::cout << "[server] Uruchomiono i oczekuję na żądania..." << std::endl;
+// Statystyki ostatnich żądań; liczniki pamięci są współdzielone z żądaniem,
+// więc rosną jeszcze w trakcie weryfikacji sekwencyjnej w tle
+struct RequestRecord {
+    std::uint64_t id;
+    std::size_t rows;
+    std::size_t cols;
+    long long parallel_ms;
+    std::shared_ptr<memory::RequestLedger> ledger;
+};
+
+class ServerStats {
+public:
+    static constexpr std::size_t kHistory = 32;
+
+    std::uint64_t next_id() { return ++request_count_; }
+
+    void begin_request() { ++inflight_; }
+    void end_request() { --inflight_; }
+
+    void record(RequestRecord record) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (history_.size() == kHistory) {
+            history_.pop_front();
+        }
+        history_.push_back(std::move(record));
+    }
+
+    std::string report() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::ostringstream oss;
+        oss << "requests_total " << request_count_.load() << "\n";
+        oss << "requests_inflight " << inflight_.load() << "\n";
+        for (const auto &record : history_) {
+            oss << "request id=" << record.id << " n=" << record.rows << "x" << record.cols
+                << " parallel_ms=" << record.parallel_ms
+                << " alloc_current_bytes=" << record.ledger->current_bytes()
+                << " alloc_peak_bytes=" << record.ledger->peak_bytes()
+                << " rss_peak_kb=" << record.ledger->peak_rss_kb()
+                << " pss_peak_kb=" << record.ledger->peak_pss_kb()
+                << " pte_peak_kb=" << record.ledger->peak_pte_kb() << "\n";
+        }
+        return oss.str();
     }
+
+private:
+    std::atomic<std::uint64_t> request_count_{0};
+    std::atomic<std::size_t> inflight_{0};
+    mutable std::mutex mutex_;
+    std::deque<RequestRecord> history_;
 };
 
-ServerBanner g_banner;
+ServerStats g_stats;
 
-} // namespace
+void log_request_memory(std::uint64_t id, const char *stage, const memory::RequestLedger &ledger) {
+    std::cout << "[server] #" << id << " pamięć (" << stage << "): szczyt alokacji "
+              << memory::format_bytes(ledger.peak_bytes()) << ", RSS "
+              << memory::format_bytes(ledger.peak_rss_kb() * 1024) << ", PSS "
+              << memory::format_bytes(ledger.peak_pss_kb() * 1024) << ", tablice stron "
+              << memory::format_bytes(ledger.peak_pte_kb() * 1024) << std::endl;
+}
 
-Solution *solve_gauss_1_svc(Matrix *argp, struct svc_req *rqstp) {
+
+// Etapy potoku: pętla zdarzeń (odbiór/dekodowanie/odpowiedź), pula obliczeń, pula weryfikacji w tle
+std::unique_ptr<async::EventLoop> g_loop;
+std::unique_ptr<async::ComputePool> g_compute;
+std::unique_ptr<async::ComputePool> g_verification;
+std::unique_ptr<sched::FairScheduler> g_scheduler;
+
+// Najwięcej rozwiązań czekających na weryfikację w tle (--verify-queue). Każde trzyma kopię macierzy,
+// więc przy pełnej kolejce rozwiązanie nie jest weryfikowane zamiast zwiększać zużycie pamięci.
+std::size_t g_verification_limit = 64;
+std::atomic<std::uint64_t> g_verification_skipped{0};
+
+// Wywoływane w wątku pętli zdarzeń tuż przed przejściem do puli weryfikacji
+bool reserve_verification(std::uint64_t request_id) {
+    if (g_verification->queued() < g_verification_limit) {
+        return true;
+    }
+    ++g_verification_skipped;
+    std::cout << "[server] #" << request_id << " kolejka weryfikacji pełna - pomijam weryfikację" << std::endl;
+    return false;
+}
+
+// Żądania UDP są liczone w wątku pętli zdarzeń i wstrzymują wszystkie połączenia TCP, więc przyjmowane są
+// tylko małe (--udp-max-mflop); większe trzeba wysłać przez TCP
+double g_datagram_max_flops = 10e6;
+
+bool reject_large_datagram(struct svc_req *rqstp, double flops, std::uint64_t request_id) {
+    if (flops <= g_datagram_max_flops) {
+        return false;
+    }
+    std::cout << "[server] #" << request_id << " Odrzucono żądanie UDP: " << flops / 1e6 << " Mflop przekracza limit "
+              << g_datagram_max_flops / 1e6 << " Mflop - użyj TCP" << std::endl;
+    svcerr_systemerr(rqstp->rq_xprt);
+    return true;
+}
+
+// Tryb rozproszony: proces 0 siatki P x Q przyjmuje żądania RPC, pozostałe wykonują tylko faktoryzację
+struct GridConfig {
+    grid::GridShape shape;
+    std::size_t rank{0};
+    std::vector<grid::Endpoint> peers;
+    std::size_t block{64};
+    std::size_t min_n{256};
+};
+
+std::unique_ptr<GridConfig> g_grid_config;
+std::unique_ptr<grid::PeerMesh> g_mesh;
+std::unique_ptr<grid::DistributedSolver> g_grid;
+std::atomic<bool> g_grid_ready{false};
+std::mutex g_grid_mutex;
+
+bool use_grid_for(const CppMatrix &cpp_matrix) {
+    return g_grid_ready.load() && cpp_matrix.rows >= g_grid_config->min_n;
+}
+
+std::vector<double> solve_on_grid(const CppMatrix &cpp_matrix) {
+    std::lock_guard<std::mutex> lock(g_grid_mutex);
+    try {
+        return g_grid->solve(cpp_matrix, g_grid_config->block);
+    } catch (const grid::PeerError &) {
+        // Strumienie siatki są w nieznanym stanie - dalsze żądania liczone lokalnie
+        g_grid_ready = false;
+        std::cout << "[server] Utracono połączenie z siatką - wyłączam tryb rozproszony" << std::endl;
+        throw;
+    }
+}
+
+void start_grid_coordinator() {
+    g_mesh = std::make_unique<grid::PeerMesh>(0, g_grid_config->peers);
+    g_grid = std::make_unique<grid::DistributedSolver>(*g_mesh, g_grid_config->shape);
+    std::thread([]() {
+        try {
+            g_mesh->connect_all(std::chrono::seconds(600));
+            g_grid_ready = true;
+            std::cout << "[server] Siatka " << g_grid_config->shape.rows << "x" << g_grid_config->shape.cols
+                      << " gotowa (blok " << g_grid_config->block << ", od n=" << g_grid_config->min_n << ")"
+                      << std::endl;
+        } catch (const std::exception &ex) {
+            std::cout << "[server] Nie udało się zestawić siatki: " << ex.what() << std::endl;
+        }
+    }).detach();
+}
+
+// SIGTERM/SIGINT procesu 0: po bieżącym rozwiązaniu na siatce procesy pomocnicze dostają polecenie zakończenia.
+// Sygnały są blokowane przed utworzeniem pozostałych wątków, więc odbiera je tylko ten wątek.
+void stop_grid_on_signal() {
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGINT);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    std::thread([signals]() {
+        int signal = 0;
+        sigwait(&signals, &signal);
+        std::lock_guard<std::mutex> lock(g_grid_mutex);
+        if (g_grid_ready.load()) {
+            try {
+                g_grid->shutdown();
+                std::cout << "[server] Zakończono procesy siatki" << std::endl;
+            } catch (const std::exception &ex) {
+                std::cout << "[server] Nie udało się zakończyć procesów siatki: " << ex.what() << std::endl;
+            }
+        }
+        std::cout.flush();
+        std::_Exit(0);
+    }).detach();
+}
+
+// Proces pomocniczy siatki: bez usługi RPC, tylko udział w rozproszonej faktoryzacji
+int run_grid_worker() {
+    try {
+        grid::PeerMesh mesh(g_grid_config->rank, g_grid_config->peers);
+        std::cout << "[server] Proces siatki " << g_grid_config->rank << " łączy się z pozostałymi..." << std::endl;
+        mesh.connect_all(std::chrono::seconds(600));
+        std::cout << "[server] Proces siatki " << g_grid_config->rank << " gotowy" << std::endl;
+        grid::DistributedSolver(mesh, g_grid_config->shape).serve();
+        std::cout << "[server] Proces siatki " << g_grid_config->rank << " zakończony przez proces 0" << std::endl;
+    } catch (const std::exception &ex) {
+        std::cout << "[server] Proces siatki " << g_grid_config->rank << " kończy pracę: " << ex.what() << std::endl;
+    }
+    return 0;
+}
+
+// Silnik wybierany w żądaniu (SOLVE_WITH_ENGINE, pole engine ramki natywnej); numery jak w gaus_rpc.x
+enum class Engine : unsigned { automatic = 0, in_tree = 1, lapack_lu = 2, lapack_cholesky = 3, butterfly = 4 };
+
+constexpr unsigned kMaxEngine = static_cast<unsigned>(Engine::butterfly);
+
+// Od tego n wybór automatyczny kieruje faktoryzację do LAPACK (--lapack-min-n), o ile jest wkompilowany
+std::size_t g_lapack_min_n = 1;
+
+// Automatycznie: siatka, gdy obejmuje ten rozmiar, potem LAPACK LU od --lapack-min-n, inaczej gaussian.hpp
+Engine resolve_engine(Engine requested, const CppMatrix &cpp_matrix) {
+    if (requested != Engine::automatic) {
+        return requested;
+    }
+    if (lapack::kAvailable && !use_grid_for(cpp_matrix) && cpp_matrix.rows >= g_lapack_min_n) {
+        return Engine::lapack_lu;
+    }
+    return Engine::in_tree;
+}
+
+// Magazyn czynników LU na dysku (--factor-dir); ponowne żądania z tą samą macierzą współczynników są O(n^2)
+std::unique_ptr<store::FactorStore> g_factor_store;
+std::size_t g_factor_min_n = 64;
+
+// Czynniki odczytane z dysku muszą rozwiązywać bieżący układ (ochrona przed kolizją skrótu i uszkodzeniem)
+constexpr double kStoredResidualLimit = 1e-8;
+
+bool use_factor_store_for(const CppMatrix &cpp_matrix) {
+    return g_factor_store && cpp_matrix.rows >= g_factor_min_n;
+}
+
+// Najwięcej kroków poprawiania rozwiązania z czynników float
+constexpr std::size_t kMaxRefinementSteps = 10;
+
+std::vector<double> solve_with_factor_store(const CppMatrix &cpp_matrix, Engine factor_engine, std::string &engine,
+                                            std::function<void()> &persist) {
+    detail::validate_augmented(cpp_matrix);
+    const std::uint64_t key = store::hash_coefficients(cpp_matrix);
+    const std::vector<double> rhs = augmented_rhs(cpp_matrix);
+    store::Precision precision = g_factor_store->precision();
+    if (auto mapped = g_factor_store->find(key, cpp_matrix.rows)) {
+        std::vector<double> solution;
+        if (mapped->precision() == store::Precision::single) {
+            std::size_t steps = 0;
+            solution = refine_solve(cpp_matrix, mapped->single_view(), kMaxRefinementSteps, steps);
+            engine = "zapisana faktoryzacja LU (float) " + store::key_name(key) + " + " + std::to_string(steps) +
+                     " kroków poprawiania";
+        } else {
+            solution = lu_solve(mapped->view(), rhs.data());
+            engine = "zapisana faktoryzacja LU " + store::key_name(key);
+        }
+        if (scaled_residual(cpp_matrix, solution) < kStoredResidualLimit) {
+            return solution;
+        }
+        std::cout << "[server] Czynniki " << store::key_name(key) << " nie rozwiązują układu - faktoryzuję ponownie"
+                  << std::endl;
+        // Poprawianie nie zbiega (macierz zbyt źle uwarunkowana dla float): te czynniki zostaną zapisane w double
+        if (mapped->precision() == store::Precision::single) {
+            precision = store::Precision::full;
+        }
+    }
+
+    engine = factor_engine == Engine::lapack_lu ? "LAPACK dgetrf" : "lu_factor";
+    auto factors = std::make_shared<LuFactors>(factor_engine == Engine::lapack_lu ? lapack::lu_factor(cpp_matrix)
+                                                                                  : lu_factor(cpp_matrix));
+    std::vector<double> solution = lu_solve(factors->view(), rhs.data());
+    persist = [key, factors, precision]() {
+        try {
+            g_factor_store->save(key, *factors, precision);
+            std::cout << "[server] Zapisano czynniki LU " << store::key_name(key) << " (n=" << factors->n << ")"
+                      << std::endl;
+        } catch (const std::exception &ex) {
+            std::cout << "[server] Nie udało się zapisać czynników LU: " << ex.what() << std::endl;
+        }
+    };
+    return solution;
+}
+
+// RBT + LU bez wyboru elementu głównego (include/butterfly.hpp). Gdy przekształcenie nie usunęło zerowego
+// elementu głównego albo poprawianie nie zbiegło, układ jest rozwiązywany przez lu_factor z wyborem.
+std::vector<double> solve_with_butterfly(const CppMatrix &cpp_matrix, std::uint64_t request_id, std::string &engine) {
+    try {
+        rbt::Result result = rbt::solve(cpp_matrix);
+        engine = "RBT + LU bez wyboru (" + std::to_string(result.refinements) + " kroków poprawiania)";
+        if (result.residual < kStoredResidualLimit) {
+            return std::move(result.x);
+        }
+        std::cout << "[server] #" << request_id << " RBT: reszta " << result.residual
+                  << " po poprawianiu - rozwiązuję z wyborem elementu głównego" << std::endl;
+    } catch (const rbt::PivotBreakdown &) {
+        std::cout << "[server] #" << request_id
+                  << " RBT: zerowy element główny po przekształceniu - rozwiązuję z wyborem elementu głównego"
+                  << std::endl;
+    }
+    engine = "lu_factor (po RBT)";
+    const LuFactors factors = lu_factor(cpp_matrix);
+    const std::vector<double> rhs = augmented_rhs(cpp_matrix);
+    return lu_solve(factors.view(), rhs.data());
+}
+
+// Łączenie prawych stron dla tych samych zapisanych czynników (--rhs-batch); puste = każde żądanie osobno
+std::unique_ptr<batch::RhsBatcher> g_rhs_batcher;
+
+// Łączenie małych układów różnych klientów w paczki SIMD (--micro-batch-us); puste = każde żądanie osobno
+std::unique_ptr<micro::MicroBatcher> g_micro_batcher;
+
+// Wątki równoległego dekodowania XDR macierzy (--xdr-threads); 0 = dekoder xdr_Matrix z rpcgen
+std::size_t g_xdr_threads = std::max(1u, std::thread::hardware_concurrency());
+
+// Największy układ SOLVE_GAUSS (--max-n): nagłówek pochodzi od klienta, więc limit jest sprawdzany
+// przed przydziałem bufora macierzy
+std::size_t g_max_n = 32768;
+
+// Największa siatka SOLVE_STENCIL w punktach (--max-grid-points; 0 = bez limitu)
+std::size_t g_max_grid_points = std::size_t{1} << 26;
+
+// Największy blok i najwięcej niewiadomych SOLVE_BLOCK_TRIDIAG (--max-block, --max-block-unknowns; 0 = bez limitu)
+std::size_t g_max_block = 512;
+std::size_t g_max_block_unknowns = std::size_t{1} << 24;
+
+// Rozwiązania wspólne dla wszystkich procesów serwera (--processes); trafienie omija kolejkę i obliczenia
+std::unique_ptr<store::SharedResultCache> g_result_cache;
+
+// Trafienie przyjmowane tylko, gdy rozwiązuje bieżący układ (jak czynniki z magazynu): klucz to 64-bitowy skrót,
+// a pamięć jest wspólna dla procesów i tenantów, więc kolizja dałaby cudze rozwiązanie
+bool lookup_cached_solution(const CppMatrix &cpp_matrix, std::vector<double> &solution, std::uint64_t request_id) {
+    const std::uint64_t key = store::hash_system(cpp_matrix);
+    if (!g_result_cache->lookup(key, cpp_matrix.rows, solution)) {
+        return false;
+    }
+    if (scaled_residual(cpp_matrix, solution) < kStoredResidualLimit) {
+        return true;
+    }
+    std::cout << "[server] #" << request_id << " wynik z pamięci współdzielonej nie rozwiązuje układu - pomijam go"
+              << std::endl;
+    g_result_cache->reject(key, cpp_matrix.rows);
+    solution.clear();
+    return false;
+}
+
+// Chwila odebrania bieżącego żądania w pętli zdarzeń; sonda decode__done podaje czas od niej w us
+std::chrono::steady_clock::time_point g_received_at;
+
+std::int64_t micros_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Żądania z NaN lub nieskończonością są odrzucane przed obliczeniami, jak przy dekodowaniu SOLVE_GAUSS
+bool reject_non_finite(struct svc_req *rqstp, const double *values, std::size_t count, std::uint64_t request_id) {
+    const double *invalid = std::find_if(values, values + count, [](double value) { return !std::isfinite(value); });
+    if (invalid == values + count) {
+        return false;
+    }
+    std::cout << "[server] #" << request_id << " Odrzucono macierz: wartość nieskończona lub NaN na pozycji "
+              << invalid - values << std::endl;
+    svcerr_decode(rqstp->rq_xprt);
+    return true;
+}
+
+struct SolveOutcome {
+    std::vector<double> solution;
+    std::string error;
+    std::function<void()> persist; // zapis wykonywany w tle po wysłaniu odpowiedzi
+};
+
+SolveOutcome run_parallel_solve(const CppMatrix &cpp_matrix, Engine requested, std::uint64_t request_id,
+                                const std::shared_ptr<memory::RequestLedger> &ledger) {
+    memory::LedgerScope ledger_scope{ledger};
+    auto sampler = std::make_unique<memory::RssSampler>(ledger);
+
+    SolveOutcome outcome;
+    std::string engine = "gaussian_parallel";
+    const auto parallel_start = std::chrono::steady_clock::now();
+    GAUS_PROBE3(solve__start, request_id, SOLVE_GAUSS, cpp_matrix.rows);
+    try {
+        const Engine selected = resolve_engine(requested, cpp_matrix);
+        if (selected == Engine::lapack_cholesky) {
+            engine = "LAPACK dpotrf";
+            outcome.solution = lapack::solve_cholesky(cpp_matrix);
+        } else if (selected == Engine::butterfly) {
+            outcome.solution = solve_with_butterfly(cpp_matrix, request_id, engine);
+        } else if (selected == Engine::in_tree && use_grid_for(cpp_matrix)) {
+            engine = "rozwiązanie rozproszone (siatka)";
+            outcome.solution = solve_on_grid(cpp_matrix);
+        } else if (use_factor_store_for(cpp_matrix)) {
+            outcome.solution = solve_with_factor_store(cpp_matrix, selected, engine, outcome.persist);
+        } else if (selected == Engine::lapack_lu) {
+            engine = "LAPACK dgetrf";
+            outcome.solution = lapack::solve_lu(cpp_matrix);
+        } else {
+            outcome.solution = gaussian_parallel(cpp_matrix);
+        }
+    } catch (const std::exception &ex) {
+        outcome.error = ex.what();
+        std::cout << "[server] #" << request_id << " " << engine << " błąd: " << ex.what() << std::endl;
+    }
+    const auto parallel_stop = std::chrono::steady_clock::now();
+    const auto parallel_ms = std::chrono::duration_cast<std::chrono::milliseconds>(parallel_stop - parallel_start).count();
+    GAUS_PROBE5(solve__end, request_id, SOLVE_GAUSS, cpp_matrix.rows, micros_since(parallel_start),
+                outcome.error.empty());
+    if (outcome.error.empty()) {
+        std::cout << "[server] " << engine << " zakończone w " << parallel_ms << " ms" << std::endl;
+    }
+    if (g_result_cache && outcome.error.empty()) {
+        g_result_cache->insert(store::hash_system(cpp_matrix), outcome.solution);
+    }
+    sampler.reset();
+    log_request_memory(request_id, "rozwiązanie", *ledger);
+    g_stats.record(RequestRecord{request_id, cpp_matrix.rows, cpp_matrix.cols, parallel_ms, ledger});
+    return outcome;
+}
+
+// Weryfikacja w tle: skalowana reszta rozwiązania względem macierzy żądania. Nie zależy od silnika, więc
+// rozwiązania z wyborem elementu głównego (lu_factor, magazyn czynników, LAPACK) nie dają fałszywych alarmów.
+void verify_solution(const CppMatrix &matrix_copy, const std::vector<double> &solution, std::uint64_t request_id,
+                     const std::shared_ptr<memory::RequestLedger> &ledger) {
+    memory::LedgerScope thread_scope{ledger};
+    const auto verification_start = std::chrono::steady_clock::now();
+    const double residual = solution.size() == matrix_copy.rows
+                                ? scaled_residual(matrix_copy, solution)
+                                : std::numeric_limits<double>::infinity();
+    const auto verification_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                     std::chrono::steady_clock::now() - verification_start)
+                                     .count();
+    if (residual < kStoredResidualLimit) {
+        std::cout << "[server] #" << request_id << " weryfikacja zakończona w " << verification_ms
+                  << " ms; rozwiązanie poprawne (skalowana reszta " << residual << ")" << std::endl;
+    } else {
+        std::cout << "[server] #" << request_id << " weryfikacja zakończona w " << verification_ms
+                  << " ms; UWAGA: skalowana reszta " << residual << " przekracza " << kStoredResidualLimit
+                  << std::endl;
+    }
+    log_request_memory(request_id, "weryfikacja", *ledger);
+}
+
+// Konwersja Solution C++ -> Solution RPC
+void fill_solution(Solution &result, const std::vector<double> &solution) {
+    if (result.values.values_val != NULL) {
+        free(result.values.values_val);
+    }
+    result.values.values_len = solution.size();
+    result.values.values_val = (double *)malloc(solution.size() * sizeof(double));
+    std::copy(solution.begin(), solution.end(), result.values.values_val);
+}
+
+bool is_datagram_transport(const SVCXPRT *transp) {
+    int type = 0;
+    socklen_t length = sizeof(type);
+    return getsockopt(transp->xp_fd, SOL_SOCKET, SO_TYPE, &type, &length) == 0 && type == SOCK_DGRAM;
+}
+
+// Tenant z poświadczeń AUTH_SYS: klient podaje nazwę w polu machname (zob. GAUS_TENANT w kliencie)
+std::string tenant_of(const struct svc_req *rqstp) {
+    if (rqstp->rq_cred.oa_flavor == AUTH_SYS && rqstp->rq_clntcred != NULL) {
+        const auto *cred = static_cast<const struct authunix_parms *>(static_cast<const void *>(rqstp->rq_clntcred));
+        if (cred->aup_machname != NULL && cred->aup_machname[0] != '\0') {
+            return cred->aup_machname;
+        }
+        return "uid:" + std::to_string(cred->aup_uid);
+    }
+    return "anonymous";
+}
+
+// Wysyła odpowiedź z pętli zdarzeń i przywraca połączenie do odpytywania
+void send_outcome(SVCXPRT *transp, const SolveOutcome &outcome, std::uint64_t request_id) {
+    bool sent = false;
+    if (outcome.error.empty()) {
+        Solution reply{};
+        fill_solution(reply, outcome.solution);
+        sent = svc_sendreply(transp, (xdrproc_t)xdr_Solution, (char *)&reply);
+        if (!sent) {
+            svcerr_systemerr(transp);
+        }
+        free(reply.values.values_val);
+    } else {
+        svcerr_systemerr(transp);
+    }
+    GAUS_PROBE3(reply__sent, request_id, outcome.solution.size(), sent);
+    xprt_register(transp);
+    g_stats.end_request();
+}
+
+struct StencilRequest {
+    mg::Stencil op;
+    mg::Options options;
+    mg::Field rhs;
+};
+
+SolveOutcome run_stencil_solve(const StencilRequest &request, std::uint64_t request_id,
+                               const std::shared_ptr<memory::RequestLedger> &ledger) {
+    memory::LedgerScope ledger_scope{ledger};
+    auto sampler = std::make_unique<memory::RssSampler>(ledger);
+
+    SolveOutcome outcome;
+    const auto start = std::chrono::steady_clock::now();
+    GAUS_PROBE3(solve__start, request_id, SOLVE_STENCIL, request.op.points());
+    try {
+        mg::Result result = mg::solve(request.op, request.rhs.data(), request.options);
+        std::cout << "[server] multigrid zakończony w "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start)
+                         .count()
+                  << " ms (" << result.levels << " poziomów, "
+                  << result.cycles << " cykli V, residuum względne " << result.relative_residual << ")" << std::endl;
+        if (result.relative_residual > request.options.tolerance) {
+            std::cout << "[server] #" << request_id << " UWAGA: multigrid nie osiągnął tolerancji "
+                      << request.options.tolerance << std::endl;
+        }
+        outcome.solution.assign(result.solution.begin(), result.solution.end());
+    } catch (const std::exception &ex) {
+        outcome.error = ex.what();
+        std::cout << "[server] #" << request_id << " multigrid błąd: " << ex.what() << std::endl;
+    }
+    GAUS_PROBE5(solve__end, request_id, SOLVE_STENCIL, request.op.points(), micros_since(start),
+                outcome.error.empty());
+    const auto elapsed_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    sampler.reset();
+    log_request_memory(request_id, "multigrid", *ledger);
+    g_stats.record(RequestRecord{request_id, request.op.points(), 1, elapsed_ms, ledger});
+    return outcome;
+}
+
+// Żądanie stencilowe TCP: ta sama kolejka tenantów co eliminacja, koszt O(N) zamiast O(n^3)
+async::Task serve_stencil(SVCXPRT *transp, StencilRequest request, std::uint64_t request_id, std::string tenant,
+                          std::shared_ptr<memory::RequestLedger> ledger) {
+    const double flops = mg::estimate_flops(request.op.points());
+    co_await g_scheduler->admit(tenant, flops);
+    const auto service_start = std::chrono::steady_clock::now();
+    SolveOutcome outcome = run_stencil_solve(request, request_id, ledger);
+    g_scheduler->release(tenant, flops,
+                         std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                               service_start));
+
+    co_await g_loop->resume_here();
+    send_outcome(transp, outcome, request_id);
+}
+
+// Bloki łańcuchów skopiowane z argumentu XDR (bufor rpcgen jest zwalniany po powrocie z procedury)
+struct BlockTridiagRequest {
+    std::size_t chains{};
+    std::size_t blocks{};
+    std::size_t b{};
+    btd::Options options;
+    std::vector<double> lower;
+    std::vector<double> diag;
+    std::vector<double> upper;
+    std::vector<double> rhs;
+
+    btd::System system() const {
+        return btd::System{chains, blocks, b, lower.data(), diag.data(), upper.data(), rhs.data()};
+    }
+};
+
+SolveOutcome run_block_tridiag_solve(const BlockTridiagRequest &request, std::uint64_t request_id,
+                                     const std::shared_ptr<memory::RequestLedger> &ledger) {
+    memory::LedgerScope ledger_scope{ledger};
+    auto sampler = std::make_unique<memory::RssSampler>(ledger);
+
+    SolveOutcome outcome;
+    const auto start = std::chrono::steady_clock::now();
+    GAUS_PROBE3(solve__start, request_id, SOLVE_BLOCK_TRIDIAG, request.system().unknowns());
+    try {
+        btd::Result result = btd::solve(request.system(), request.options);
+        std::cout << "[server] układ blokowo-trójdiagonalny (" << btd::method_name(result.method)
+                  << ") zakończony w "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start)
+                         .count()
+                  << " ms" << std::endl;
+        outcome.solution = std::move(result.solution);
+    } catch (const std::exception &ex) {
+        outcome.error = ex.what();
+        std::cout << "[server] #" << request_id << " układ blokowo-trójdiagonalny błąd: " << ex.what() << std::endl;
+    }
+    GAUS_PROBE5(solve__end, request_id, SOLVE_BLOCK_TRIDIAG, request.system().unknowns(), micros_since(start),
+                outcome.error.empty());
+    const auto elapsed_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    sampler.reset();
+    log_request_memory(request_id, "bloki", *ledger);
+    g_stats.record(RequestRecord{request_id, request.chains * request.blocks * request.b, 1, elapsed_ms, ledger});
+    return outcome;
+}
+
+// Łańcuchy blokowe TCP: kolejka tenantów jak dla eliminacji, koszt O(chains * blocks * b^3)
+async::Task serve_block_tridiag(SVCXPRT *transp, BlockTridiagRequest request, std::uint64_t request_id,
+                                std::string tenant, std::shared_ptr<memory::RequestLedger> ledger) {
+    const double flops = btd::estimate_flops(request.chains, request.blocks, request.b);
+    co_await g_scheduler->admit(tenant, flops);
+    const auto service_start = std::chrono::steady_clock::now();
+    SolveOutcome outcome = run_block_tridiag_solve(request, request_id, ledger);
+    g_scheduler->release(tenant, flops,
+                         std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                               service_start));
+
+    co_await g_loop->resume_here();
+    send_outcome(transp, outcome, request_id);
+}
+
+// Dopełnienie Schura: macierz rozszerzona [A | b] i indeksy brzegowe skopiowane z argumentu XDR
+struct SchurJob {
+    CppMatrix augmented;
+    std::vector<std::size_t> interface;
+};
+
+struct SchurOutcome {
+    schur::Result result;
+    std::string error;
+};
+
+SchurOutcome run_schur(const SchurJob &job, std::uint64_t request_id,
+                       const std::shared_ptr<memory::RequestLedger> &ledger) {
+    memory::LedgerScope ledger_scope{ledger};
+    auto sampler = std::make_unique<memory::RssSampler>(ledger);
+
+    SchurOutcome outcome;
+    const std::size_t n = job.augmented.rows;
+    const auto start = std::chrono::steady_clock::now();
+    GAUS_PROBE3(solve__start, request_id, SCHUR_COMPLEMENT, n);
+    try {
+        outcome.result = schur::condense(job.augmented, job.interface);
+        std::cout << "[server] dopełnienie Schura " << outcome.result.m << "x" << outcome.result.m << " ("
+                  << n - outcome.result.m << " niewiadomych wnętrza) zakończone w "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start)
+                         .count()
+                  << " ms" << std::endl;
+    } catch (const std::exception &ex) {
+        outcome.error = ex.what();
+        std::cout << "[server] #" << request_id << " dopełnienie Schura błąd: " << ex.what() << std::endl;
+    }
+    GAUS_PROBE5(solve__end, request_id, SCHUR_COMPLEMENT, n, micros_since(start), outcome.error.empty());
+    const auto elapsed_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    sampler.reset();
+    log_request_memory(request_id, "Schur", *ledger);
+    g_stats.record(RequestRecord{request_id, n, job.augmented.cols, elapsed_ms, ledger});
+    return outcome;
+}
+
+// Konwersja schur::Result -> SchurResult RPC
+void fill_schur_result(SchurResult &reply, const schur::Result &result) {
+    free(reply.complement.complement_val);
+    free(reply.rhs.rhs_val);
+    reply.m = result.m;
+    reply.complement.complement_len = result.complement.size();
+    reply.complement.complement_val = (double *)malloc(result.complement.size() * sizeof(double));
+    std::copy(result.complement.begin(), result.complement.end(), reply.complement.complement_val);
+    reply.rhs.rhs_len = result.rhs.size();
+    reply.rhs.rhs_val = (double *)malloc(result.rhs.size() * sizeof(double));
+    std::copy(result.rhs.begin(), result.rhs.end(), reply.rhs.rhs_val);
+}
+
+// Odpowiednik send_outcome dla SCHUR_COMPLEMENT
+void send_schur_outcome(SVCXPRT *transp, const SchurOutcome &outcome, std::uint64_t request_id) {
+    bool sent = false;
+    if (outcome.error.empty()) {
+        SchurResult reply{};
+        fill_schur_result(reply, outcome.result);
+        sent = svc_sendreply(transp, (xdrproc_t)xdr_SchurResult, (char *)&reply);
+        if (!sent) {
+            svcerr_systemerr(transp);
+        }
+        free(reply.complement.complement_val);
+        free(reply.rhs.rhs_val);
+    } else {
+        svcerr_systemerr(transp);
+    }
+    GAUS_PROBE3(reply__sent, request_id, outcome.result.complement.size() + outcome.result.rhs.size(), sent);
+    xprt_register(transp);
+    g_stats.end_request();
+}
+
+// Dopełnienie Schura TCP: kolejka tenantów jak dla eliminacji, koszt bez ostatnich m kroków eliminacji
+async::Task serve_schur(SVCXPRT *transp, SchurJob job, std::uint64_t request_id, std::string tenant,
+                        std::shared_ptr<memory::RequestLedger> ledger) {
+    const double flops = schur::estimate_flops(job.augmented.rows, job.interface.size());
+    co_await g_scheduler->admit(tenant, flops);
+    const auto service_start = std::chrono::steady_clock::now();
+    SchurOutcome outcome = run_schur(job, request_id, ledger);
+    g_scheduler->release(tenant, flops,
+                         std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                               service_start));
+
+    co_await g_loop->resume_here();
+    send_schur_outcome(transp, outcome, request_id);
+}
+
+// Wspólne dla pamięci podręcznych serwera z limitem wpisów: usuwa najdawniej używane, aż zmieści się nowy wpis.
+// `last_used(value)` podaje chwilę ostatniego użycia; zwraca liczbę usuniętych wpisów.
+template <typename Map, typename LastUsed>
+std::uint64_t evict_least_recent(Map &entries, std::size_t limit, LastUsed &&last_used) {
+    std::uint64_t evicted = 0;
+    while (!entries.empty() && entries.size() >= limit) {
+        entries.erase(std::min_element(entries.begin(), entries.end(), [&](const auto &a, const auto &b) {
+            return last_used(a.second) < last_used(b.second);
+        }));
+        ++evicted;
+    }
+    return evicted;
+}
+
+// Największa sesja RLS (--rls-max-n, --rls-max-window; 0 = bez limitu): sesja trzyma R (n x n) i okno
+// wierszy (window x (n+1)) przez cały czas życia, więc wymiary z RLS_OPEN są sprawdzane przed przydziałem
+std::size_t g_rls_max_n = 1024;
+std::size_t g_rls_max_window = 65536;
+
+// Sesje RLS: stan R/z trzymany w procesie między żądaniami; identyfikatory losowe, sesja należy do tenanta.
+// Po przekroczeniu limitu usuwana jest najdawniej używana sesja.
+struct RlsSession {
+    std::mutex mutex;
+    rls::RlsState state;
+    std::string tenant;
+    std::chrono::steady_clock::time_point last_used;
+
+    RlsSession(std::size_t n, std::size_t window, std::string owner)
+        : state(n, window), tenant(std::move(owner)), last_used(std::chrono::steady_clock::now()) {}
+};
+
+class RlsSessions {
+public:
+    std::uint64_t open(std::size_t n, std::size_t window, const std::string &tenant) {
+        auto session = std::make_shared<RlsSession>(n, window, tenant);
+        std::lock_guard<std::mutex> lock(mutex_);
+        evicted_ += evict_least_recent(sessions_, max_sessions_,
+                                       [](const std::shared_ptr<RlsSession> &entry) { return entry->last_used; });
+        std::uint64_t id = 0;
+        while (id == 0 || sessions_.count(id) != 0) {
+            id = random_();
+        }
+        sessions_.emplace(id, std::move(session));
+        return id;
+    }
+
+    std::shared_ptr<RlsSession> find(std::uint64_t id, const std::string &tenant) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = sessions_.find(id);
+        if (it == sessions_.end() || it->second->tenant != tenant) {
+            return nullptr;
+        }
+        it->second->last_used = std::chrono::steady_clock::now();
+        return it->second;
+    }
+
+    bool close(std::uint64_t id, const std::string &tenant) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = sessions_.find(id);
+        if (it == sessions_.end() || it->second->tenant != tenant) {
+            return false;
+        }
+        sessions_.erase(it);
+        return true;
+    }
+
+    void set_limit(std::size_t max_sessions) { max_sessions_ = std::max<std::size_t>(1, max_sessions); }
+
+    std::string report() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return "rls_sessions " + std::to_string(sessions_.size()) + " evicted=" + std::to_string(evicted_) + "\n";
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::map<std::uint64_t, std::shared_ptr<RlsSession>> sessions_;
+    std::mt19937_64 random_{std::random_device{}()};
+    std::size_t max_sessions_{1024};
+    std::uint64_t evicted_{0};
+};
+
+RlsSessions g_rls_sessions;
+
+// Dopisanie wierszy i rozwiązanie; sesja jest zablokowana, więc kolejne paczki jednej sesji idą po kolei
+SolveOutcome run_rls_update(const std::shared_ptr<RlsSession> &session, const std::vector<double> &rows,
+                            std::size_t count, std::uint64_t request_id) {
+    SolveOutcome outcome;
+    const auto start = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(session->mutex);
+    GAUS_PROBE3(solve__start, request_id, RLS_UPDATE, session->state.unknowns());
+    try {
+        session->state.add_rows(rows.data(), count);
+        outcome.solution = session->state.solve();
+        if (outcome.solution.empty()) {
+            throw std::runtime_error("RLS system does not have full rank yet");
+        }
+    } catch (const std::exception &ex) {
+        outcome.solution.clear();
+        outcome.error = ex.what();
+        std::cout << "[server] #" << request_id << " RLS błąd: " << ex.what() << std::endl;
+    }
+    GAUS_PROBE5(solve__end, request_id, RLS_UPDATE, session->state.unknowns(), micros_since(start),
+                outcome.error.empty());
+    if (!outcome.error.empty()) {
+        return outcome;
+    }
+    const auto &stats = session->state.stats();
+    std::cout << "[server] #" << request_id << " RLS: +" << count << " wierszy (w oknie " << session->state.rows()
+              << ", downdate " << stats.downdates << ", refaktoryzacje " << stats.refactorizations << ") w "
+              << std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start)
+                     .count()
+              << " us" << std::endl;
+    return outcome;
+}
+
+// Koszt dla harmonogramu: obroty Givensa dla nowych wierszy i podstawienie wstecz
+double estimate_rls_flops(const RlsSession &session, std::size_t count) {
+    const double n = static_cast<double>(session.state.unknowns());
+    return 6.0 * n * n * static_cast<double>(count) + n * n;
+}
+
+async::Task serve_rls_update(SVCXPRT *transp, std::shared_ptr<RlsSession> session, std::vector<double> rows,
+                             std::size_t count, std::uint64_t request_id, std::string tenant) {
+    const double flops = estimate_rls_flops(*session, count);
+    co_await g_scheduler->admit(tenant, flops);
+    const auto service_start = std::chrono::steady_clock::now();
+    SolveOutcome outcome = run_rls_update(session, rows, count, request_id);
+    g_scheduler->release(tenant, flops,
+                         std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                               service_start));
+
+    co_await g_loop->resume_here();
+    send_outcome(transp, outcome, request_id);
+}
+
+// Rodziny podobnych macierzy (SOLVE_NEARBY): czynniki LU ostatniej faktoryzowanej macierzy rodziny służą
+// jako prekondycjoner GMRES dla kolejnych, dopóki GMRES zbiega w limicie iteracji. Rodzina należy do tenanta;
+// po przekroczeniu limitu usuwana jest najdawniej używana.
+struct NearbyFamily {
+    std::mutex mutex;
+    LuFactors factors;
+    std::atomic<std::size_t> factored_n{0}; // factors.n do szacowania kosztu bez blokady
+    std::uint64_t reuses{0};                // rozwiązania GMRES od ostatniej faktoryzacji
+    std::chrono::steady_clock::time_point last_used;
+};
+
+class NearbyFamilies {
+public:
+    std::shared_ptr<NearbyFamily> acquire(const std::string &tenant, std::uint64_t id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto key = std::make_pair(tenant, id);
+        auto it = families_.find(key);
+        if (it == families_.end()) {
+            evicted_ += evict_least_recent(families_, max_families_,
+                                           [](const std::shared_ptr<NearbyFamily> &entry) { return entry->last_used; });
+            it = families_.emplace(key, std::make_shared<NearbyFamily>()).first;
+        }
+        it->second->last_used = std::chrono::steady_clock::now();
+        return it->second;
+    }
+
+    void record(bool refactored, std::size_t iterations) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++(refactored ? refactorizations_ : reuses_);
+        iterations_ += iterations;
+    }
+
+    void set_limit(std::size_t max_families) { max_families_ = std::max<std::size_t>(1, max_families); }
+
+    std::string report() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return "nearby_families " + std::to_string(families_.size()) + " gmres=" + std::to_string(reuses_) +
+               " refactors=" + std::to_string(refactorizations_) + " iterations=" + std::to_string(iterations_) +
+               " evicted=" + std::to_string(evicted_) + "\n";
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::map<std::pair<std::string, std::uint64_t>, std::shared_ptr<NearbyFamily>> families_;
+    std::size_t max_families_{64};
+    std::uint64_t reuses_{0};
+    std::uint64_t refactorizations_{0};
+    std::uint64_t iterations_{0};
+    std::uint64_t evicted_{0};
+};
+
+NearbyFamilies g_nearby_families;
+
+// Limit iteracji GMRES przed ponowną faktoryzacją (--nearby-max-iters); żądanie może go tylko obniżyć
+std::size_t g_nearby_max_iterations = 20;
+
+// Koszt dla harmonogramu: iteracje GMRES (mnożenie przez A i podstawienia LU, ok. 4n^2 każda) albo faktoryzacja
+double estimate_nearby_flops(const NearbyFamily &family, std::size_t n, std::size_t max_iterations) {
+    const double size = static_cast<double>(n);
+    const double iteration = 4.0 * size * size;
+    if (family.factored_n.load() != n) {
+        return sched::estimate_flops(n);
+    }
+    return iteration * static_cast<double>(max_iterations + 2);
+}
+
+// Rodzina jest zablokowana, więc kolejne macierze jednej rodziny idą po kolei i widzą najnowsze czynniki
+SolveOutcome run_nearby_solve(const std::shared_ptr<NearbyFamily> &family, const CppMatrix &cpp_matrix,
+                              std::size_t max_iterations, std::uint64_t request_id,
+                              const std::shared_ptr<memory::RequestLedger> &ledger) {
+    memory::LedgerScope ledger_scope{ledger};
+    auto sampler = std::make_unique<memory::RssSampler>(ledger);
+
+    SolveOutcome outcome;
+    std::string engine;
+    std::size_t iterations = 0;
+    const auto start = std::chrono::steady_clock::now();
+    GAUS_PROBE3(solve__start, request_id, SOLVE_NEARBY, cpp_matrix.rows);
+    std::lock_guard<std::mutex> lock(family->mutex);
+    try {
+        if (family->factors.n == cpp_matrix.rows) {
+            krylov::Options options;
+            options.max_iterations = max_iterations;
+            const LuView view = family->factors.view();
+            krylov::Result result =
+                krylov::gmres(cpp_matrix, [&view](const double *v) { return lu_solve(view, v); }, options);
+            iterations = result.iterations;
+            if (result.converged) {
+                outcome.solution = std::move(result.x);
+                ++family->reuses;
+                engine = "GMRES ze starymi czynnikami (użycie " + std::to_string(family->reuses) + ", " +
+                         std::to_string(iterations) + " iteracji)";
+            } else {
+                std::cout << "[server] #" << request_id << " GMRES nie zbiegł w " << iterations
+                          << " iteracjach (reszta " << result.residual << ") - faktoryzuję ponownie" << std::endl;
+            }
+        }
+        if (outcome.solution.empty()) {
+            const bool use_lapack = resolve_engine(Engine::automatic, cpp_matrix) == Engine::lapack_lu;
+            engine = use_lapack ? "LAPACK dgetrf" : "lu_factor";
+            family->factors = use_lapack ? lapack::lu_factor(cpp_matrix) : lu_factor(cpp_matrix);
+            family->factored_n = cpp_matrix.rows;
+            family->reuses = 0;
+            const std::vector<double> rhs = augmented_rhs(cpp_matrix);
+            outcome.solution = lu_solve(family->factors.view(), rhs.data());
+        }
+        g_nearby_families.record(family->reuses == 0, iterations);
+    } catch (const std::exception &ex) {
+        outcome.solution.clear();
+        outcome.error = ex.what();
+        std::cout << "[server] #" << request_id << " rodzina macierzy błąd: " << ex.what() << std::endl;
+    }
+    const auto elapsed_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    GAUS_PROBE5(solve__end, request_id, SOLVE_NEARBY, cpp_matrix.rows, micros_since(start), outcome.error.empty());
+    if (outcome.error.empty()) {
+        std::cout << "[server] #" << request_id << " " << engine << " zakończone w " << elapsed_ms << " ms"
+                  << std::endl;
+    }
+    sampler.reset();
+    log_request_memory(request_id, "rozwiązanie", *ledger);
+    g_stats.record(RequestRecord{request_id, cpp_matrix.rows, cpp_matrix.cols, elapsed_ms, ledger});
+    return outcome;
+}
+
+async::Task serve_nearby(SVCXPRT *transp, std::shared_ptr<NearbyFamily> family, CppMatrix cpp_matrix,
+                         std::size_t max_iterations, std::uint64_t request_id, std::string tenant,
+                         std::shared_ptr<memory::RequestLedger> ledger) {
+    const double flops = estimate_nearby_flops(*family, cpp_matrix.rows, max_iterations);
+    co_await g_scheduler->admit(tenant, flops);
+    const auto service_start = std::chrono::steady_clock::now();
+    SolveOutcome outcome = run_nearby_solve(family, cpp_matrix, max_iterations, request_id, ledger);
+    g_scheduler->release(tenant, flops,
+                         std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                               service_start));
+
+    co_await g_loop->resume_here();
+    send_outcome(transp, outcome, request_id);
+}
+
+// Analizy symboliczne wzorców rzadkich (SOLVE_SPARSE) według skrótu wzorca: macierz o znanym wzorcu zaczyna od
+// faktoryzacji numerycznej. Wzorzec nie zawiera wartości, więc analizy są wspólne dla tenantów; po przekroczeniu
+// limitu usuwana jest najdawniej używana.
+class SymbolicCache {
+public:
+    // Analiza wzorca albo nullptr; kolizja skrótów różnych wzorców jest wykrywana porównaniem i liczy się jak brak
+    std::shared_ptr<const sparse::Symbolic> find(std::uint64_t key, const sparse::Pattern &pattern) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it == entries_.end() || !(it->second.symbolic->pattern == pattern)) {
+            ++misses_;
+            return nullptr;
+        }
+        ++hits_;
+        it->second.last_used = std::chrono::steady_clock::now();
+        return it->second.symbolic;
+    }
+
+    // Koszt faktoryzacji numerycznej znanego wzorca dla harmonogramu; 0, gdy wzorzec nie był analizowany
+    double flops(std::uint64_t key) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        return it != entries_.end() ? it->second.symbolic->flops : 0.0;
+    }
+
+    void insert(std::uint64_t key, std::shared_ptr<const sparse::Symbolic> symbolic) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.erase(key);
+        evicted_ += evict_least_recent(entries_, max_patterns_, [](const Entry &entry) { return entry.last_used; });
+        entries_.emplace(key, Entry{std::move(symbolic), std::chrono::steady_clock::now()});
+    }
+
+    void set_limit(std::size_t max_patterns) { max_patterns_ = std::max<std::size_t>(1, max_patterns); }
+
+    std::string report() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::size_t bytes = 0;
+        for (const auto &[key, entry] : entries_) {
+            bytes += entry.symbolic->bytes();
+        }
+        return "sparse_patterns " + std::to_string(entries_.size()) + " hits=" + std::to_string(hits_) +
+               " misses=" + std::to_string(misses_) + " evicted=" + std::to_string(evicted_) +
+               " bytes=" + std::to_string(bytes) + "\n";
+    }
+
+private:
+    struct Entry {
+        std::shared_ptr<const sparse::Symbolic> symbolic;
+        std::chrono::steady_clock::time_point last_used;
+    };
+
+    mutable std::mutex mutex_;
+    std::map<std::uint64_t, Entry> entries_;
+    std::size_t max_patterns_{64};
+    std::uint64_t hits_{0};
+    std::uint64_t misses_{0};
+    std::uint64_t evicted_{0};
+};
+
+SymbolicCache g_sparse_patterns;
+
+// Największy układ SOLVE_SPARSE (--sparse-max-n) i najwięcej niezerowych czynnika L z analizy symbolicznej
+// (--sparse-max-fill); 0 = bez limitu. Wypełnienie znane jest dopiero z analizy, która wtedy jest przerywana.
+std::size_t g_sparse_max_n = std::size_t{1} << 22;
+std::size_t g_sparse_max_fill = std::size_t{1} << 25;
+
+// Największy układ rzadki rozwiązywany gęsto z wyborem elementu głównego, gdy LU bez wyboru nie osiąga dokładności
+constexpr std::size_t kSparseDenseFallbackMaxN = 4096;
+
+// Wzorzec, wartości i prawa strona skopiowane z argumentu XDR
+struct SparseRequest {
+    sparse::Pattern pattern;
+    std::vector<double> values;
+    std::vector<double> rhs;
+    std::uint64_t key{};
+};
+
+// Koszt dla harmonogramu: faktoryzacja znanego wzorca albo zgrubnie analiza nowego (zależna od wypełnienia)
+double estimate_sparse_flops(const SparseRequest &request) {
+    const double cached = g_sparse_patterns.flops(request.key);
+    return cached > 0.0 ? cached : 100.0 * static_cast<double>(request.pattern.nonzeros());
+}
+
+// Układ rzadki w postaci gęstej [A | b] (awaryjne rozwiązanie z wyborem elementu głównego)
+CppMatrix densify(const SparseRequest &request) {
+    const std::size_t n = request.pattern.n;
+    CppMatrix augmented;
+    augmented.rows = n;
+    augmented.cols = n + 1;
+    augmented.data.assign(n * (n + 1), 0.0);
+    for (std::size_t c = 0; c < n; ++c) {
+        for (std::size_t p = request.pattern.col_start[c]; p < request.pattern.col_start[c + 1]; ++p) {
+            augmented.data[request.pattern.row_index[p] * (n + 1) + c] = request.values[p];
+        }
+    }
+    for (std::size_t r = 0; r < n; ++r) {
+        augmented.data[r * (n + 1) + n] = request.rhs[r];
+    }
+    return augmented;
+}
+
+SolveOutcome run_sparse_solve(const SparseRequest &request, std::uint64_t request_id,
+                              const std::shared_ptr<memory::RequestLedger> &ledger) {
+    memory::LedgerScope ledger_scope{ledger};
+    auto sampler = std::make_unique<memory::RssSampler>(ledger);
+
+    SolveOutcome outcome;
+    std::string engine;
+    const std::size_t n = request.pattern.n;
+    const auto start = std::chrono::steady_clock::now();
+    GAUS_PROBE3(solve__start, request_id, SOLVE_SPARSE, n);
+    try {
+        std::shared_ptr<const sparse::Symbolic> symbolic = g_sparse_patterns.find(request.key, request.pattern);
+        const bool cached = symbolic != nullptr;
+        if (!cached) {
+            symbolic = std::make_shared<const sparse::Symbolic>(sparse::analyze(request.pattern, g_sparse_max_fill));
+            g_sparse_patterns.insert(request.key, symbolic);
+            std::cout << "[server] #" << request_id << " analiza symboliczna wzorca " << store::key_name(request.key)
+                      << " (nnz(A)=" << request.pattern.nonzeros() << ", nnz(L)=" << symbolic->factor_nonzeros()
+                      << ") w "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                               start)
+                             .count()
+                      << " ms" << std::endl;
+        }
+        sparse::Result result = sparse::solve(*symbolic, request.values.data(), request.rhs.data());
+        // Zaburzony element główny może ukrywać macierz osobliwą: o tym rozstrzyga wybór elementu głównego
+        const bool dense_fallback = n <= kSparseDenseFallbackMaxN;
+        if (result.residual < kStoredResidualLimit && (result.perturbed == 0 || !dense_fallback)) {
+            outcome.solution = std::move(result.x);
+            engine = std::string("LU rzadkie (") + (cached ? "wzorzec z pamięci" : "nowy wzorzec") + ", " +
+                     std::to_string(result.refinements) + " poprawek, " + std::to_string(result.perturbed) +
+                     " zaburzonych elementów głównych)";
+        } else if (dense_fallback) {
+            std::cout << "[server] #" << request_id << " LU rzadkie bez wyboru: reszta " << result.residual << ", "
+                      << result.perturbed << " zaburzonych elementów głównych - rozwiązuję gęsto z wyborem elementu"
+                      << " głównego" << std::endl;
+            engine = "lu_factor (po LU rzadkim)";
+            const LuFactors factors = lu_factor(densify(request));
+            outcome.solution = lu_solve(factors.view(), request.rhs.data());
+        } else {
+            throw std::runtime_error("Sparse LU without pivoting did not reach the required accuracy");
+        }
+    } catch (const std::exception &ex) {
+        outcome.solution.clear();
+        outcome.error = ex.what();
+        std::cout << "[server] #" << request_id << " układ rzadki błąd: " << ex.what() << std::endl;
+    }
+    const auto elapsed_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    GAUS_PROBE5(solve__end, request_id, SOLVE_SPARSE, n, micros_since(start), outcome.error.empty());
+    if (outcome.error.empty()) {
+        std::cout << "[server] #" << request_id << " " << engine << " zakończone w " << elapsed_ms << " ms"
+                  << std::endl;
+    }
+    sampler.reset();
+    log_request_memory(request_id, "rozwiązanie", *ledger);
+    g_stats.record(RequestRecord{request_id, n, n + 1, elapsed_ms, ledger});
+    return outcome;
+}
+
+async::Task serve_sparse(SVCXPRT *transp, SparseRequest request, std::uint64_t request_id, std::string tenant,
+                         std::shared_ptr<memory::RequestLedger> ledger) {
+    const double flops = estimate_sparse_flops(request);
+    co_await g_scheduler->admit(tenant, flops);
+    const auto service_start = std::chrono::steady_clock::now();
+    SolveOutcome outcome = run_sparse_solve(request, request_id, ledger);
+    g_scheduler->release(tenant, flops,
+                         std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                               service_start));
+
+    co_await g_loop->resume_here();
+    send_outcome(transp, outcome, request_id);
+}
+
+// Dokończenie żądania rozwiązanego w bloku prawych stron; puste rozwiązanie, gdy czynniki nie pasują do układu
+SolveOutcome finish_batched_solve(const CppMatrix &cpp_matrix, batch::RhsSlot &slot, std::uint64_t key,
+                                  std::uint64_t request_id, const std::shared_ptr<memory::RequestLedger> &ledger,
+                                  std::chrono::steady_clock::time_point start) {
+    SolveOutcome outcome;
+    GAUS_PROBE5(solve__end, request_id, SOLVE_GAUSS, cpp_matrix.rows, micros_since(start), slot.solved);
+    if (!slot.error.empty()) {
+        std::cout << "[server] #" << request_id << " blok prawych stron błąd: " << slot.error << std::endl;
+    }
+    if (!slot.solved || scaled_residual(cpp_matrix, slot.values) >= kStoredResidualLimit) {
+        std::cout << "[server] #" << request_id << " Czynniki " << store::key_name(key)
+                  << " nie rozwiązują układu - faktoryzuję ponownie" << std::endl;
+        return outcome;
+    }
+    outcome.solution = std::move(slot.values);
+    const auto elapsed_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "[server] #" << request_id << " zapisana faktoryzacja LU " << store::key_name(key) << " (blok "
+              << slot.width << " prawych stron) zakończone w " << elapsed_ms << " ms" << std::endl;
+    if (g_result_cache) {
+        g_result_cache->insert(store::hash_system(cpp_matrix), outcome.solution);
+    }
+    log_request_memory(request_id, "rozwiązanie", *ledger);
+    g_stats.record(RequestRecord{request_id, cpp_matrix.rows, cpp_matrix.cols, elapsed_ms, ledger});
+    return outcome;
+}
+
+// Co który układ z paczek małych układów przechodzi weryfikację w tle (--micro-batch-verify; 0 = żaden).
+// Jądro SIMD jest wspólne dla wszystkich pasów, więc próbka wykrywa jego błędy bez kosztu weryfikacji każdego.
+std::size_t g_micro_verify_every = 16;
+std::atomic<std::uint64_t> g_micro_verify_counter{0};
+
+bool sample_micro_verification() {
+    return g_micro_verify_every != 0 &&
+           g_micro_verify_counter.fetch_add(1, std::memory_order_relaxed) % g_micro_verify_every == 0;
+}
+
+// Dokończenie żądania rozwiązanego w paczce małych układów (--micro-batch-us)
+SolveOutcome finish_micro_solve(const CppMatrix &cpp_matrix, micro::Slot &slot, std::uint64_t request_id,
+                                const std::shared_ptr<memory::RequestLedger> &ledger,
+                                std::chrono::steady_clock::time_point start) {
+    SolveOutcome outcome;
+    GAUS_PROBE5(solve__end, request_id, SOLVE_GAUSS, cpp_matrix.rows, micros_since(start), !slot.singular);
+    const auto elapsed_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    if (slot.singular) {
+        outcome.error = "Matrix is singular or ill-conditioned";
+        std::cout << "[server] #" << request_id << " paczka małych układów błąd: " << outcome.error << std::endl;
+    } else {
+        outcome.solution = std::move(slot.solution);
+        std::cout << "[server] #" << request_id << " paczka małych układów (" << slot.width
+                  << " układów) zakończone w " << elapsed_ms << " ms" << std::endl;
+        if (g_result_cache) {
+            g_result_cache->insert(store::hash_system(cpp_matrix), outcome.solution);
+        }
+    }
+    log_request_memory(request_id, "rozwiązanie", *ledger);
+    g_stats.record(RequestRecord{request_id, cpp_matrix.rows, cpp_matrix.cols, elapsed_ms, ledger});
+    return outcome;
+}
+
+// Odpowiedź SOLVE_GAUSS wysyłana z pętli zdarzeń: przez TIRPC (send_outcome) albo protokołem natywnym
+using SolveReply = std::function<void(const SolveOutcome &)>;
+
+// Obsługa żądania TCP: kolejka tenantów, obliczenia w puli, odpowiedź z powrotem w pętli zdarzeń.
+// Połączenie jest wyłączone z odpytywania do czasu wysłania odpowiedzi (xid jest zapisany w transporcie).
+async::Task serve_solve(SolveReply reply, CppMatrix cpp_matrix, Engine engine, std::uint64_t request_id,
+                        std::string tenant, std::shared_ptr<memory::RequestLedger> ledger) {
+    // Czynniki są już zapisane: prawa strona dołącza do bloku rozwiązywanego jednym przejściem po L i U
+    if (g_rhs_batcher && engine != Engine::lapack_cholesky && engine != Engine::butterfly &&
+        use_factor_store_for(cpp_matrix) && !use_grid_for(cpp_matrix)) {
+        const std::uint64_t key = store::hash_coefficients(cpp_matrix);
+        auto mapped = g_factor_store->find(key, cpp_matrix.rows);
+        if (mapped && mapped->precision() == store::Precision::full) {
+            const auto start = std::chrono::steady_clock::now();
+            GAUS_PROBE3(solve__start, request_id, SOLVE_GAUSS, cpp_matrix.rows);
+            batch::RhsSlot slot;
+            slot.values = augmented_rhs(cpp_matrix);
+            const double n = static_cast<double>(cpp_matrix.rows);
+            const double solve_flops = 2.0 * n * n;
+            if (co_await g_rhs_batcher->join(key, slot)) {
+                // Przytrzymanie grupy odbywa się w pętli zdarzeń, nie w slocie obliczeniowym
+                co_await g_loop->resume_at(g_rhs_batcher->deadline(slot));
+                co_await g_scheduler->admit(tenant, solve_flops);
+                const auto service_start = std::chrono::steady_clock::now();
+                g_rhs_batcher->solve_group(key, slot, mapped->view(),
+                                           [](std::coroutine_handle<> member) { g_compute->post(member); });
+                g_scheduler->release(tenant, solve_flops,
+                                     std::chrono::duration_cast<std::chrono::milliseconds>(
+                                         std::chrono::steady_clock::now() - service_start));
+            } else {
+                // Członek nie przeszedł przez admit(): jego prawa strona obciąża własnego tenanta
+                g_scheduler->charge(tenant, solve_flops);
+            }
+            mapped.reset();
+
+            SolveOutcome outcome = finish_batched_solve(cpp_matrix, slot, key, request_id, ledger, start);
+            if (!outcome.solution.empty()) {
+                co_await g_loop->resume_here();
+                reply(outcome);
+                if (reserve_verification(request_id)) {
+                    co_await g_verification->schedule();
+                    verify_solution(cpp_matrix, outcome.solution, request_id, ledger);
+                }
+                co_return;
+            }
+        }
+    }
+
+    // Mały układ: zamiast procesów workerów dołącza do paczki układów tego samego rozmiaru od innych klientów
+    if (g_micro_batcher && engine == Engine::automatic && cpp_matrix.rows <= g_micro_batcher->max_n() &&
+        !use_factor_store_for(cpp_matrix) && !use_grid_for(cpp_matrix)) {
+        const auto start = std::chrono::steady_clock::now();
+        GAUS_PROBE3(solve__start, request_id, SOLVE_GAUSS, cpp_matrix.rows);
+        micro::Slot slot;
+        slot.matrix = &cpp_matrix;
+        const double flops = sched::estimate_flops(cpp_matrix.rows);
+        if (co_await g_micro_batcher->join(slot)) {
+            co_await g_loop->resume_at(g_micro_batcher->deadline(slot));
+            co_await g_scheduler->admit(tenant, flops);
+            const auto service_start = std::chrono::steady_clock::now();
+            const std::size_t threads =
+                std::max<std::size_t>(1, std::thread::hardware_concurrency() / g_compute->slots());
+            g_micro_batcher->solve_group(slot, threads,
+                                         [](std::coroutine_handle<> member) { g_compute->post(member); });
+            g_scheduler->release(tenant, flops,
+                                 std::chrono::duration_cast<std::chrono::milliseconds>(
+                                     std::chrono::steady_clock::now() - service_start));
+        } else {
+            g_scheduler->charge(tenant, flops);
+        }
+
+        if (slot.solved) {
+            SolveOutcome outcome = finish_micro_solve(cpp_matrix, slot, request_id, ledger, start);
+            co_await g_loop->resume_here();
+            reply(outcome);
+            if (outcome.error.empty() && sample_micro_verification() && reserve_verification(request_id)) {
+                co_await g_verification->schedule();
+                verify_solution(cpp_matrix, outcome.solution, request_id, ledger);
+            }
+            co_return;
+        }
+        std::cout << "[server] #" << request_id << " paczka małych układów błąd: " << slot.error
+                  << " - rozwiązuję osobno" << std::endl;
+    }
+
+    const double flops = sched::estimate_flops(cpp_matrix.rows);
+    co_await g_scheduler->admit(tenant, flops);
+    const auto service_start = std::chrono::steady_clock::now();
+    SolveOutcome outcome = run_parallel_solve(cpp_matrix, engine, request_id, ledger);
+    g_scheduler->release(tenant, flops,
+                         std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                               service_start));
+
+    co_await g_loop->resume_here();
+    reply(outcome);
+
+    // Zapis czynników idzie do puli weryfikacji także wtedy, gdy na weryfikację nie ma miejsca
+    const bool verify = outcome.error.empty() && reserve_verification(request_id);
+    if (verify || outcome.persist) {
+        if (!verify) {
+            cpp_matrix = CppMatrix{};
+        }
+        co_await g_verification->schedule();
+        if (outcome.persist) {
+            outcome.persist();
+        }
+        if (verify) {
+            verify_solution(cpp_matrix, outcome.solution, request_id, ledger);
+        }
+    }
+}
+
+// Gniazdo z SO_REUSEPORT na stałym porcie: każdy proces serwera ma własne, a jądro rozdziela między nie ruch
+int bind_reuseport(int type, std::uint16_t port) {
+    const int fd = socket(AF_INET, type, 0);
+    if (fd == -1) {
+        return -1;
+    }
+    const int one = 1;
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) == -1 ||
+        setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) == -1 ||
+        bind(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == -1 ||
+        (type == SOCK_STREAM && listen(fd, SOMAXCONN) == -1)) {
+        const int saved = errno;
+        close(fd);
+        errno = saved;
+        return -1;
+    }
+    return fd;
+}
+
+// Transporty UDP i TCP; gdy portmapper obsługuje nadzorca procesów, rejestracja jest tylko lokalna (protokół 0)
+int create_transports(std::uint16_t port, bool register_portmap) {
+    int udp_sock = RPC_ANYSOCK;
+    int tcp_sock = RPC_ANYSOCK;
+    if (port != 0) {
+        udp_sock = bind_reuseport(SOCK_DGRAM, port);
+        tcp_sock = bind_reuseport(SOCK_STREAM, port);
+        if (udp_sock == -1 || tcp_sock == -1) {
+            std::cerr << detail::errno_message(("cannot bind port " + std::to_string(port)).c_str()) << std::endl;
+            return 1;
+        }
+    }
+
+    SVCXPRT *transp = svcudp_create(udp_sock);
+    if (transp == NULL) {
+        std::cerr << "cannot create udp service." << std::endl;
+        return 1;
+    }
+    if (!svc_register(transp, GAUSS_RPC, GAUSS_V, gauss_rpc_dispatch, register_portmap ? IPPROTO_UDP : 0)) {
+        std::cerr << "unable to register (GAUSS_RPC, GAUSS_V, udp)." << std::endl;
+        return 1;
+    }
+
+    transp = svctcp_create(tcp_sock, 0, 0);
+    if (transp == NULL) {
+        std::cerr << "cannot create tcp service." << std::endl;
+        return 1;
+    }
+    if (!svc_register(transp, GAUSS_RPC, GAUSS_V, gauss_rpc_dispatch, register_portmap ? IPPROTO_TCP : 0)) {
+        std::cerr << "unable to register (GAUSS_RPC, GAUSS_V, tcp)." << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Protokół natywny (--native-port, zob. include/native_wire.hpp): ramki little-endian obsługiwane w pętli
+// zdarzeń obok transportów RPC, z tym samym harmonogramem, magazynem czynników i pamięcią wyników co SOLVE_GAUSS.
+// Połączenie jest wyłączone z odpytywania od odczytu ramki do wysłania odpowiedzi, jak przy xprt_unregister.
+void watch_native_connection(int fd);
+
+void send_native_outcome(int fd, const SolveOutcome &outcome, std::uint64_t request_id) {
+    const bool sent = outcome.error.empty()
+                          ? native::write_values(fd, outcome.solution.data(), outcome.solution.size())
+                          : native::write_error(fd, native::Status::solve_failed, outcome.error);
+    GAUS_PROBE3(reply__sent, request_id, outcome.solution.size(), sent && outcome.error.empty());
+    if (sent) {
+        watch_native_connection(fd);
+    } else {
+        close(fd);
+    }
+    g_stats.end_request();
+}
+
+// Ramka niezgodna z protokołem: dalsze dane połączenia nie dają się podzielić na ramki, więc jest ono zamykane
+void reject_native_frame(int fd, const std::string &reason) {
+    std::cout << "[server] Odrzucono ramkę natywną: " << reason << std::endl;
+    g_loop->unwatch(fd);
+    native::write_error(fd, native::Status::bad_request, reason);
+    close(fd);
+}
+
+void close_native_connection(int fd) {
+    g_loop->unwatch(fd);
+    close(fd);
+}
+
+// Ramka odbierana częściami przy kolejnych gotowościach gniazda: powolny klient nie wstrzymuje pętli zdarzeń
+struct NativeFrame {
+    native::RequestHeader header{};
+    std::size_t header_done{0};
+    bool header_ready{false};
+    std::string tenant;
+    CppMatrix matrix;
+    std::shared_ptr<memory::RequestLedger> ledger;
+    std::size_t payload_done{0};
+};
+
+// Nagłówek odebrany w całości: kontrola i bufory na resztę ramki; false, gdy połączenie zostało zamknięte
+bool accept_native_header(int fd, NativeFrame &frame) {
+    const native::RequestHeader &header = frame.header;
+    g_received_at = std::chrono::steady_clock::now();
+    GAUS_PROBE1(request__receive, header.procedure);
+    if (header.magic != native::kMagic || header.version != native::kVersion) {
+        reject_native_frame(fd, "invalid frame header");
+        return false;
+    }
+    if (header.procedure != SOLVE_GAUSS) {
+        reject_native_frame(fd, "unsupported procedure " + std::to_string(header.procedure));
+        return false;
+    }
+    if (header.rows == 0 || header.cols != header.rows + 1 || header.tenant_bytes > native::kMaxTenantBytes) {
+        reject_native_frame(fd, "matrix must be n x (n+1)");
+        return false;
+    }
+    if (header.engine > kMaxEngine) {
+        reject_native_frame(fd, "unknown engine " + std::to_string(header.engine));
+        return false;
+    }
+    if (g_max_n != 0 && header.rows > g_max_n) {
+        reject_native_frame(fd, "matrix larger than --max-n " + std::to_string(g_max_n));
+        return false;
+    }
+
+    frame.ledger = std::make_shared<memory::RequestLedger>();
+    memory::LedgerScope ledger_scope{frame.ledger};
+    frame.matrix.rows = header.rows;
+    frame.matrix.cols = header.cols;
+    try {
+        // Bufor jest od razu nadpisywany przez recvmsg, więc zerowanie byłoby zbędnym przejściem po pamięci
+        memory::SkipZeroFill uninitialized;
+        frame.tenant.resize(header.tenant_bytes);
+        frame.matrix.data.resize(frame.matrix.rows * frame.matrix.cols);
+    } catch (const std::exception &) {
+        reject_native_frame(fd, "matrix does not fit in memory");
+        return false;
+    }
+    frame.header_ready = true;
+    return true;
+}
+
+void on_native_readable(int fd, NativeFrame &frame) {
+    if (!frame.header_ready) {
+        const native::Receive status = native::receive_header(fd, frame.header, frame.header_done);
+        if (status == native::Receive::pending) {
+            return;
+        }
+        if (status == native::Receive::closed) {
+            close_native_connection(fd);
+            return;
+        }
+        if (!accept_native_header(fd, frame)) {
+            return;
+        }
+    }
+    const native::Receive status = native::receive_payload(fd, frame.tenant, frame.matrix, frame.payload_done);
+    if (status == native::Receive::pending) {
+        return;
+    }
+    if (status == native::Receive::closed) {
+        close_native_connection(fd);
+        return;
+    }
+    // Cała ramka odebrana: do wysłania odpowiedzi połączenie nie jest odpytywane (wywołujący trzyma kopię `frame`)
+    g_loop->unwatch(fd);
+
+    const std::shared_ptr<memory::RequestLedger> ledger = frame.ledger;
+    memory::LedgerScope ledger_scope{ledger};
+    CppMatrix cpp_matrix = std::move(frame.matrix);
+    std::string tenant = std::move(frame.tenant);
+    const Engine engine = static_cast<Engine>(frame.header.engine);
+    const auto invalid = std::find_if(cpp_matrix.data.begin(), cpp_matrix.data.end(),
+                                      [](double value) { return !std::isfinite(value); });
+    if (invalid != cpp_matrix.data.end()) {
+        reject_native_frame(fd, "NaN or infinite value at index " + std::to_string(invalid - cpp_matrix.data.begin()));
+        return;
+    }
+    if (tenant.empty()) {
+        tenant = "anonymous";
+    }
+
+    const std::uint64_t request_id = g_stats.next_id();
+    GAUS_PROBE5(decode__done, request_id, SOLVE_GAUSS, cpp_matrix.rows, cpp_matrix.cols, micros_since(g_received_at));
+    std::cout << "[server] #" << request_id << " Otrzymano macierz " << cpp_matrix.rows << "x" << cpp_matrix.cols
+              << " protokołem natywnym (tenant " << tenant << ")" << std::endl;
+
+    g_stats.begin_request();
+    if (g_result_cache && engine == Engine::automatic) {
+        SolveOutcome cached;
+        if (lookup_cached_solution(cpp_matrix, cached.solution, request_id)) {
+            std::cout << "[server] #" << request_id << " wynik z pamięci współdzielonej" << std::endl;
+            send_native_outcome(fd, cached, request_id);
+            return;
+        }
+    }
+    serve_solve([fd, request_id](const SolveOutcome &outcome) { send_native_outcome(fd, outcome, request_id); },
+                std::move(cpp_matrix), engine, request_id, tenant, ledger);
+}
+
+// Każda ramka dostaje nowy stan odbioru; obserwator jest zdejmowany po odebraniu całej ramki
+void watch_native_connection(int fd) {
+    auto frame = std::make_shared<NativeFrame>();
+    g_loop->watch(fd, [fd, frame]() { on_native_readable(fd, *frame); });
+}
+
+void on_native_accept(int listen_fd) {
+    const int fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd == -1) {
+        return;
+    }
+    // Ramki są czytane bez blokowania; odpowiedź jest wysyłana w pętli zdarzeń z limitem jak w TIRPC (35 s)
+    const int one = 1;
+    const timeval timeout{35, 0};
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    watch_native_connection(fd);
+}
+
+struct ServeConfig {
+    std::size_t compute_slots{1};
+    std::vector<std::pair<std::string, sched::TenantPolicy>> tenant_policies;
+    std::uint16_t port{0};
+    std::uint16_t native_port{0}; // 0 = bez protokołu natywnego
+    bool register_portmap{true};
+};
+
+// Jeden proces serwera: wątki potoku powstają dopiero tutaj, czyli już po fork() nadzorcy
+int serve_requests(const ServeConfig &config) {
+    if (g_grid_config) {
+        stop_grid_on_signal();
+    }
+    g_loop = std::make_unique<async::EventLoop>();
+    g_compute = std::make_unique<async::ComputePool>(config.compute_slots);
+    g_verification = std::make_unique<async::ComputePool>(1);
+    g_scheduler = std::make_unique<sched::FairScheduler>(*g_compute);
+    if (g_grid_config) {
+        start_grid_coordinator();
+    }
+    for (const auto &[tenant, policy] : config.tenant_policies) {
+        g_scheduler->set_policy(tenant, policy);
+    }
+
+    if (config.register_portmap) {
+        pmap_unset(GAUSS_RPC, GAUSS_V);
+    }
+    if (create_transports(config.port, config.register_portmap) != 0) {
+        return 1;
+    }
+    if (config.native_port != 0) {
+        const int native_fd = bind_reuseport(SOCK_STREAM, config.native_port);
+        if (native_fd == -1) {
+            std::cerr << detail::errno_message(("cannot bind native port " + std::to_string(config.native_port)).c_str())
+                      << std::endl;
+            return 1;
+        }
+        g_loop->watch(native_fd, [native_fd]() { on_native_accept(native_fd); });
+        std::cout << "[server] Protokół natywny na porcie " << config.native_port << std::endl;
+    }
+
+    std::cout << "[server] Uruchomiono (pid " << getpid() << ") i oczekuję na żądania (sloty obliczeniowe: "
+              << config.compute_slots << ")..." << std::endl;
+    g_loop->run();
+}
+
+volatile std::sig_atomic_t g_stop_signal = 0;
+
+void on_stop_signal(int signal) { g_stop_signal = signal; }
+
+// Nadzorca trybu --processes: rejestruje stały port w portmapperze raz, uruchamia N procesów
+// na tym samym porcie i wznawia te, które padły. SIGTERM/SIGINT kończy wszystkie procesy.
+int supervise_processes(std::size_t count, const ServeConfig &config) {
+    struct sigaction action {};
+    action.sa_handler = on_stop_signal; // bez SA_RESTART, żeby waitpid() wrócił z EINTR
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGTERM, &action, nullptr);
+    sigaction(SIGINT, &action, nullptr);
+
+    pmap_unset(GAUSS_RPC, GAUSS_V);
+    if (!pmap_set(GAUSS_RPC, GAUSS_V, IPPROTO_UDP, config.port) ||
+        !pmap_set(GAUSS_RPC, GAUSS_V, IPPROTO_TCP, config.port)) {
+        std::cout << "[server] Portmapper niedostępny - klienci muszą łączyć się bezpośrednio z portem "
+                  << config.port << std::endl;
+    }
+
+    const pid_t supervisor = getpid();
+    std::vector<pid_t> children(count, -1);
+    auto spawn = [&](std::size_t index) {
+        const pid_t pid = fork();
+        if (pid == 0) {
+            std::signal(SIGTERM, SIG_DFL);
+            std::signal(SIGINT, SIG_DFL);
+            prctl(PR_SET_PDEATHSIG, SIGTERM);
+            if (getppid() != supervisor) {
+                std::_Exit(1);
+            }
+            std::exit(serve_requests(config));
+        }
+        if (pid == -1) {
+            std::cout << "[server] " << detail::errno_message("fork failed") << std::endl;
+        }
+        children[index] = pid;
+    };
+    for (std::size_t i = 0; i < count; ++i) {
+        spawn(i);
+    }
+
+    while (g_stop_signal == 0) {
+        int status = 0;
+        const pid_t pid = waitpid(-1, &status, 0);
+        if (pid == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        const auto it = std::find(children.begin(), children.end(), pid);
+        if (it == children.end() || g_stop_signal != 0) {
+            continue;
+        }
+        std::cout << "[server] Proces " << pid << " zakończył się (status " << status << ") - uruchamiam ponownie"
+                  << std::endl;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        spawn(static_cast<std::size_t>(it - children.begin()));
+    }
+
+    for (pid_t pid : children) {
+        if (pid > 0) {
+            kill(pid, SIGTERM);
+        }
+    }
+    for (pid_t pid : children) {
+        if (pid > 0) {
+            waitpid(pid, nullptr, 0);
+        }
+    }
+    pmap_unset(GAUSS_RPC, GAUSS_V);
+    return 0;
+}
+
+void print_usage(const char *prog) {
+    std::cerr << "Użycie: " << prog << " [--slots N] [--tenant nazwa=waga[,limit]]...\n"
+              << "       [--grid PxQ --rank R --peers host:port,... [--grid-block NB] [--grid-min-n N]]\n"
+              << "       [--factor-dir DIR [--factor-store-mb N] [--factor-min-n N] [--factor-precision P]]\n"
+              << "       [--processes N --port P] [--result-cache-mb N] [--result-cache-max-n N] [--xdr-threads N]\n"
+              << "       [--rls-sessions N] [--rls-max-n N] [--rls-max-window N] [--rhs-batch K] [--rhs-batch-us N]\n"
+              << "       [--nearby-families N] [--nearby-max-iters N]\n"
+              << "       [--micro-batch-us N [--micro-batch-max-n N] [--micro-batch-max K]\n"
+              << "       [--micro-batch-verify N]] [--sparse-patterns N]\n"
+              << "       [--sparse-max-n N] [--sparse-max-fill N]\n"
+              << "       [--verify-queue N] [--udp-max-mflop N] [--max-n N] [--max-grid-points N]\n"
+              << "       [--max-block N] [--max-block-unknowns N]\n"
+              << "  --slots N  -> liczba równoczesnych rozwiązań w puli obliczeniowej (domyślnie 1)\n"
+              << "  --tenant   -> udział (waga) i limit równoległych rozwiązań tenanta (domyślnie 1, bez limitu)\n"
+              << "  --grid     -> tryb rozproszony: P*Q procesów, rank 0 przyjmuje żądania RPC,\n"
+              << "                pozostałe tylko liczą; --peers podaje adresy wszystkich procesów wg ranku\n"
+              << "  --grid-block NB -> rozmiar bloku rozkładu blokowo-cyklicznego (domyślnie 64)\n"
+              << "  --grid-min-n N  -> najmniejszy rozmiar układu liczony na siatce (domyślnie 256)\n"
+              << "  --factor-dir DIR -> trwały magazyn czynników LU (pliki mmap), wczytywany przy starcie\n"
+              << "  --factor-store-mb N -> limit rozmiaru magazynu w MiB (domyślnie bez limitu)\n"
+              << "  --factor-min-n N -> najmniejszy układ, którego czynniki są zapisywane (domyślnie 64)\n"
+              << "  --factor-precision single|double -> zapis czynników jako float (połowa miejsca, rozwiązanie\n"
+              << "                poprawiane iteracyjnie w double) albo double (domyślnie)\n"
+              << "  --rhs-batch K -> najwięcej prawych stron rozwiązywanych razem z tymi samymi czynnikami (domyślnie 32;\n"
+              << "                1 = bez łączenia)\n"
+              << "  --rhs-batch-us N -> lider bloku czeka do N us na kolejne prawe strony (domyślnie 0)\n"
+              << "  --micro-batch-us N -> małe układy (wybór automatyczny) czekają do N us na układy tego samego\n"
+              << "                rozmiaru od innych klientów i są rozwiązywane razem wektorowo\n"
+              << "                (domyślnie 0 = wyłączone)\n"
+              << "  --micro-batch-max-n N -> największy układ łączony w paczki (domyślnie 32)\n"
+              << "  --micro-batch-max K -> najwięcej układów w jednej paczce (domyślnie 256)\n"
+              << "  --micro-batch-verify N -> weryfikacja w tle co N-tego układu z paczek (domyślnie 16; 1 = każdy,\n"
+              << "                0 = żaden)\n"
+              << "  --native-port P -> SOLVE_GAUSS także protokołem natywnym (ramki little-endian) na porcie P\n"
+              << "  --lapack-min-n N -> wybór automatyczny używa LAPACK od n = N (domyślnie 1; tylko w kompilacji\n"
+              << "                z LAPACK=1)\n"
+              << "  --processes N --port P -> N procesów serwera na wspólnym porcie P (SO_REUSEPORT);\n"
+              << "                czynniki LU bez --factor-dir trafiają do /dev/shm\n"
+              << "  --result-cache-mb N -> pamięć współdzielona na gotowe rozwiązania (domyślnie 64 przy --processes)\n"
+              << "  --result-cache-max-n N -> największy układ, którego rozwiązanie jest zapamiętywane (domyślnie 4096)\n"
+              << "  --xdr-threads N -> wątki dekodujące duże macierze (domyślnie liczba rdzeni; 0 = dekoder rpcgen)\n"
+              << "  --max-n N -> największy przyjmowany układ SOLVE_GAUSS (domyślnie 32768; 0 = bez limitu)\n"
+              << "  --max-grid-points N -> największa siatka SOLVE_STENCIL w punktach (domyślnie 67108864;\n"
+              << "                0 = bez limitu)\n"
+              << "  --max-block N -> największy blok SOLVE_BLOCK_TRIDIAG (domyślnie 512; 0 = bez limitu)\n"
+              << "  --max-block-unknowns N -> najwięcej niewiadomych SOLVE_BLOCK_TRIDIAG (domyślnie 16777216;\n"
+              << "                0 = bez limitu)\n"
+              << "  --rls-sessions N -> limit otwartych sesji RLS; najdawniej używane są zamykane (domyślnie 1024)\n"
+              << "  --rls-max-n N -> najwięcej niewiadomych w sesji RLS (domyślnie 1024; 0 = bez limitu)\n"
+              << "  --rls-max-window N -> najdłuższe okno wierszy sesji RLS (domyślnie 65536; 0 = bez limitu)\n"
+              << "  --nearby-families N -> limit rodzin SOLVE_NEARBY z zapamiętanymi czynnikami LU (domyślnie 64)\n"
+              << "  --nearby-max-iters N -> iteracje GMRES, po których rodzina jest faktoryzowana ponownie; także\n"
+              << "                górny limit max_iterations z żądania (domyślnie 20)\n"
+              << "  --sparse-patterns N -> limit wzorców SOLVE_SPARSE z zapamiętaną analizą symboliczną\n"
+              << "                (domyślnie 64)\n"
+              << "  --sparse-max-n N -> największy układ SOLVE_SPARSE (domyślnie 4194304; 0 = bez limitu)\n"
+              << "  --sparse-max-fill N -> najwięcej niezerowych czynnika L; większa analiza jest przerywana\n"
+              << "                (domyślnie 33554432; 0 = bez limitu)\n"
+              << "  --verify-queue N -> najwięcej rozwiązań czekających na weryfikację w tle; przy pełnej kolejce\n"
+              << "                rozwiązanie nie jest weryfikowane (domyślnie 64)\n"
+              << "  --udp-max-mflop N -> największy koszt żądania liczonego od razu przez UDP; większe tylko przez TCP\n"
+              << "                (domyślnie 10)\n";
+}
+
+// Wspólna obsługa SOLVE_GAUSS i SOLVE_WITH_ENGINE po zdekodowaniu argumentu (równolegle albo przez rpcgen).
+// Pamięć wyników dotyczy tylko wyboru automatycznego: jawnie wybrany silnik zawsze liczy (np. do porównań).
+Solution *solve_gauss_decoded(CppMatrix cpp_matrix, Engine engine, const std::shared_ptr<memory::RequestLedger> &ledger,
+                              struct svc_req *rqstp) {
     static Solution result;
 
-    const auto request_rows = static_cast<std::size_t>(argp->rows);
-    const auto request_cols = static_cast<std::size_t>(argp->cols);
-    std::cout << "[server] Otrzymano macierz " << request_rows << "x" << request_cols << std::endl;
+    const std::uint64_t request_id = g_stats.next_id();
+    const std::string tenant = tenant_of(rqstp);
+    GAUS_PROBE5(decode__done, request_id, SOLVE_GAUSS, cpp_matrix.rows, cpp_matrix.cols, micros_since(g_received_at));
+    std::cout << "[server] #" << request_id << " Otrzymano macierz " << cpp_matrix.rows << "x" << cpp_matrix.cols
+              << " (tenant " << tenant << ")" << std::endl;
+
+    // Skróty, pamięć wyników i paczki indeksują macierz jako n x (n+1), zanim silnik sprawdzi wymiary
+    if (cpp_matrix.rows == 0 || cpp_matrix.cols != cpp_matrix.rows + 1 ||
+        cpp_matrix.data.size() != cpp_matrix.rows * cpp_matrix.cols) {
+        std::cout << "[server] #" << request_id << " Macierz musi mieć wymiary n x (n+1)" << std::endl;
+        svcerr_decode(rqstp->rq_xprt);
+        return NULL;
+    }
+    if (g_max_n != 0 && cpp_matrix.rows > g_max_n) {
+        std::cout << "[server] #" << request_id << " Macierz większa niż --max-n " << g_max_n << std::endl;
+        svcerr_decode(rqstp->rq_xprt);
+        return NULL;
+    }
+
+    if (g_result_cache && engine == Engine::automatic) {
+        std::vector<double> cached;
+        if (lookup_cached_solution(cpp_matrix, cached, request_id)) {
+            std::cout << "[server] #" << request_id << " wynik z pamięci współdzielonej" << std::endl;
+            fill_solution(result, cached);
+            GAUS_PROBE3(reply__sent, request_id, result.values.values_len, true);
+            return &result;
+        }
+    }
+
+    // UDP przechowuje adres nadawcy tylko ostatniego datagramu, więc odpowiada od razu
+    if (is_datagram_transport(rqstp->rq_xprt)) {
+        if (reject_large_datagram(rqstp, sched::estimate_flops(cpp_matrix.rows), request_id)) {
+            return NULL;
+        }
+        SolveOutcome outcome = run_parallel_solve(cpp_matrix, engine, request_id, ledger);
+        if (!outcome.error.empty()) {
+            svcerr_systemerr(rqstp->rq_xprt);
+            return NULL;
+        }
+        fill_solution(result, outcome.solution);
+        GAUS_PROBE3(reply__sent, request_id, result.values.values_len, true);
+        if (outcome.persist) {
+            outcome.persist();
+        }
+        return &result;
+    }
+
+    g_stats.begin_request();
+    xprt_unregister(rqstp->rq_xprt);
+    SVCXPRT *transp = rqstp->rq_xprt;
+    serve_solve([transp, request_id](const SolveOutcome &outcome) { send_outcome(transp, outcome, request_id); },
+                std::move(cpp_matrix), engine, request_id, tenant, ledger);
+    return NULL;
+}
+
+// Macierz z dekodera rpcgen (SOLVE_WITH_ENGINE, SOLVE_GAUSS przy --xdr-threads 0): wymiary, --max-n i wartości
+// sprawdzane przed kopią do CppMatrix, tak jak w dekoderze równoległym
+bool reject_invalid_matrix(struct svc_req *rqstp, const Matrix &matrix) {
+    const std::size_t rows = matrix.rows;
+    const std::size_t cols = matrix.cols;
+    if (rows == 0 || cols != rows + 1 || matrix.data.data_len != rows * cols) {
+        std::cout << "[server] Odrzucono macierz " << rows << "x" << cols << " (" << matrix.data.data_len
+                  << " wartości): wymagane wymiary n x (n+1)" << std::endl;
+        svcerr_decode(rqstp->rq_xprt);
+        return true;
+    }
+    if (g_max_n != 0 && rows > g_max_n) {
+        std::cout << "[server] Odrzucono macierz " << rows << "x" << cols << ": większa niż --max-n " << g_max_n
+                  << std::endl;
+        svcerr_decode(rqstp->rq_xprt);
+        return true;
+    }
+    const double *begin = matrix.data.data_val;
+    const double *end = begin + matrix.data.data_len;
+    const double *invalid = std::find_if(begin, end, [](double value) { return !std::isfinite(value); });
+    if (invalid != end) {
+        std::cout << "[server] Odrzucono macierz: wartość nieskończona lub NaN na pozycji " << invalid - begin
+                  << std::endl;
+        svcerr_decode(rqstp->rq_xprt);
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+Solution *solve_gauss_1_svc(Matrix *argp, struct svc_req *rqstp) {
+    if (reject_invalid_matrix(rqstp, *argp)) {
+        return NULL;
+    }
+    // Pamięć żądania: bufor XDR (xdr_array), kopia CppMatrix, przestrzeń mmap, workery, kopia weryfikacji
+    auto ledger = std::make_shared<memory::RequestLedger>();
+    memory::LedgerScope ledger_scope{ledger};
+    memory::ScopedCharge xdr_charge{static_cast<std::size_t>(argp->data.data_len) * sizeof(double)};
 
     // Konwersja Matrix RPC -> CppMatrix
     CppMatrix cpp_matrix;
     cpp_matrix.rows = argp->rows;
     cpp_matrix.cols = argp->cols;
     cpp_matrix.data.assign(argp->data.data_val, argp->data.data_val + argp->data.data_len);
+    return solve_gauss_decoded(std::move(cpp_matrix), Engine::automatic, ledger, rqstp);
+}
 
-    const auto parallel_start = std::chrono::steady_clock::now();
-    std::vector<double> parallel_solution = gaussian_parallel(cpp_matrix);
-    const auto parallel_stop = std::chrono::steady_clock::now();
-    const auto parallel_ms = std::chrono::duration_cast<std::chrono::milliseconds>(parallel_stop - parallel_start).count();
-    std::cout << "[server] gaussian_parallel zakończone w " << parallel_ms << " ms" << std::endl;
+Solution *solve_with_engine_1_svc(EngineMatrix *argp, struct svc_req *rqstp) {
+    if (argp->engine > kMaxEngine) {
+        std::cout << "[server] Nieznany silnik " << argp->engine << std::endl;
+        svcerr_decode(rqstp->rq_xprt);
+        return NULL;
+    }
+    if (reject_invalid_matrix(rqstp, argp->matrix)) {
+        return NULL;
+    }
+    auto ledger = std::make_shared<memory::RequestLedger>();
+    memory::LedgerScope ledger_scope{ledger};
+    memory::ScopedCharge xdr_charge{static_cast<std::size_t>(argp->matrix.data.data_len) * sizeof(double)};
+
+    CppMatrix cpp_matrix;
+    cpp_matrix.rows = argp->matrix.rows;
+    cpp_matrix.cols = argp->matrix.cols;
+    cpp_matrix.data.assign(argp->matrix.data.data_val, argp->matrix.data.data_val + argp->matrix.data.data_len);
+    return solve_gauss_decoded(std::move(cpp_matrix), static_cast<Engine>(argp->engine), ledger, rqstp);
+}
+
+// Dyspozytor rejestrowany w transportach: SOLVE_GAUSS dekoduje równolegle prosto do CppMatrix
+// (bez tablicy pośredniej xdr_array), pozostałe procedury obsługuje dyspozytor rpcgen
+void gauss_rpc_dispatch(struct svc_req *rqstp, SVCXPRT *transp) {
+    g_received_at = std::chrono::steady_clock::now();
+    GAUS_PROBE1(request__receive, rqstp->rq_proc);
+    if (rqstp->rq_proc != SOLVE_GAUSS || g_xdr_threads == 0) {
+        gauss_rpc_1(rqstp, transp);
+        return;
+    }
+
+    // Bufor macierzy należy do żądania od chwili dekodowania
+    auto ledger = std::make_shared<memory::RequestLedger>();
+    memory::LedgerScope ledger_scope{ledger};
+    wire::MatrixArgs args;
+    args.threads = g_xdr_threads;
+    args.max_rows = g_max_n;
+    const auto decode_start = std::chrono::steady_clock::now();
+    if (!svc_getargs(transp, (xdrproc_t)wire::xdr_matrix_parallel, (caddr_t)&args)) {
+        if (args.invalid) {
+            std::cout << "[server] Odrzucono macierz: wartość nieskończona lub NaN na pozycji " << args.invalid_index
+                      << std::endl;
+        } else if (args.misshapen) {
+            std::cout << "[server] Odrzucono macierz " << args.matrix.rows << "x" << args.matrix.cols
+                      << ": wymagane wymiary n x (n+1)" << std::endl;
+        } else if (args.too_large) {
+            std::cout << "[server] Odrzucono macierz " << args.matrix.rows << "x" << args.matrix.cols
+                      << ": większa niż --max-n " << g_max_n << " albo nie mieści się w pamięci" << std::endl;
+        }
+        svcerr_decode(transp);
+        return;
+    }
+    if (args.matrix.data.size() >= wire::kParallelDecodeMin) {
+        std::cout << "[server] Dekodowanie XDR " << memory::format_bytes(args.matrix.data.size() * sizeof(double))
+                  << " w "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                           decode_start)
+                         .count()
+                  << " ms (" << g_xdr_threads << " wątków)" << std::endl;
+    }
+
+    Solution *result = solve_gauss_decoded(std::move(args.matrix), Engine::automatic, ledger, rqstp);
+    if (result != NULL && !svc_sendreply(transp, (xdrproc_t)xdr_Solution, (char *)result)) {
+        svcerr_systemerr(transp);
+    }
+    svc_freeargs(transp, (xdrproc_t)wire::xdr_matrix_parallel, (caddr_t)&args);
+}
+
+Solution *solve_stencil_1_svc(Stencil *argp, struct svc_req *rqstp) {
+    static Solution result;
+
+    const std::uint64_t request_id = g_stats.next_id();
+    const std::string tenant = tenant_of(rqstp);
+    const mg::Stencil op{argp->nx, argp->ny, argp->nz, argp->center, argp->off_x, argp->off_y, argp->off_z};
+    std::size_t points = 0;
+    const bool counted = op.checked_points(points);
+    GAUS_PROBE5(decode__done, request_id, SOLVE_STENCIL, points, 1, micros_since(g_received_at));
+    std::cout << "[server] #" << request_id << " Otrzymano stencil " << argp->nx << "x" << argp->ny << "x" << argp->nz
+              << " (tenant " << tenant << ")" << std::endl;
+
+    // Iloczyn wymiarów z żądania może się przepełnić i przypadkiem zgodzić z długością prawej strony
+    if (!counted || (g_max_grid_points != 0 && points > g_max_grid_points)) {
+        std::cout << "[server] #" << request_id << " Siatka większa niż --max-grid-points " << g_max_grid_points
+                  << std::endl;
+        svcerr_decode(rqstp->rq_xprt);
+        return NULL;
+    }
+    if (points == 0 || argp->rhs.rhs_len != points) {
+        std::cout << "[server] #" << request_id << " Prawa strona ma " << argp->rhs.rhs_len << " wartości zamiast "
+                  << points << std::endl;
+        svcerr_decode(rqstp->rq_xprt);
+        return NULL;
+    }
+
+    auto ledger = std::make_shared<memory::RequestLedger>();
+    memory::LedgerScope ledger_scope{ledger};
+    memory::ScopedCharge xdr_charge{points * sizeof(double)};
+
+    StencilRequest request;
+    request.op = op;
+    if (argp->tolerance > 0.0) {
+        request.options.tolerance = argp->tolerance;
+    }
+    if (argp->max_cycles != 0) {
+        request.options.max_cycles = argp->max_cycles;
+    }
+    request.options.threads = std::max<std::size_t>(1, std::thread::hardware_concurrency() / g_compute->slots());
+    request.rhs.assign(argp->rhs.rhs_val, argp->rhs.rhs_val + points);
+
+    if (is_datagram_transport(rqstp->rq_xprt)) {
+        if (reject_large_datagram(rqstp, mg::estimate_flops(request.op.points()), request_id)) {
+            return NULL;
+        }
+        SolveOutcome outcome = run_stencil_solve(request, request_id, ledger);
+        if (!outcome.error.empty()) {
+            svcerr_systemerr(rqstp->rq_xprt);
+            return NULL;
+        }
+        fill_solution(result, outcome.solution);
+        GAUS_PROBE3(reply__sent, request_id, result.values.values_len, true);
+        return &result;
+    }
+
+    g_stats.begin_request();
+    xprt_unregister(rqstp->rq_xprt);
+    serve_stencil(rqstp->rq_xprt, std::move(request), request_id, tenant, ledger);
+    return NULL;
+}
+
+Solution *solve_block_tridiag_1_svc(BlockTridiag *argp, struct svc_req *rqstp) {
+    static Solution result;
+
+    const std::uint64_t request_id = g_stats.next_id();
+    const std::string tenant = tenant_of(rqstp);
+    GAUS_PROBE5(decode__done, request_id, SOLVE_BLOCK_TRIDIAG, static_cast<std::size_t>(argp->chains) * argp->blocks,
+                argp->b, micros_since(g_received_at));
+    std::cout << "[server] #" << request_id << " Otrzymano " << argp->chains << " łańcuchów po " << argp->blocks
+              << " bloków " << argp->b << "x" << argp->b << " (tenant " << tenant << ")" << std::endl;
+
+    const std::size_t chains = argp->chains;
+    const std::size_t blocks = argp->blocks;
+    const std::size_t b = argp->b;
+    // Wymiary pochodzą od klienta: przepełniony iloczyn mógłby zgodzić się z krótkimi tablicami
+    std::size_t area = 0;
+    std::size_t block_count = 0;
+    std::size_t unknowns = 0;
+    std::size_t diag_len = 0;
+    std::size_t links = 0;
+    const bool sized = !__builtin_mul_overflow(b, b, &area) && !__builtin_mul_overflow(chains, blocks, &block_count) &&
+                       !__builtin_mul_overflow(block_count, b, &unknowns) &&
+                       !__builtin_mul_overflow(block_count, area, &diag_len) &&
+                       (blocks == 0 || !__builtin_mul_overflow(chains * (blocks - 1), area, &links));
+    if (!sized || (g_max_block != 0 && b > g_max_block) ||
+        (g_max_block_unknowns != 0 && unknowns > g_max_block_unknowns)) {
+        std::cout << "[server] #" << request_id << " Układ większy niż --max-block " << g_max_block
+                  << " lub --max-block-unknowns " << g_max_block_unknowns << std::endl;
+        svcerr_decode(rqstp->rq_xprt);
+        return NULL;
+    }
+    if (chains == 0 || blocks == 0 || b == 0 || argp->method > 2 || argp->lower.lower_len != links ||
+        argp->upper.upper_len != links || argp->diag.diag_len != diag_len || argp->rhs.rhs_len != unknowns) {
+        std::cout << "[server] #" << request_id << " Niezgodne długości bloków łańcuchów" << std::endl;
+        svcerr_decode(rqstp->rq_xprt);
+        return NULL;
+    }
 
-    std::cout << "[server] Uruchamiam gaussian_sequential w tle do porównania" << std::endl;
-    std::thread([matrix_copy = cpp_matrix, parallel_solution]() {
+    auto ledger = std::make_shared<memory::RequestLedger>();
+    memory::LedgerScope ledger_scope{ledger};
+    memory::ScopedCharge xdr_charge{(2 * links + diag_len + unknowns) * sizeof(double)};
+
+    BlockTridiagRequest request;
+    request.chains = chains;
+    request.blocks = blocks;
+    request.b = b;
+    request.options.method = static_cast<btd::Method>(argp->method);
+    request.options.threads = std::max<std::size_t>(1, std::thread::hardware_concurrency() / g_compute->slots());
+    request.lower.assign(argp->lower.lower_val, argp->lower.lower_val + links);
+    request.diag.assign(argp->diag.diag_val, argp->diag.diag_val + argp->diag.diag_len);
+    request.upper.assign(argp->upper.upper_val, argp->upper.upper_val + links);
+    request.rhs.assign(argp->rhs.rhs_val, argp->rhs.rhs_val + argp->rhs.rhs_len);
+
+    if (is_datagram_transport(rqstp->rq_xprt)) {
+        if (reject_large_datagram(rqstp, btd::estimate_flops(chains, blocks, b), request_id)) {
+            return NULL;
+        }
+        SolveOutcome outcome = run_block_tridiag_solve(request, request_id, ledger);
+        if (!outcome.error.empty()) {
+            svcerr_systemerr(rqstp->rq_xprt);
+            return NULL;
+        }
+        fill_solution(result, outcome.solution);
+        GAUS_PROBE3(reply__sent, request_id, result.values.values_len, true);
+        return &result;
+    }
+
+    g_stats.begin_request();
+    xprt_unregister(rqstp->rq_xprt);
+    serve_block_tridiag(rqstp->rq_xprt, std::move(request), request_id, tenant, ledger);
+    return NULL;
+}
+
+SchurResult *schur_complement_1_svc(SchurRequest *argp, struct svc_req *rqstp) {
+    static SchurResult result;
+
+    const std::uint64_t request_id = g_stats.next_id();
+    const std::string tenant = tenant_of(rqstp);
+    const std::size_t n = argp->n;
+    const std::size_t m = argp->interface.interface_len;
+    GAUS_PROBE5(decode__done, request_id, SCHUR_COMPLEMENT, n, m, micros_since(g_received_at));
+    std::cout << "[server] #" << request_id << " Otrzymano macierz " << n << "x" << n << " do kondensacji na " << m
+              << " niewiadomych brzegowych (tenant " << tenant << ")" << std::endl;
+
+    if (n == 0 || m == 0 || m > n || argp->matrix.matrix_len != n * n || argp->rhs.rhs_len != n) {
+        std::cout << "[server] #" << request_id << " Niezgodne rozmiary macierzy, prawej strony lub brzegu"
+                  << std::endl;
+        svcerr_decode(rqstp->rq_xprt);
+        return NULL;
+    }
+
+    auto ledger = std::make_shared<memory::RequestLedger>();
+    memory::LedgerScope ledger_scope{ledger};
+    memory::ScopedCharge xdr_charge{(n * n + n) * sizeof(double)};
+
+    SchurJob job;
+    job.augmented.rows = n;
+    job.augmented.cols = n + 1;
+    job.augmented.data.resize(n * (n + 1));
+    for (std::size_t r = 0; r < n; ++r) {
+        std::copy_n(&argp->matrix.matrix_val[r * n], n, &job.augmented.data[r * (n + 1)]);
+        job.augmented.data[r * (n + 1) + n] = argp->rhs.rhs_val[r];
+    }
+    job.interface.assign(argp->interface.interface_val, argp->interface.interface_val + m);
+
+    if (is_datagram_transport(rqstp->rq_xprt)) {
+        if (reject_large_datagram(rqstp, schur::estimate_flops(n, m), request_id)) {
+            return NULL;
+        }
+        SchurOutcome outcome = run_schur(job, request_id, ledger);
+        if (!outcome.error.empty()) {
+            svcerr_systemerr(rqstp->rq_xprt);
+            return NULL;
+        }
+        fill_schur_result(result, outcome.result);
+        GAUS_PROBE3(reply__sent, request_id, result.complement.complement_len + result.rhs.rhs_len, true);
+        return &result;
+    }
+
+    g_stats.begin_request();
+    xprt_unregister(rqstp->rq_xprt);
+    serve_schur(rqstp->rq_xprt, std::move(job), request_id, tenant, ledger);
+    return NULL;
+}
+
+Solution *solve_nearby_1_svc(NearbyMatrix *argp, struct svc_req *rqstp) {
+    static Solution result;
+
+    const std::uint64_t request_id = g_stats.next_id();
+    const std::string tenant = tenant_of(rqstp);
+    const std::size_t rows = argp->matrix.rows;
+    const std::size_t cols = argp->matrix.cols;
+    GAUS_PROBE5(decode__done, request_id, SOLVE_NEARBY, rows, cols, micros_since(g_received_at));
+    std::cout << "[server] #" << request_id << " Otrzymano macierz " << rows << "x" << cols << " rodziny "
+              << argp->family << " (tenant " << tenant << ")" << std::endl;
+
+    if (rows == 0 || cols != rows + 1 || argp->matrix.data.data_len != rows * cols) {
+        std::cout << "[server] #" << request_id << " Macierz musi mieć wymiary n x (n+1)" << std::endl;
+        svcerr_decode(rqstp->rq_xprt);
+        return NULL;
+    }
+
+    if (reject_non_finite(rqstp, argp->matrix.data.data_val, argp->matrix.data.data_len, request_id)) {
+        return NULL;
+    }
+
+    auto ledger = std::make_shared<memory::RequestLedger>();
+    memory::LedgerScope ledger_scope{ledger};
+    memory::ScopedCharge xdr_charge{rows * cols * sizeof(double)};
+
+    CppMatrix cpp_matrix;
+    cpp_matrix.rows = rows;
+    cpp_matrix.cols = cols;
+    cpp_matrix.data.assign(argp->matrix.data.data_val, argp->matrix.data.data_val + argp->matrix.data.data_len);
+    // Baza Kryłowa rośnie z każdą iteracją (n liczb), więc klient nie może przekroczyć limitu serwera
+    const std::size_t max_iterations =
+        argp->max_iterations != 0 ? std::min<std::size_t>(argp->max_iterations, g_nearby_max_iterations)
+                                  : g_nearby_max_iterations;
+    auto family = g_nearby_families.acquire(tenant, argp->family);
+
+    if (is_datagram_transport(rqstp->rq_xprt)) {
+        if (reject_large_datagram(rqstp, estimate_nearby_flops(*family, rows, max_iterations), request_id)) {
+            return NULL;
+        }
+        SolveOutcome outcome = run_nearby_solve(family, cpp_matrix, max_iterations, request_id, ledger);
+        if (!outcome.error.empty()) {
+            svcerr_systemerr(rqstp->rq_xprt);
+            return NULL;
+        }
+        fill_solution(result, outcome.solution);
+        GAUS_PROBE3(reply__sent, request_id, result.values.values_len, true);
+        return &result;
+    }
+
+    g_stats.begin_request();
+    xprt_unregister(rqstp->rq_xprt);
+    serve_nearby(rqstp->rq_xprt, std::move(family), std::move(cpp_matrix), max_iterations, request_id, tenant,
+                 ledger);
+    return NULL;
+}
+
+Solution *solve_sparse_1_svc(SparseMatrix *argp, struct svc_req *rqstp) {
+    static Solution result;
+
+    const std::uint64_t request_id = g_stats.next_id();
+    const std::string tenant = tenant_of(rqstp);
+    const std::size_t n = argp->n;
+    const std::size_t nonzeros = argp->row_index.row_index_len;
+    GAUS_PROBE5(decode__done, request_id, SOLVE_SPARSE, n, nonzeros, micros_since(g_received_at));
+    std::cout << "[server] #" << request_id << " Otrzymano macierz rzadką " << n << "x" << n << " (" << nonzeros
+              << " niezerowych, tenant " << tenant << ")" << std::endl;
+    if (g_sparse_max_n != 0 && n > g_sparse_max_n) {
+        std::cout << "[server] #" << request_id << " Macierz rzadka większa niż --sparse-max-n " << g_sparse_max_n
+                  << std::endl;
+        svcerr_decode(rqstp->rq_xprt);
+        return NULL;
+    }
+
+    auto ledger = std::make_shared<memory::RequestLedger>();
+    memory::LedgerScope ledger_scope{ledger};
+    memory::ScopedCharge xdr_charge{(n + 1 + nonzeros) * sizeof(std::uint32_t) + (nonzeros + n) * sizeof(double)};
+
+    SparseRequest request;
+    request.pattern.n = n;
+    request.pattern.col_start.assign(argp->col_start.col_start_val,
+                                     argp->col_start.col_start_val + argp->col_start.col_start_len);
+    request.pattern.row_index.assign(argp->row_index.row_index_val, argp->row_index.row_index_val + nonzeros);
+    try {
+        if (argp->values.values_len != nonzeros || argp->rhs.rhs_len != n) {
+            throw std::invalid_argument("Sparse matrix needs one value per row index and n right-hand side values");
+        }
+        sparse::validate(request.pattern);
+    } catch (const std::exception &ex) {
+        std::cout << "[server] #" << request_id << " Niepoprawna macierz rzadka: " << ex.what() << std::endl;
+        svcerr_decode(rqstp->rq_xprt);
+        return NULL;
+    }
+    if (reject_non_finite(rqstp, argp->values.values_val, nonzeros, request_id) ||
+        reject_non_finite(rqstp, argp->rhs.rhs_val, n, request_id)) {
+        return NULL;
+    }
+    request.values.assign(argp->values.values_val, argp->values.values_val + nonzeros);
+    request.rhs.assign(argp->rhs.rhs_val, argp->rhs.rhs_val + n);
+    request.key = sparse::hash_pattern(request.pattern);
+
+    if (is_datagram_transport(rqstp->rq_xprt)) {
+        if (reject_large_datagram(rqstp, estimate_sparse_flops(request), request_id)) {
+            return NULL;
+        }
+        SolveOutcome outcome = run_sparse_solve(request, request_id, ledger);
+        if (!outcome.error.empty()) {
+            svcerr_systemerr(rqstp->rq_xprt);
+            return NULL;
+        }
+        fill_solution(result, outcome.solution);
+        GAUS_PROBE3(reply__sent, request_id, result.values.values_len, true);
+        return &result;
+    }
+
+    g_stats.begin_request();
+    xprt_unregister(rqstp->rq_xprt);
+    serve_sparse(rqstp->rq_xprt, std::move(request), request_id, tenant, ledger);
+    return NULL;
+}
+
+u_quad_t *rls_open_1_svc(RlsOpen *argp, struct svc_req *rqstp) {
+    static u_quad_t result;
+
+    const std::string tenant = tenant_of(rqstp);
+    if ((g_rls_max_n != 0 && argp->n > g_rls_max_n) || (g_rls_max_window != 0 && argp->window > g_rls_max_window)) {
+        std::cout << "[server] RLS: sesja n=" << argp->n << " okno=" << argp->window
+                  << " przekracza --rls-max-n " << g_rls_max_n << " lub --rls-max-window " << g_rls_max_window
+                  << std::endl;
+        result = 0;
+        return &result;
+    }
+    try {
+        result = g_rls_sessions.open(argp->n, argp->window, tenant);
+    } catch (const std::exception &ex) {
+        std::cout << "[server] RLS: nie można otworzyć sesji: " << ex.what() << std::endl;
+        result = 0;
+        return &result;
+    }
+    std::cout << "[server] RLS: nowa sesja n=" << argp->n << " okno=" << argp->window << " (tenant " << tenant << ")"
+              << std::endl;
+    return &result;
+}
+
+Solution *rls_update_1_svc(RlsRows *argp, struct svc_req *rqstp) {
+    static Solution result;
+
+    const std::uint64_t request_id = g_stats.next_id();
+    const std::string tenant = tenant_of(rqstp);
+    GAUS_PROBE5(decode__done, request_id, RLS_UPDATE, argp->rows, argp->data.data_len, micros_since(g_received_at));
+    auto session = g_rls_sessions.find(argp->session, tenant);
+    if (!session) {
+        std::cout << "[server] #" << request_id << " RLS: nieznana sesja" << std::endl;
+        svcerr_systemerr(rqstp->rq_xprt);
+        return NULL;
+    }
+    const std::size_t width = session->state.unknowns() + 1;
+    if (static_cast<std::size_t>(argp->data.data_len) != static_cast<std::size_t>(argp->rows) * width) {
+        svcerr_decode(rqstp->rq_xprt);
+        return NULL;
+    }
+    // Jeden NaN w obrotach Givensa trwale psuje R i z sesji
+    if (reject_non_finite(rqstp, argp->data.data_val, argp->data.data_len, request_id)) {
+        return NULL;
+    }
+    std::vector<double> rows(argp->data.data_val, argp->data.data_val + argp->data.data_len);
+
+    if (is_datagram_transport(rqstp->rq_xprt)) {
+        if (reject_large_datagram(rqstp, estimate_rls_flops(*session, argp->rows), request_id)) {
+            return NULL;
+        }
+        SolveOutcome outcome = run_rls_update(session, rows, argp->rows, request_id);
+        if (!outcome.error.empty()) {
+            svcerr_systemerr(rqstp->rq_xprt);
+            return NULL;
+        }
+        fill_solution(result, outcome.solution);
+        GAUS_PROBE3(reply__sent, request_id, result.values.values_len, true);
+        return &result;
+    }
+
+    g_stats.begin_request();
+    xprt_unregister(rqstp->rq_xprt);
+    serve_rls_update(rqstp->rq_xprt, std::move(session), std::move(rows), argp->rows, request_id, tenant);
+    return NULL;
+}
+
+int *rls_close_1_svc(u_quad_t *argp, struct svc_req *rqstp) {
+    static int result;
+
+    result = g_rls_sessions.close(*argp, tenant_of(rqstp)) ? 1 : 0;
+    return &result;
+}
+
+Report *get_stats_1_svc(void *argp, struct svc_req *rqstp) {
+    static std::string report;
+    static char *result;
+
+    report = g_stats.report();
+    report += "compute_slots " + std::to_string(g_compute->slots()) + "\n";
+    report += "compute_busy " + std::to_string(g_compute->busy()) + "\n";
+    report += "compute_queued " + std::to_string(g_compute->queued()) + "\n";
+    report += "verification_queued " + std::to_string(g_verification->queued()) + "\n";
+    report += "verification_skipped " + std::to_string(g_verification_skipped.load()) + "\n";
+    report += g_scheduler->report();
+    report += g_rls_sessions.report();
+    report += g_nearby_families.report();
+    report += g_sparse_patterns.report();
+    report += lapack::kAvailable ? "lapack min_n=" + std::to_string(g_lapack_min_n) + "\n" : "lapack off\n";
+    if (g_rhs_batcher) {
+        const auto stats = g_rhs_batcher->stats();
+        report += "rhs_batches " + std::to_string(stats.batches) + " rhs=" + std::to_string(stats.members) +
+                  " widest=" + std::to_string(stats.widest) + "\n";
+    }
+    if (g_micro_batcher) {
+        const auto stats = g_micro_batcher->stats();
+        report += "micro_batches " + std::to_string(stats.batches) + " systems=" + std::to_string(stats.members) +
+                  " widest=" + std::to_string(stats.widest) + "\n";
+    }
+    if (g_factor_store) {
+        const auto stats = g_factor_store->stats();
+        report += "factor_store entries=" + std::to_string(stats.entries) + " mapped=" + std::to_string(stats.mapped) +
+                  " bytes=" + std::to_string(stats.bytes) + " hits=" + std::to_string(stats.hits) +
+                  " misses=" + std::to_string(stats.misses) + " writes=" + std::to_string(stats.writes) +
+                  " precision=" + (g_factor_store->precision() == store::Precision::single ? "single" : "double") +
+                  "\n";
+    }
+    if (g_result_cache) {
+        const auto stats = g_result_cache->stats();
+        report += "result_cache slots=" + std::to_string(stats.slots) + " max_n=" + std::to_string(stats.max_n) +
+                  " hits=" + std::to_string(stats.hits) + " misses=" + std::to_string(stats.misses) +
+                  " inserts=" + std::to_string(stats.inserts) + " rejected=" + std::to_string(stats.rejected) +
+                  "\n";
+    }
+    const memory::ProcessHealth health = memory::read_process_health(getpid());
+    report += "process pid=" + std::to_string(getpid()) + " rss_kb=" + std::to_string(health.rss_kb) +
+              " fds=" + std::to_string(health.fds) + " threads=" + std::to_string(health.threads) +
+              " children=" + std::to_string(health.children) + " zombies=" + std::to_string(health.zombies) + "\n";
+    result = const_cast<char *>(report.c_str());
+    return &result;
+}
+
+int main(int argc, char **argv) {
+    ServeConfig serve_config;
+    std::size_t processes = 1;
+    long result_cache_mb = -1;
+    std::size_t result_cache_max_n = 4096;
+    std::vector<std::pair<std::string, std::string>> grid_options;
+    std::string factor_dir;
+    std::size_t factor_store_mb = 0;
+    store::Precision factor_precision = store::Precision::full;
+    std::size_t rhs_batch = 32;
+    long rhs_batch_us = 0;
+    long micro_batch_us = 0;
+    std::size_t micro_batch_max_n = 32;
+    std::size_t micro_batch_max = 256;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--slots" && i + 1 < argc) {
+            serve_config.compute_slots = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--processes" && i + 1 < argc) {
+            processes = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--port" && i + 1 < argc) {
+            serve_config.port = static_cast<std::uint16_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--lapack-min-n" && i + 1 < argc) {
+            g_lapack_min_n = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--native-port" && i + 1 < argc) {
+            serve_config.native_port = static_cast<std::uint16_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--result-cache-mb" && i + 1 < argc) {
+            result_cache_mb = std::strtol(argv[++i], nullptr, 10);
+        } else if (arg == "--rls-sessions" && i + 1 < argc) {
+            g_rls_sessions.set_limit(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--rls-max-n" && i + 1 < argc) {
+            g_rls_max_n = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--rls-max-window" && i + 1 < argc) {
+            g_rls_max_window = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--nearby-families" && i + 1 < argc) {
+            g_nearby_families.set_limit(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--sparse-patterns" && i + 1 < argc) {
+            g_sparse_patterns.set_limit(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--sparse-max-n" && i + 1 < argc) {
+            g_sparse_max_n = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--sparse-max-fill" && i + 1 < argc) {
+            g_sparse_max_fill = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--nearby-max-iters" && i + 1 < argc) {
+            g_nearby_max_iterations = std::max(1ul, std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--verify-queue" && i + 1 < argc) {
+            g_verification_limit = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--udp-max-mflop" && i + 1 < argc) {
+            g_datagram_max_flops = std::strtod(argv[++i], nullptr) * 1e6;
+        } else if (arg == "--max-n" && i + 1 < argc) {
+            g_max_n = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--max-grid-points" && i + 1 < argc) {
+            g_max_grid_points = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--max-block" && i + 1 < argc) {
+            g_max_block = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--max-block-unknowns" && i + 1 < argc) {
+            g_max_block_unknowns = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--xdr-threads" && i + 1 < argc) {
+            g_xdr_threads = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--result-cache-max-n" && i + 1 < argc) {
+            result_cache_max_n = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--grid" && i + 1 < argc) {
+            grid_options.push_back({arg, argv[++i]});
+        } else if ((arg == "--rank" || arg == "--peers" || arg == "--grid-block" || arg == "--grid-min-n") &&
+                   i + 1 < argc) {
+            grid_options.push_back({arg, argv[++i]});
+        } else if (arg == "--factor-dir" && i + 1 < argc) {
+            factor_dir = argv[++i];
+        } else if (arg == "--factor-store-mb" && i + 1 < argc) {
+            factor_store_mb = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--rhs-batch" && i + 1 < argc) {
+            rhs_batch = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--rhs-batch-us" && i + 1 < argc) {
+            rhs_batch_us = std::strtol(argv[++i], nullptr, 10);
+        } else if (arg == "--micro-batch-us" && i + 1 < argc) {
+            micro_batch_us = std::strtol(argv[++i], nullptr, 10);
+        } else if (arg == "--micro-batch-max-n" && i + 1 < argc) {
+            micro_batch_max_n = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--micro-batch-max" && i + 1 < argc) {
+            micro_batch_max = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--micro-batch-verify" && i + 1 < argc) {
+            g_micro_verify_every = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--factor-precision" && i + 1 < argc) {
+            const std::string value = argv[++i];
+            if (value != "single" && value != "double") {
+                print_usage(argv[0]);
+                return 1;
+            }
+            factor_precision = value == "single" ? store::Precision::single : store::Precision::full;
+        } else if (arg == "--factor-min-n" && i + 1 < argc) {
+            g_factor_min_n = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--tenant" && i + 1 < argc) {
+            try {
+                serve_config.tenant_policies.push_back(sched::parse_tenant_policy(argv[++i]));
+            } catch (const std::exception &ex) {
+                std::cerr << ex.what() << std::endl;
+                return 1;
+            }
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (serve_config.compute_slots == 0 || processes == 0 || result_cache_max_n == 0 ||
+        (processes > 1 && (serve_config.port == 0 || !grid_options.empty()))) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    if (!grid_options.empty()) {
         try {
-            const auto sequential_start = std::chrono::steady_clock::now();
-            auto sequential_solution = gaussian_sequential(matrix_copy);
-            const auto sequential_stop = std::chrono::steady_clock::now();
-            const auto sequential_ms = std::chrono::duration_cast<std::chrono::milliseconds>(sequential_stop - sequential_start).count();
-
-            bool solutions_match = parallel_solution.size() == sequential_solution.size();
-            double max_delta = 0.0;
-            constexpr double kTolerance = 1e-6;
-            if (solutions_match) {
-                for (std::size_t i = 0; i < parallel_solution.size(); ++i) {
-                    const double delta = std::fabs(parallel_solution[i] - sequential_solution[i]);
-                    max_delta = std::max(max_delta, delta);
-                    if (delta > kTolerance) {
-                        solutions_match = false;
-                        break;
-                    }
+            auto config = std::make_unique<GridConfig>();
+            bool has_shape = false;
+            for (const auto &[option, value] : grid_options) {
+                if (option == "--grid") {
+                    config->shape = grid::parse_grid_shape(value);
+                    has_shape = true;
+                } else if (option == "--rank") {
+                    config->rank = std::stoul(value);
+                } else if (option == "--peers") {
+                    config->peers = grid::parse_peers(value);
+                } else if (option == "--grid-block") {
+                    config->block = std::stoul(value);
+                } else if (option == "--grid-min-n") {
+                    config->min_n = std::stoul(value);
                 }
             }
-
-            if (solutions_match) {
-                std::cout << "[server] gaussian_sequential zakończone w " << sequential_ms
-                          << " ms; wyniki zgodne (max delta=" << max_delta << ")" << std::endl;
-            } else {
-                std::cout << "[server] gaussian_sequential zakończone w " << sequential_ms
-                          << " ms; UWAGA: Rozbieżne wyniki (max delta=" << max_delta << ")" << std::endl;
+            if (!has_shape || config->peers.size() != config->shape.size() || config->rank >= config->peers.size() ||
+                config->block == 0) {
+                throw std::invalid_argument("--grid needs --peers with exactly P*Q entries and a valid --rank");
             }
+            g_grid_config = std::move(config);
         } catch (const std::exception &ex) {
-            std::cout << "[server] gaussian_sequential błąd: " << ex.what() << std::endl;
+            std::cerr << ex.what() << std::endl;
+            print_usage(argv[0]);
+            return 1;
         }
-    }).detach();
+    }
 
-    // Konwersja Solution C++ -> Solution RPC
-    if (result.values.values_val != NULL) {
-        free(result.values.values_val);
+    // Zerwane połączenia (klienci, siatka) mają kończyć się błędem zapisu, a nie sygnałem
+    std::signal(SIGPIPE, SIG_IGN);
+
+    if (g_grid_config && g_grid_config->rank != 0) {
+        return run_grid_worker();
     }
-    result.values.values_len = parallel_solution.size();
-    result.values.values_val = (double *)malloc(parallel_solution.size() * sizeof(double));
-    std::copy(parallel_solution.begin(), parallel_solution.end(), result.values.values_val);
 
-    return &result;
-}
\ No newline at end of file
+    // Procesy serwera dzielą czynniki LU przez katalog; bez --factor-dir jest to tmpfs (pamięć współdzielona)
+    const bool shm_factor_dir = factor_dir.empty() && processes > 1;
+    if (shm_factor_dir) {
+        factor_dir = "/dev/shm/gaus-factors-" + std::to_string(getpid());
+    }
+    if (!factor_dir.empty()) {
+        try {
+            g_factor_store =
+                std::make_unique<store::FactorStore>(factor_dir, factor_store_mb * 1024 * 1024, factor_precision);
+            const auto stats = g_factor_store->stats();
+            std::cout << "[server] Magazyn czynników " << factor_dir << ": " << stats.entries << " plików ("
+                      << memory::format_bytes(stats.bytes) << ")" << std::endl;
+        } catch (const std::exception &ex) {
+            std::cerr << "Nie można otworzyć magazynu czynników: " << ex.what() << std::endl;
+            return 1;
+        }
+    }
+    if (g_factor_store && rhs_batch > 1) {
+        g_rhs_batcher = std::make_unique<batch::RhsBatcher>(rhs_batch,
+                                                            std::chrono::microseconds(std::max(0L, rhs_batch_us)));
+    }
+    if (micro_batch_us > 0) {
+        g_micro_batcher = std::make_unique<micro::MicroBatcher>(micro_batch_max_n, micro_batch_max,
+                                                                std::chrono::microseconds(micro_batch_us));
+    }
+
+    if (result_cache_mb < 0) {
+        result_cache_mb = processes > 1 ? 64 : 0;
+    }
+    if (result_cache_mb > 0) {
+        try {
+            g_result_cache = std::make_unique<store::SharedResultCache>(
+                static_cast<std::size_t>(result_cache_mb) * 1024 * 1024, result_cache_max_n);
+        } catch (const std::exception &ex) {
+            std::cerr << ex.what() << std::endl;
+            return 1;
+        }
+    }
+
+    if (processes == 1) {
+        return serve_requests(serve_config);
+    }
+
+    serve_config.register_portmap = false;
+    std::cout << "[server] Uruchamiam " << processes << " procesów na porcie " << serve_config.port << std::endl;
+    const int status = supervise_processes(processes, serve_config);
+    if (shm_factor_dir) {
+        std::error_code ignored;
+        std::filesystem::remove_all(factor_dir, ignored);
+    }
+    return status;
+}
@@ -0,0 +1,591 @@
+#include "gaus_rpc.h"
+#include "../include/matrix.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+// Test długotrwały (soak): mieszane obciążenie serwera przez wiele godzin, próbki przepustowości,
+// percentyli opóźnień oraz zasobów procesu serwera (z GET_STATS) i automatyczne wykrywanie dryfu i wycieków.
+
+namespace {
+
+constexpr double kMinTrendSeconds = 600.0;
+// Czas od zatrzymania klientów do próbki spoczynkowej: serwer kończy żądania w locie i zbiera procesy potomne
+constexpr double kDrainSeconds = 2.0;
+
+struct Options {
+    std::string host;
+    std::size_t clients{4};
+    double duration_s{3600.0};
+    double interval_s{10.0};
+    double warmup_s{-1.0}; // domyślnie 10% czasu trwania
+    std::vector<std::size_t> sizes{50, 200, 400};
+    unsigned int stencil_n{127};
+    unsigned int weight_gauss{70};
+    unsigned int weight_stencil{20};
+    unsigned int weight_repeat{10};
+    double rss_slope_mb_per_hour{16.0};
+    double throughput_drop{0.2};
+    double latency_growth{1.5};
+    std::string csv_path;
+};
+
+void print_usage(const char *prog) {
+    std::cerr << "Użycie: " << prog << " <host> [opcje]\n"
+              << "  --clients N        -> równoległe połączenia klientów (domyślnie 4)\n"
+              << "  --duration S       -> czas testu w sekundach (domyślnie 3600)\n"
+              << "  --interval S       -> okres próbkowania w sekundach (domyślnie 10)\n"
+              << "  --warmup S         -> rozgrzewka pomijana przy ocenie dryfu (domyślnie 10% czasu)\n"
+              << "  --sizes a,b,...    -> rozmiary losowych układów (domyślnie 50,200,400)\n"
+              << "  --stencil N        -> bok siatki żądań multigrid (domyślnie 127)\n"
+              << "  --mix g,s,r        -> wagi: losowe układy, stencil, powtórzony układ (domyślnie 70,20,10)\n"
+              << "  --rss-slope MB     -> dopuszczalny przyrost RSS w MiB/h (domyślnie 16)\n"
+              << "  --throughput-drop F -> dopuszczalny spadek przepustowości (domyślnie 0.2)\n"
+              << "  --latency-growth F -> dopuszczalny wzrost p99 (domyślnie 1.5x)\n"
+              << "  --csv PLIK         -> zapis próbek do pliku CSV\n"
+              << "Zmienna GAUS_TENANT ustawia nazwę tenanta, jak w gaus_client.\n"
+              << "Kod wyjścia: 0 - brak uwag, 1 - wykryto dryf lub wyciek, 2 - błędy RPC.\n";
+}
+
+std::vector<std::size_t> parse_sizes(const std::string &text) {
+    std::vector<std::size_t> sizes;
+    std::istringstream iss(text);
+    std::string item;
+    while (std::getline(iss, item, ',')) {
+        const std::size_t size = std::strtoul(item.c_str(), nullptr, 10);
+        if (size != 0) {
+            sizes.push_back(size);
+        }
+    }
+    return sizes;
+}
+
+bool parse_options(int argc, char **argv, Options &options) {
+    if (argc < 2) {
+        return false;
+    }
+    options.host = argv[1];
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const char *value = argv[++i];
+        if (arg == "--clients") {
+            options.clients = std::strtoul(value, nullptr, 10);
+        } else if (arg == "--duration") {
+            options.duration_s = std::strtod(value, nullptr);
+        } else if (arg == "--interval") {
+            options.interval_s = std::strtod(value, nullptr);
+        } else if (arg == "--warmup") {
+            options.warmup_s = std::strtod(value, nullptr);
+        } else if (arg == "--sizes") {
+            options.sizes = parse_sizes(value);
+        } else if (arg == "--stencil") {
+            options.stencil_n = static_cast<unsigned int>(std::strtoul(value, nullptr, 10));
+        } else if (arg == "--mix") {
+            if (std::sscanf(value, "%u,%u,%u", &options.weight_gauss, &options.weight_stencil,
+                            &options.weight_repeat) != 3) {
+                return false;
+            }
+        } else if (arg == "--rss-slope") {
+            options.rss_slope_mb_per_hour = std::strtod(value, nullptr);
+        } else if (arg == "--throughput-drop") {
+            options.throughput_drop = std::strtod(value, nullptr);
+        } else if (arg == "--latency-growth") {
+            options.latency_growth = std::strtod(value, nullptr);
+        } else if (arg == "--csv") {
+            options.csv_path = value;
+        } else {
+            return false;
+        }
+    }
+    if (options.warmup_s < 0.0) {
+        options.warmup_s = options.duration_s * 0.1;
+    }
+    return options.clients != 0 && options.duration_s > 0.0 && options.interval_s > 0.0 && !options.sizes.empty() &&
+           options.weight_gauss + options.weight_stencil + options.weight_repeat != 0;
+}
+
+CLIENT *open_client(const std::string &host) {
+    CLIENT *clnt = clnt_create(const_cast<char *>(host.c_str()), GAUSS_RPC, GAUSS_V, const_cast<char *>("tcp"));
+    if (clnt == NULL) {
+        return NULL;
+    }
+    const char *tenant = std::getenv("GAUS_TENANT");
+    if (tenant != nullptr && tenant[0] != '\0') {
+        AUTH *auth = authunix_create(const_cast<char *>(tenant), getuid(), getgid(), 0, NULL);
+        if (auth != NULL) {
+            auth_destroy(clnt->cl_auth);
+            clnt->cl_auth = auth;
+        }
+    }
+    timeval timeout{};
+    timeout.tv_sec = 300;
+    clnt_control(clnt, CLSET_TIMEOUT, reinterpret_cast<char *>(&timeout));
+    return clnt;
+}
+
+// Wyniki zbierane przez wątki klientów i opróżniane co okres próbkowania
+class Collector {
+public:
+    void record(double latency_ms, bool ok) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (ok) {
+            latencies_.push_back(latency_ms);
+        } else {
+            ++errors_;
+        }
+    }
+
+    void take(std::vector<double> &latencies, std::size_t &errors) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        latencies.swap(latencies_);
+        latencies_.clear();
+        errors = errors_;
+        errors_ = 0;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<double> latencies_;
+    std::size_t errors_{0};
+};
+
+// Residuum względne ||Ax - b|| / (||A|| ||x|| + ||b||) w normie maksimum; losowe układy bywają źle uwarunkowane
+double relative_residual(const CppMatrix &m, const Solution &solution) {
+    if (solution.values.values_len != m.rows) {
+        return INFINITY;
+    }
+    double worst = 0.0;
+    double norm_a = 0.0;
+    double norm_b = 0.0;
+    double norm_x = 0.0;
+    for (std::size_t r = 0; r < m.rows; ++r) {
+        double sum = -m(r, m.cols - 1);
+        double row_norm = 0.0;
+        for (std::size_t c = 0; c + 1 < m.cols; ++c) {
+            sum += m(r, c) * solution.values.values_val[c];
+            row_norm += std::fabs(m(r, c));
+        }
+        worst = std::max(worst, std::fabs(sum));
+        norm_a = std::max(norm_a, row_norm);
+        norm_b = std::max(norm_b, std::fabs(m(r, m.cols - 1)));
+        norm_x = std::max(norm_x, std::fabs(solution.values.values_val[r]));
+    }
+    return worst / (norm_a * norm_x + norm_b);
+}
+
+// Losowy układ diagonalnie dominujący: domyślny silnik nie wybiera elementu głównego, więc czysto losowe
+// macierze potrafią dać duże residuum bez błędu serwera i test raportowałby fałszywe awarie
+CppMatrix make_dominant_matrix(std::size_t n) {
+    CppMatrix m = make_random_matrix(n, n + 1);
+    for (std::size_t r = 0; r < n; ++r) {
+        double row_norm = 0.0;
+        for (std::size_t c = 0; c < n; ++c) {
+            row_norm += std::fabs(m(r, c));
+        }
+        m(r, r) = m(r, r) < 0.0 ? -row_norm : row_norm;
+    }
+    return m;
+}
+
+// Wywołanie z własnym buforem wyniku: pieniek rpcgen (solve_gauss_1 itd.) zwraca statyczny clnt_res wspólny
+// dla wszystkich wątków klientów, więc przy szybkich odpowiedziach wątki nadpisywały sobie wyniki
+bool call_solution(CLIENT *clnt, rpcproc_t procedure, xdrproc_t encode, void *argument, Solution &result) {
+    timeval timeout{};
+    timeout.tv_sec = 25;
+    result = Solution{};
+    return clnt_call(clnt, procedure, encode, reinterpret_cast<caddr_t>(argument),
+                     reinterpret_cast<xdrproc_t>(xdr_Solution), reinterpret_cast<caddr_t>(&result),
+                     timeout) == RPC_SUCCESS;
+}
+
+// Jedno żądanie z mieszanki; zwraca false przy błędzie RPC albo złym wyniku
+bool run_one(CLIENT *clnt, const Options &options, std::mt19937 &gen, const CppMatrix &repeated) {
+    const unsigned int total = options.weight_gauss + options.weight_stencil + options.weight_repeat;
+    const unsigned int pick = std::uniform_int_distribution<unsigned int>(0, total - 1)(gen);
+
+    if (pick >= options.weight_gauss && pick < options.weight_gauss + options.weight_stencil) {
+        const unsigned int n = options.stencil_n;
+        const double h = 1.0 / (n + 1);
+        std::vector<double> rhs(static_cast<std::size_t>(n) * n, 1.0);
+        Stencil stencil{};
+        stencil.nx = n;
+        stencil.ny = n;
+        stencil.nz = 1;
+        stencil.off_x = -1.0 / (h * h);
+        stencil.off_y = -1.0 / (h * h);
+        stencil.center = 4.0 / (h * h);
+        stencil.tolerance = 1e-8;
+        stencil.rhs.rhs_len = static_cast<u_int>(rhs.size());
+        stencil.rhs.rhs_val = rhs.data();
+        Solution reply;
+        if (!call_solution(clnt, SOLVE_STENCIL, reinterpret_cast<xdrproc_t>(xdr_Stencil), &stencil, reply)) {
+            std::cerr << clnt_sperror(clnt, const_cast<char *>("SOLVE_STENCIL")) << std::endl;
+            return false;
+        }
+        const bool ok = reply.values.values_len == rhs.size();
+        if (!ok) {
+            std::cerr << "SOLVE_STENCIL: zła liczba wartości " << reply.values.values_len << std::endl;
+        }
+        xdr_free(reinterpret_cast<xdrproc_t>(xdr_Solution), reinterpret_cast<char *>(&reply));
+        return ok;
+    }
+
+    CppMatrix generated;
+    const CppMatrix *matrix = &repeated;
+    if (pick < options.weight_gauss) {
+        const std::size_t n = options.sizes[std::uniform_int_distribution<std::size_t>(0, options.sizes.size() - 1)(gen)];
+        generated = make_dominant_matrix(n);
+        matrix = &generated;
+    }
+    Matrix rpc_matrix;
+    rpc_matrix.rows = static_cast<u_int>(matrix->rows);
+    rpc_matrix.cols = static_cast<u_int>(matrix->cols);
+    rpc_matrix.data.data_len = static_cast<u_int>(matrix->data.size());
+    rpc_matrix.data.data_val = const_cast<double *>(matrix->data.data());
+    Solution reply;
+    if (!call_solution(clnt, SOLVE_GAUSS, reinterpret_cast<xdrproc_t>(xdr_Matrix), &rpc_matrix, reply)) {
+        std::cerr << clnt_sperror(clnt, const_cast<char *>("SOLVE_GAUSS")) << std::endl;
+        return false;
+    }
+    const double residual = relative_residual(*matrix, reply);
+    const bool ok = residual < 1e-9;
+    if (!ok) {
+        std::cerr << "SOLVE_GAUSS " << matrix->rows << "x" << matrix->cols << ": residuum " << residual << std::endl;
+    }
+    xdr_free(reinterpret_cast<xdrproc_t>(xdr_Solution), reinterpret_cast<char *>(&reply));
+    return ok;
+}
+
+void client_loop(const Options &options, std::size_t index, const CppMatrix &repeated, Collector &collector,
+                 const std::atomic<bool> &stop) {
+    std::mt19937 gen(static_cast<unsigned int>(index * 7919 + 17));
+    CLIENT *clnt = NULL;
+    while (!stop.load()) {
+        if (clnt == NULL) {
+            clnt = open_client(options.host);
+            if (clnt == NULL) {
+                collector.record(0.0, false);
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+                continue;
+            }
+        }
+        const auto start = std::chrono::steady_clock::now();
+        const bool ok = run_one(clnt, options, gen, repeated);
+        const double latency_ms =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        collector.record(latency_ms, ok);
+        if (!ok) {
+            // Po błędzie transportu połączenie może być w nieznanym stanie
+            clnt_destroy(clnt);
+            clnt = NULL;
+        }
+    }
+    if (clnt != NULL) {
+        clnt_destroy(clnt);
+    }
+}
+
+struct ServerSample {
+    std::size_t rss_kb{};
+    std::size_t fds{};
+    std::size_t threads{};
+    std::size_t children{};
+    std::size_t zombies{};
+};
+
+// Linie "process pid=... rss_kb=..." z GET_STATS; w trybie --processes każde wywołanie trafia do innego procesu
+bool query_server(const std::string &host, int &pid, ServerSample &sample) {
+    CLIENT *clnt = open_client(host);
+    if (clnt == NULL) {
+        return false;
+    }
+    Report *report = get_stats_1(NULL, clnt);
+    bool found = false;
+    if (report != NULL) {
+        std::istringstream lines(*report);
+        std::string line;
+        while (std::getline(lines, line)) {
+            if (line.rfind("process ", 0) == 0) {
+                found = std::sscanf(line.c_str(), "process pid=%d rss_kb=%zu fds=%zu threads=%zu children=%zu zombies=%zu",
+                                    &pid, &sample.rss_kb, &sample.fds, &sample.threads, &sample.children,
+                                    &sample.zombies) == 6;
+            }
+        }
+        xdr_free(reinterpret_cast<xdrproc_t>(xdr_Report), reinterpret_cast<char *>(report));
+    }
+    clnt_destroy(clnt);
+    return found;
+}
+
+struct Interval {
+    double t_s;
+    double throughput;
+    double p50;
+    double p95;
+    double p99;
+    std::size_t errors;
+};
+
+double percentile(std::vector<double> &values, double q) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    const std::size_t index = std::min(values.size() - 1, static_cast<std::size_t>(q * (values.size() - 1) + 0.5));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+// Nachylenie prostej najmniejszych kwadratów y(t)
+double slope(const std::vector<std::pair<double, double>> &points) {
+    if (points.size() < 3) {
+        return 0.0;
+    }
+    double mean_t = 0.0;
+    double mean_y = 0.0;
+    for (const auto &[t, y] : points) {
+        mean_t += t;
+        mean_y += y;
+    }
+    mean_t /= points.size();
+    mean_y /= points.size();
+    double num = 0.0;
+    double den = 0.0;
+    for (const auto &[t, y] : points) {
+        num += (t - mean_t) * (y - mean_y);
+        den += (t - mean_t) * (t - mean_t);
+    }
+    return den > 0.0 ? num / den : 0.0;
+}
+
+double mean_of(const std::vector<Interval> &intervals, std::size_t begin, std::size_t end, double Interval::*field) {
+    double sum = 0.0;
+    for (std::size_t i = begin; i < end; ++i) {
+        sum += intervals[i].*field;
+    }
+    return end > begin ? sum / static_cast<double>(end - begin) : 0.0;
+}
+
+std::size_t median_of(const std::vector<ServerSample> &samples, std::size_t begin, std::size_t end,
+                      std::size_t ServerSample::*field) {
+    std::vector<std::size_t> values;
+    for (std::size_t i = begin; i < end; ++i) {
+        values.push_back(samples[i].*field);
+    }
+    if (values.empty()) {
+        return 0;
+    }
+    std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    return values[values.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::ofstream csv;
+    if (!options.csv_path.empty()) {
+        csv.open(options.csv_path);
+        csv << "t_s,throughput_rps,p50_ms,p95_ms,p99_ms,errors,pid,rss_kb,fds,threads,children,zombies\n";
+    }
+
+    const CppMatrix repeated = make_dominant_matrix(options.sizes.front());
+    Collector collector;
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> clients;
+    for (std::size_t i = 0; i < options.clients; ++i) {
+        clients.emplace_back(client_loop, std::cref(options), i, std::cref(repeated), std::ref(collector),
+                             std::cref(stop));
+    }
+
+    std::cout << "Soak: " << options.clients << " klientów, " << options.duration_s << " s, próbka co "
+              << options.interval_s << " s\n";
+    std::cout << std::setw(8) << "t[s]" << std::setw(10) << "req/s" << std::setw(10) << "p50[ms]" << std::setw(10)
+              << "p95[ms]" << std::setw(10) << "p99[ms]" << std::setw(10) << "błędy" << std::setw(8) << "pid"
+              << std::setw(10) << "RSS[KiB]" << std::setw(6) << "fd" << std::setw(7) << "wątki" << std::setw(8)
+              << "potomne" << std::setw(7) << "zombie" << "\n";
+
+    std::vector<Interval> intervals;
+    std::map<int, std::vector<std::pair<double, ServerSample>>> server_samples;
+    std::size_t total_requests = 0;
+    std::size_t total_errors = 0;
+    const auto begin = std::chrono::steady_clock::now();
+    auto next = begin;
+    for (;;) {
+        next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(options.interval_s));
+        std::this_thread::sleep_until(next);
+        const double t_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        std::vector<double> latencies;
+        std::size_t errors = 0;
+        collector.take(latencies, errors);
+        total_requests += latencies.size();
+        total_errors += errors;
+        Interval interval{t_s, static_cast<double>(latencies.size()) / options.interval_s, percentile(latencies, 0.5),
+                          percentile(latencies, 0.95), percentile(latencies, 0.99), errors};
+        intervals.push_back(interval);
+
+        int pid = 0;
+        ServerSample sample;
+        const bool have_sample = query_server(options.host, pid, sample);
+        if (have_sample) {
+            server_samples[pid].push_back({t_s, sample});
+        }
+
+        std::cout << std::fixed << std::setprecision(1) << std::setw(8) << t_s << std::setw(10) << interval.throughput
+                  << std::setw(10) << interval.p50 << std::setw(10) << interval.p95 << std::setw(10) << interval.p99
+                  << std::setw(8) << errors;
+        if (have_sample) {
+            std::cout << std::setw(8) << pid << std::setw(10) << sample.rss_kb << std::setw(6) << sample.fds
+                      << std::setw(6) << sample.threads << std::setw(8) << sample.children << std::setw(7)
+                      << sample.zombies;
+        } else {
+            std::cout << "  (brak statystyk serwera)";
+        }
+        std::cout << std::endl;
+        if (csv.is_open()) {
+            csv << t_s << ',' << interval.throughput << ',' << interval.p50 << ',' << interval.p95 << ','
+                << interval.p99 << ',' << errors << ',' << pid << ',' << sample.rss_kb << ',' << sample.fds << ','
+                << sample.threads << ',' << sample.children << ',' << sample.zombies << '\n';
+            csv.flush();
+        }
+
+        if (t_s >= options.duration_s) {
+            break;
+        }
+    }
+    stop.store(true);
+    for (auto &client : clients) {
+        client.join();
+    }
+
+    // Próbki spoczynkowe: bez klientów zombie i nadmiarowe zasoby nie są już skutkiem bieżącego obciążenia.
+    // W trybie --processes kolejne wywołania trafiają do różnych procesów, więc pytamy kilka razy.
+    std::this_thread::sleep_for(std::chrono::duration<double>(kDrainSeconds));
+    std::map<int, ServerSample> quiescent;
+    for (std::size_t attempt = 0; attempt < 2 * server_samples.size() + 2; ++attempt) {
+        int pid = 0;
+        ServerSample sample;
+        if (query_server(options.host, pid, sample)) {
+            quiescent[pid] = sample;
+        }
+    }
+
+    // Ocena: tylko próbki po rozgrzewce; porównanie pierwszej i ostatniej ćwiartki oraz trendy zasobów
+    std::vector<std::string> findings;
+    std::size_t first = 0;
+    while (first < intervals.size() && intervals[first].t_s <= options.warmup_s) {
+        ++first;
+    }
+    const std::size_t measured = intervals.size() - first;
+    if (measured >= 4) {
+        const std::size_t quarter = measured / 4;
+        const double early_tp = mean_of(intervals, first, first + quarter, &Interval::throughput);
+        const double late_tp = mean_of(intervals, intervals.size() - quarter, intervals.size(), &Interval::throughput);
+        if (early_tp > 0.0 && late_tp < early_tp * (1.0 - options.throughput_drop)) {
+            std::ostringstream oss;
+            oss << "przepustowość spadła z " << early_tp << " do " << late_tp << " req/s";
+            findings.push_back(oss.str());
+        }
+        const double early_p99 = mean_of(intervals, first, first + quarter, &Interval::p99);
+        const double late_p99 = mean_of(intervals, intervals.size() - quarter, intervals.size(), &Interval::p99);
+        if (early_p99 > 0.0 && late_p99 > early_p99 * options.latency_growth) {
+            std::ostringstream oss;
+            oss << "p99 opóźnienia wzrosło z " << early_p99 << " do " << late_p99 << " ms";
+            findings.push_back(oss.str());
+        }
+    } else {
+        std::cout << "(za mało próbek po rozgrzewce do oceny przepustowości i opóźnień - wydłuż --duration)\n";
+    }
+
+    for (const auto &[pid, samples] : server_samples) {
+        std::vector<std::pair<double, double>> rss;
+        std::vector<ServerSample> measured_samples;
+        for (const auto &[t_s, sample] : samples) {
+            if (t_s <= options.warmup_s) {
+                continue;
+            }
+            rss.push_back({t_s / 3600.0, static_cast<double>(sample.rss_kb) / 1024.0});
+            measured_samples.push_back(sample);
+        }
+        if (measured_samples.empty()) {
+            continue;
+        }
+        const std::string who = "proces " + std::to_string(pid) + ": ";
+        // Krótki przebieg to głównie nagrzewanie alokatora i pamięci podręcznych; trend RSS ma sens od kilku minut
+        const double span_s = rss.size() < 2 ? 0.0 : (rss.back().first - rss.front().first) * 3600.0;
+        const double rss_slope = slope(rss);
+        if (span_s < kMinTrendSeconds) {
+            std::cout << "(" << who << "trend RSS oceniany dopiero po " << kMinTrendSeconds
+                      << " s pomiaru po rozgrzewce)\n";
+        } else if (rss_slope > options.rss_slope_mb_per_hour) {
+            std::ostringstream oss;
+            oss << who << "RSS rośnie o " << rss_slope << " MiB/h (możliwy wyciek)";
+            findings.push_back(oss.str());
+        }
+        // Liczniki zasobów: mediany pierwszej i ostatniej ćwiartki, obie pod tym samym obciążeniem, jak przepustowość
+        if (measured_samples.size() >= 4) {
+            const std::size_t quarter = measured_samples.size() / 4;
+            const std::size_t late = measured_samples.size() - quarter;
+            const std::size_t slack = options.clients + 2;
+            const std::pair<const char *, std::size_t ServerSample::*> counters[] = {
+                {"deskryptory ", &ServerSample::fds},
+                {"wątki ", &ServerSample::threads},
+                {"procesy potomne ", &ServerSample::children}};
+            for (const auto &[label, field] : counters) {
+                const std::size_t early_value = median_of(measured_samples, 0, quarter, field);
+                const std::size_t late_value = median_of(measured_samples, late, measured_samples.size(), field);
+                if (late_value > early_value + slack) {
+                    findings.push_back(who + label + std::to_string(early_value) + " -> " +
+                                       std::to_string(late_value));
+                }
+            }
+        }
+        const auto rest = quiescent.find(pid);
+        if (rest == quiescent.end()) {
+            std::cout << "(" << who << "brak próbki po zatrzymaniu klientów)\n";
+        } else if (rest->second.zombies != 0) {
+            findings.push_back(who + std::to_string(rest->second.zombies) +
+                               " niezebranych procesów potomnych (zombie) po zatrzymaniu klientów");
+        }
+    }
+
+    std::cout << "\nŻądania: " << total_requests << ", błędy: " << total_errors << "\n";
+    if (findings.empty()) {
+        std::cout << "Brak oznak dryfu ani wycieków.\n";
+    } else {
+        std::cout << "UWAGA:\n";
+        for (const auto &finding : findings) {
+            std::cout << "  - " << finding << "\n";
+        }
+    }
+    if (total_errors != 0) {
+        return 2;
+    }
+    return findings.empty() ? 0 : 1;
+}
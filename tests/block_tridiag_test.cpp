@@ -0,0 +1,93 @@
+#include "../include/block_tridiag.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Redukcja cykliczna musi dawać to samo rozwiązanie co algorytm Thomasa: łańcuchy o długościach
+// niebędących potęgami dwójki, bloki z instancjami dla stałego rozmiaru i wariant z rozmiarem w czasie wykonania.
+
+namespace {
+
+struct Chains {
+    std::vector<double> lower;
+    std::vector<double> diag;
+    std::vector<double> upper;
+    std::vector<double> rhs;
+    btd::System system;
+};
+
+// Losowe łańcuchy z blokami diagonalnie dominującymi, żeby oba algorytmy były stabilne bez wyboru elementu głównego
+Chains make_chains(std::size_t chains, std::size_t blocks, std::size_t b, std::mt19937 &gen) {
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    const std::size_t bb = b * b;
+    Chains result;
+    result.lower.resize(chains * (blocks - 1) * bb);
+    result.upper.resize(chains * (blocks - 1) * bb);
+    result.diag.resize(chains * blocks * bb);
+    result.rhs.resize(chains * blocks * b);
+    for (auto *values : {&result.lower, &result.upper, &result.diag, &result.rhs}) {
+        for (double &value : *values) {
+            value = dist(gen);
+        }
+    }
+    for (std::size_t block = 0; block < chains * blocks; ++block) {
+        for (std::size_t i = 0; i < b; ++i) {
+            result.diag[block * bb + i * b + i] += 4.0 * static_cast<double>(b);
+        }
+    }
+    result.system = btd::System{chains,
+                                blocks,
+                                b,
+                                result.lower.data(),
+                                result.diag.data(),
+                                result.upper.data(),
+                                result.rhs.data()};
+    return result;
+}
+
+bool check(std::size_t chains, std::size_t blocks, std::size_t b, std::size_t threads, std::mt19937 &gen) {
+    const Chains input = make_chains(chains, blocks, b, gen);
+    btd::Options thomas;
+    thomas.method = btd::Method::thomas;
+    btd::Options cyclic;
+    cyclic.method = btd::Method::cyclic_reduction;
+    cyclic.threads = threads;
+    const btd::Result expected = btd::solve(input.system, thomas);
+    const btd::Result actual = btd::solve(input.system, cyclic);
+
+    double worst = 0.0;
+    double scale = 0.0;
+    for (std::size_t i = 0; i < expected.solution.size(); ++i) {
+        worst = std::max(worst, std::fabs(actual.solution[i] - expected.solution[i]));
+        scale = std::max(scale, std::fabs(expected.solution[i]));
+    }
+    const bool ok = actual.solution.size() == expected.solution.size() && worst <= 1e-12 * std::max(1.0, scale);
+    if (!ok) {
+        std::cerr << "BŁĄD: chains=" << chains << " blocks=" << blocks << " b=" << b << " threads=" << threads
+                  << " różnica " << worst << std::endl;
+    }
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 gen(2024);
+    std::size_t failures = 0;
+    std::size_t cases = 0;
+    for (std::size_t b : {1, 2, 3, 4, 7, 8}) {
+        for (std::size_t blocks : {2, 3, 4, 5, 7, 8, 9, 31, 64, 100}) {
+            for (std::size_t threads : {1, 4}) {
+                ++cases;
+                if (!check(2, blocks, b, threads, gen)) {
+                    ++failures;
+                }
+            }
+        }
+    }
+    std::cout << "block_tridiag: " << cases - failures << "/" << cases << " przypadków zgodnych" << std::endl;
+    return failures == 0 ? 0 : 1;
+}